@@ -1,6 +1,7 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "BRPlugins.h"
+#include "Editor/AnimModifier/AnimCurveNameCache.h"
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 #include "Interfaces/IPluginManager.h"
@@ -18,6 +19,9 @@ void FBRPluginsModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+
+	// The cache binds raw delegates on skeletons that can outlive the module
+	FAnimCurveNameCache::Get().Reset();
 }
 
 #undef LOCTEXT_NAMESPACE
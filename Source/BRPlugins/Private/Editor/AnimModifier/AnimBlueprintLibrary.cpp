@@ -1,6 +1,13 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+#include "Editor/AnimModifier/AnimCurveImporter.h"
+#include "Editor/AnimModifier/AnimCurveLUT.h"
+#include "Editor/AnimModifier/AnimCurveNameCache.h"
+#include "Editor/AnimModifier/AnimCurveReduction.h"
+#include "Editor/AnimModifier/AnimModifierBatchRunner.h"
+#include "Editor/AnimModifier/AnimPoseSampleCache.h"
+#include "Editor/AnimModifier/AnimRootMotionAnalysis.h"
 
 #include "Animation/AnimSequence.h"
 #include "Animation/AnimationAsset.h"
@@ -11,9 +18,304 @@
 #include "BonePose.h" 
 
 #include "AnimationRuntime.h"
+#include "Algo/IsSorted.h"
+#include "Algo/StableSort.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogAnimBlueprintLibrary, Verbose, All);
 
+namespace AnimBlueprintLibraryHelpers
+{
+	/** Nesting depth of FAnimCurveBatchScope */
+	static int32 NativeCurveBatchDepth = 0;
+
+	/** Nesting depth of BeginCurveBatch/EndCurveBatch, which a script can leave open by returning early */
+	static int32 ScriptCurveBatchDepth = 0;
+
+	/** GFrameCounter when the outermost script batch was opened */
+	static uint64 ScriptCurveBatchFrame = 0;
+
+	/** Sequences touched inside the current batch, baked once when the outermost batch closes */
+	static TSet<TWeakObjectPtr<UAnimSequence>> PendingBakeSequences;
+
+	static bool IsInCurveBatch()
+	{
+		return NativeCurveBatchDepth + ScriptCurveBatchDepth > 0;
+	}
+
+	static void OpenCurveBatch(int32& Depth)
+	{
+		++Depth;
+		FAnimPoseSampleCache::Get().BeginScope();
+	}
+
+	static void CloseCurveBatch(int32& Depth)
+	{
+		FAnimPoseSampleCache::Get().EndScope();
+		--Depth;
+
+		if (IsInCurveBatch())
+		{
+			return;
+		}
+
+		// Move out first, baking may run script that opens another batch
+		TSet<TWeakObjectPtr<UAnimSequence>> BakeSequences = MoveTemp(PendingBakeSequences);
+		PendingBakeSequences.Reset();
+
+		for (const TWeakObjectPtr<UAnimSequence>& WeakSequence : BakeSequences)
+		{
+			if (UAnimSequence* AnimationSequence = WeakSequence.Get())
+			{
+				AnimationSequence->BakeTrackCurvesToRawAnimation();
+			}
+		}
+	}
+
+	/** Closes script batches down to Depth, they were left open by a script that already returned */
+	static void CloseStaleScriptCurveBatches(int32 Depth, const TCHAR* Reason)
+	{
+		if (ScriptCurveBatchDepth <= Depth)
+		{
+			return;
+		}
+
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("%d BeginCurveBatch without a matching EndCurveBatch %s, closing them"), ScriptCurveBatchDepth - Depth, Reason);
+		while (ScriptCurveBatchDepth > Depth)
+		{
+			CloseCurveBatch(ScriptCurveBatchDepth);
+		}
+	}
+
+	/** Key indices ordered by time. Keys sharing a time keep their input order, so the last one wins like repeated UpdateOrAddKey calls */
+	static void SortKeyOrder(const TArray<float>& Times, TArray<int32>& OutOrder)
+	{
+		OutOrder.SetNumUninitialized(Times.Num());
+		for (int32 KeyIndex = 0; KeyIndex < Times.Num(); ++KeyIndex)
+		{
+			OutOrder[KeyIndex] = KeyIndex;
+		}
+
+		// Baked per-frame data is almost always sorted already
+		if (!Algo::IsSorted(Times))
+		{
+			Algo::StableSort(OutOrder, [&Times](const int32 A, const int32 B) { return Times[A] < Times[B]; });
+		}
+	}
+
+	/** Updates an existing key like UpdateOrAddKey followed by the mode assignment of the old per key loop, its tangents are kept */
+	static void UpdateKey(FRichCurveKey& Key, const FRichCurveKey& NewKey)
+	{
+		Key.Value = NewKey.Value;
+		Key.InterpMode = NewKey.InterpMode;
+		Key.TangentMode = NewKey.TangentMode;
+		Key.TangentWeightMode = NewKey.TangentWeightMode;
+	}
+
+	/**
+	 * Merges time sorted keys into the curve in a single linear pass.
+	 * A key within KINDA_SMALL_NUMBER of an existing key updates it through UpdateKey, keeping the existing time and tangents.
+	 */
+	static void MergeSortedKeys(FRichCurve& Curve, const TArray<FRichCurveKey>& SortedKeys)
+	{
+		const TArray<FRichCurveKey>& ExistingKeys = Curve.GetConstRefOfKeys();
+
+		TArray<FRichCurveKey> MergedKeys;
+		MergedKeys.Reserve(ExistingKeys.Num() + SortedKeys.Num());
+
+		int32 ExistingIndex = 0;
+		for (const FRichCurveKey& NewKey : SortedKeys)
+		{
+			while (ExistingIndex < ExistingKeys.Num() && ExistingKeys[ExistingIndex].Time < NewKey.Time - KINDA_SMALL_NUMBER)
+			{
+				MergedKeys.Add(ExistingKeys[ExistingIndex++]);
+			}
+
+			if (MergedKeys.Num() > 0 && FMath::IsNearlyEqual(MergedKeys.Last().Time, NewKey.Time, KINDA_SMALL_NUMBER))
+			{
+				UpdateKey(MergedKeys.Last(), NewKey);
+			}
+			else if (ExistingIndex < ExistingKeys.Num() && FMath::IsNearlyEqual(ExistingKeys[ExistingIndex].Time, NewKey.Time, KINDA_SMALL_NUMBER))
+			{
+				UpdateKey(MergedKeys.Add_GetRef(ExistingKeys[ExistingIndex++]), NewKey);
+			}
+			else
+			{
+				MergedKeys.Add(NewKey);
+			}
+		}
+
+		while (ExistingIndex < ExistingKeys.Num())
+		{
+			MergedKeys.Add(ExistingKeys[ExistingIndex++]);
+		}
+
+		Curve.SetKeys(MergedKeys);
+	}
+
+	/**
+	 * Replaces every existing key within the time range of the sorted keys by the keys themselves, tangents included.
+	 * Reduced keys only describe the signal together, a key left in between them would bend the segments they were fit to.
+	 */
+	static void ReplaceKeyRange(FRichCurve& Curve, const TArray<FRichCurveKey>& SortedKeys)
+	{
+		if (SortedKeys.Num() == 0)
+		{
+			return;
+		}
+
+		const float FirstTime = SortedKeys[0].Time - KINDA_SMALL_NUMBER;
+		const float LastTime = SortedKeys.Last().Time + KINDA_SMALL_NUMBER;
+		const TArray<FRichCurveKey>& ExistingKeys = Curve.GetConstRefOfKeys();
+
+		TArray<FRichCurveKey> MergedKeys;
+		MergedKeys.Reserve(ExistingKeys.Num() + SortedKeys.Num());
+
+		int32 ExistingIndex = 0;
+		while (ExistingIndex < ExistingKeys.Num() && ExistingKeys[ExistingIndex].Time < FirstTime)
+		{
+			MergedKeys.Add(ExistingKeys[ExistingIndex++]);
+		}
+		while (ExistingIndex < ExistingKeys.Num() && ExistingKeys[ExistingIndex].Time <= LastTime)
+		{
+			++ExistingIndex;
+		}
+
+		MergedKeys.Append(SortedKeys);
+
+		while (ExistingIndex < ExistingKeys.Num())
+		{
+			MergedKeys.Add(ExistingKeys[ExistingIndex++]);
+		}
+
+		Curve.SetKeys(MergedKeys);
+	}
+
+	/** Merges the time sorted keys into the curve, or reduces them and replaces the range they cover */
+	static void WriteSortedKeys(FRichCurve& Curve, TArray<FRichCurveKey>& SortedKeys, const FAnimCurveReductionSettings* Reduction, FAnimCurveReductionReport* OutReductionReport)
+	{
+		if (Reduction && Reduction->bEnabled)
+		{
+			FAnimCurveReductionReport ReductionReport;
+			AnimCurveReduction::ReduceKeys(SortedKeys, *Reduction, ReductionReport);
+			if (OutReductionReport)
+			{
+				OutReductionReport->Accumulate(ReductionReport);
+			}
+
+			ReplaceKeyRange(Curve, SortedKeys);
+		}
+		else
+		{
+			MergeSortedKeys(Curve, SortedKeys);
+		}
+	}
+
+	/** Largest number of rich curves behind one raw curve, the nine channels of a transform curve */
+	static const int32 MaxCurveComponents = 9;
+
+	/** The rich curves a raw curve stores its keys in, in the order GetKeyComponents decomposes a key */
+	static int32 GetRichCurves(FFloatCurve& Curve, FRichCurve** OutCurves)
+	{
+		OutCurves[0] = &Curve.FloatCurve;
+		return 1;
+	}
+
+	static int32 GetRichCurves(FVectorCurve& Curve, FRichCurve** OutCurves)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			OutCurves[Axis] = &Curve.FloatCurves[Axis];
+		}
+		return 3;
+	}
+
+	static int32 GetRichCurves(FTransformCurve& Curve, FRichCurve** OutCurves)
+	{
+		GetRichCurves(Curve.TranslationCurve, OutCurves);
+		GetRichCurves(Curve.RotationCurve, OutCurves + 3);
+		GetRichCurves(Curve.ScaleCurve, OutCurves + 6);
+		return 9;
+	}
+
+	static void GetKeyComponents(const float Value, float* OutComponents)
+	{
+		OutComponents[0] = Value;
+	}
+
+	static void GetKeyComponents(const FVector& Value, float* OutComponents)
+	{
+		OutComponents[0] = static_cast<float>(Value.X);
+		OutComponents[1] = static_cast<float>(Value.Y);
+		OutComponents[2] = static_cast<float>(Value.Z);
+	}
+
+	static void GetKeyComponents(const FTransform& Value, float* OutComponents)
+	{
+		GetKeyComponents(Value.GetTranslation(), OutComponents);
+
+		// Roll, pitch, yaw order, as in FTransformCurve::UpdateOrAddKey
+		const FRotator Rotator = Value.GetRotation().Rotator();
+		GetKeyComponents(FVector(Rotator.Roll, Rotator.Pitch, Rotator.Yaw), OutComponents + 3);
+
+		GetKeyComponents(Value.GetScale3D(), OutComponents + 6);
+	}
+}
+
+template <typename CurveClass>
+CurveClass* UAnimBlueprintLibrary::FindCurveForWrite(UAnimSequence* AnimationSequence, FName CurveName, ERawCurveTrackTypes CurveType)
+{
+	FName ContainerName;
+	FSmartName CurveSmartName;
+
+	if (FindCurveSmartName(AnimationSequence, CurveName, ContainerName, CurveSmartName))
+	{
+		// Retrieve the curve by name
+		return static_cast<CurveClass*>(AnimationSequence->RawCurveData.GetCurveData(CurveSmartName.UID, CurveType));
+	}
+	return nullptr;
+}
+
+template <typename CurveClass>
+const CurveClass* UAnimBlueprintLibrary::FindCurve(const UAnimSequence* AnimationSequence, FName CurveName, ERawCurveTrackTypes CurveType)
+{
+	FName ContainerName;
+	FSmartName CurveSmartName;
+
+	if (FindCurveSmartName(AnimationSequence, CurveName, ContainerName, CurveSmartName))
+	{
+		return static_cast<const CurveClass*>(AnimationSequence->RawCurveData.GetCurveData(CurveSmartName.UID, CurveType));
+	}
+	return nullptr;
+}
+
+void UAnimBlueprintLibrary::ConvertInterpMode(EInterpCurveMode InterpMode, ERichCurveInterpMode& OutInterpMode, ERichCurveTangentMode& OutTangentMode)
+{
+	OutInterpMode = RCIM_Linear;
+	OutTangentMode = RCTM_Auto;
+
+	if (InterpMode == CIM_Constant)
+	{
+		OutInterpMode = RCIM_Constant;
+	}
+	else if (InterpMode == CIM_Linear)
+	{
+		OutInterpMode = RCIM_Linear;
+	}
+	else
+	{
+		OutInterpMode = RCIM_Cubic;
+
+		if (InterpMode == CIM_CurveBreak)
+		{
+			OutTangentMode = RCTM_Break;
+		}
+		else if (InterpMode == CIM_CurveUser)
+		{
+			OutTangentMode = RCTM_User;
+		}
+	}
+}
+
 void UAnimBlueprintLibrary::AddFloatCurveKeyWithType(UAnimSequence* AnimationSequence, FName CurveName, const float Time, const float Value, EInterpCurveMode InterpMode)
 {
 	//UAnimationBlueprintLibrary::AddFloatCurveKey(AnimationSequence, CurveName, Time, Value);
@@ -54,66 +356,392 @@ void UAnimBlueprintLibrary::AddFloatCurveKeysWithType(UAnimSequence* AnimationSe
 
 }
 
+void UAnimBlueprintLibrary::AddVectorCurveKeysWithType(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<FVector>& Vectors, EInterpCurveMode InterpMode)
+{
+	if (AnimationSequence)
+	{
+		if (Times.Num() == Vectors.Num())
+		{
+			AddCurveKeysInternal<FVector, FVectorCurve>(AnimationSequence, CurveName, Times, Vectors, ERawCurveTrackTypes::RCT_Vector, InterpMode);
+		}
+		else
+		{
+			UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Number of Time values %i does not match the number of Vectors %i in AddVectorCurveKeysWithType"), Times.Num(), Vectors.Num());
+		}
+	}
+	else
+	{
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Invalid Animation Sequence for AddVectorCurveKeysWithType"));
+	}
+}
 
-template <typename DataType, typename CurveClass>
-void UAnimBlueprintLibrary::AddCurveKeysInternal(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<DataType>& KeyData, ERawCurveTrackTypes CurveType, EInterpCurveMode InterpMode)
+void UAnimBlueprintLibrary::AddTransformationCurveKeysWithType(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<FTransform>& Transforms, EInterpCurveMode InterpMode)
 {
-	checkf(Times.Num() == KeyData.Num(), TEXT("Not enough key data supplied"));
+	if (AnimationSequence)
+	{
+		if (Times.Num() == Transforms.Num())
+		{
+			AddCurveKeysInternal<FTransform, FTransformCurve>(AnimationSequence, CurveName, Times, Transforms, ERawCurveTrackTypes::RCT_Transform, InterpMode);
+		}
+		else
+		{
+			UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Number of Time values %i does not match the number of Transforms %i in AddTransformationCurveKeysWithType"), Times.Num(), Transforms.Num());
+		}
+	}
+	else
+	{
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Invalid Animation Sequence for AddTransformationCurveKeysWithType"));
+	}
+}
+
+void UAnimBlueprintLibrary::AddFloatCurveKeysWithReduction(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<float>& Values, EInterpCurveMode InterpMode, const FAnimCurveReductionSettings& Reduction, FAnimCurveReductionReport& OutReport)
+{
+	OutReport = FAnimCurveReductionReport();
+
+	if (AnimationSequence)
+	{
+		if (Times.Num() == Values.Num())
+		{
+			AddCurveKeysInternal<float, FFloatCurve>(AnimationSequence, CurveName, Times, Values, ERawCurveTrackTypes::RCT_Float, InterpMode, &Reduction, &OutReport);
+		}
+		else
+		{
+			UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Number of Time values %i does not match the number of Values %i in AddFloatCurveKeysWithReduction"), Times.Num(), Values.Num());
+		}
+	}
+	else
+	{
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Invalid Animation Sequence for AddFloatCurveKeysWithReduction"));
+	}
+}
 
-	const FName ContainerName = RetrieveContainerNameForCurve(AnimationSequence, CurveName);
+void UAnimBlueprintLibrary::AddFloatCurvesKeysWithType(UAnimSequence* AnimationSequence, const TMap<FName, FAnimCurveKeys>& CurveKeys, EInterpCurveMode InterpMode)
+{
+	if (AnimationSequence)
+	{
+		FAnimCurveBatchScope BatchScope;
 
-	if (ContainerName != NAME_None)
+		for (const TPair<FName, FAnimCurveKeys>& CurvePair : CurveKeys)
+		{
+			AddFloatCurveKeysWithType(AnimationSequence, CurvePair.Key, CurvePair.Value.Times, CurvePair.Value.Values, InterpMode);
+		}
+	}
+	else
 	{
-		// Retrieve smart name for curve
-		const FSmartName CurveSmartName = RetrieveSmartNameForCurve(AnimationSequence, CurveName, ContainerName);
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Invalid Animation Sequence for AddFloatCurvesKeys"));
+	}
+}
 
-		// Retrieve the curve by name
-		CurveClass* Curve = static_cast<CurveClass*>(AnimationSequence->RawCurveData.GetCurveData(CurveSmartName.UID, CurveType));
-		if (Curve)
+void UAnimBlueprintLibrary::ApplyAnimationModifiers(const TArray<UAnimSequence*>& AnimationSequences, const TArray<TSubclassOf<UAnimationModifier>>& ModifierClasses, bool bRunInParallel, FAnimModifierBatchReport& OutReport)
+{
+	FAnimModifierBatchRunner::Run(AnimationSequences, ModifierClasses, bRunInParallel, OutReport);
+
+	UE_LOG(LogAnimBlueprintLibrary, Log, TEXT("Applied %i parallel and %i serial modifiers to %i sequences in %.2fs%s"),
+		OutReport.NumParallelModifiers, OutReport.NumSerialModifiers, AnimationSequences.Num(), OutReport.TotalSeconds, OutReport.bCancelled ? TEXT(" (cancelled)") : TEXT(""));
+}
+
+void UAnimBlueprintLibrary::AddRootMotionDirectionCurves(UAnimSequence* AnimationSequence, const FRootMotionDirectionSettings& Settings)
+{
+	FAnimModifierCurveOutput CurveOutput;
+	if (AnimRootMotionAnalysis::Analyze(AnimationSequence, Settings, CurveOutput))
+	{
+		ApplyCurveOutput(AnimationSequence, CurveOutput);
+	}
+	else
+	{
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Invalid Animation Sequence for AddRootMotionDirectionCurves"));
+	}
+}
+
+void UAnimBlueprintLibrary::ApplyCurveOutput(UAnimSequence* AnimationSequence, const FAnimModifierCurveOutput& CurveOutput, FAnimCurveReductionReport* OutReductionReport)
+{
+	check(IsInGameThread());
+
+	if (!AnimationSequence)
+	{
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Invalid Animation Sequence for ApplyCurveOutput"));
+		return;
+	}
+
+	FAnimCurveBatchScope BatchScope;
+
+	for (const FAnimModifierCurveOutput::FCurve& Curve : CurveOutput.Curves)
+	{
+		PrepareFloatCurve(AnimationSequence, Curve.CurveName, CurveOutput.bReplaceExistingCurves);
+
+		if (CurveOutput.Reduction.bEnabled)
+		{
+			FAnimCurveReductionReport CurveReport;
+			AddFloatCurveKeysWithReduction(AnimationSequence, Curve.CurveName, Curve.Times, Curve.Values, Curve.InterpMode, CurveOutput.Reduction, CurveReport);
+			if (OutReductionReport)
+			{
+				OutReductionReport->Accumulate(CurveReport);
+			}
+		}
+		else
+		{
+			AddFloatCurveKeysWithType(AnimationSequence, Curve.CurveName, Curve.Times, Curve.Values, Curve.InterpMode);
+		}
+	}
+
+	for (const FName TrackName : CurveOutput.ReplaceNotifyTracks)
+	{
+		if (IsValidAnimNotifyTrackName(AnimationSequence, TrackName))
+		{
+			RemoveAnimationSyncMarkersByTrack(AnimationSequence, TrackName);
+			RemoveAnimationNotifyTrack(AnimationSequence, TrackName);
+		}
+	}
+
+	for (const FAnimModifierCurveOutput::FSyncMarker& SyncMarker : CurveOutput.SyncMarkers)
+	{
+		if (!IsValidAnimNotifyTrackName(AnimationSequence, SyncMarker.TrackName))
+		{
+			AddAnimationNotifyTrack(AnimationSequence, SyncMarker.TrackName);
+		}
+		AddAnimationSyncMarker(AnimationSequence, SyncMarker.MarkerName, SyncMarker.Time, SyncMarker.TrackName);
+	}
+
+	for (const FAnimModifierCurveOutput::FNotify& Notify : CurveOutput.Notifies)
+	{
+		if (!IsValidAnimNotifyTrackName(AnimationSequence, Notify.TrackName))
+		{
+			AddAnimationNotifyTrack(AnimationSequence, Notify.TrackName);
+		}
+		AddAnimationNotifyEvent(AnimationSequence, Notify.TrackName, Notify.Time, Notify.NotifyClass);
+	}
+}
+
+void UAnimBlueprintLibrary::PrepareFloatCurve(UAnimSequence* AnimationSequence, FName CurveName, bool bReplaceExisting)
+{
+	const bool bCurveExists = DoesCurveExist(AnimationSequence, CurveName, ERawCurveTrackTypes::RCT_Float);
+	if (bCurveExists && bReplaceExisting)
+	{
+		RemoveCurve(AnimationSequence, CurveName, false);
+	}
+
+	if (!bCurveExists || bReplaceExisting)
+	{
+		AddCurve(AnimationSequence, CurveName, ERawCurveTrackTypes::RCT_Float, false);
+	}
+}
+
+bool UAnimBlueprintLibrary::AddSortedFloatCurveKeys(UAnimSequence* AnimationSequence, FName CurveName, TArray<FRichCurveKey>& SortedKeys, const FAnimCurveReductionSettings* Reduction, FAnimCurveReductionReport* OutReductionReport)
+{
+	FFloatCurve* Curve = FindCurveForWrite<FFloatCurve>(AnimationSequence, CurveName, ERawCurveTrackTypes::RCT_Float);
+	if (!Curve)
+	{
+		return false;
+	}
+
+	AnimBlueprintLibraryHelpers::WriteSortedKeys(Curve->FloatCurve, SortedKeys, Reduction, OutReductionReport);
+	RequestBakeTrackCurves(AnimationSequence);
+	return true;
+}
+
+void UAnimBlueprintLibrary::ImportCurveKeysFromFiles(const TArray<FAnimCurveImportSource>& Sources, FAnimCurveImportReport& OutReport)
+{
+	FAnimCurveImporter::Import(Sources, OutReport);
+}
+
+void UAnimBlueprintLibrary::BakeFloatCurvesToLUT(UAnimSequence* AnimationSequence, const TArray<FName>& CurveNames, const FAnimCurveLUTSettings& Settings, FAnimCurveLUT& OutLUT, FAnimCurveLUTReport& OutReport)
+{
+	if (!AnimationSequence)
+	{
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Invalid Animation Sequence for BakeFloatCurvesToLUT"));
+		OutLUT = FAnimCurveLUT();
+		OutReport = FAnimCurveLUTReport();
+		return;
+	}
+
+	TArray<const FRichCurve*> Curves;
+	GatherFloatCurves(AnimationSequence, CurveNames, Curves);
+	OutLUT.Build(Curves, Settings, OutReport);
+}
+
+void UAnimBlueprintLibrary::EvaluateCurveLUT(const FAnimCurveLUT& LUT, float Time, TArray<float>& OutValues)
+{
+	if (!LUT.IsValid())
+	{
+		OutValues.SetNumZeroed(LUT.NumCurves);
+		return;
+	}
+
+	OutValues.SetNumUninitialized(LUT.Stride);
+	LUT.Evaluate(Time, OutValues.GetData());
+	OutValues.SetNum(LUT.NumCurves, false);
+}
+
+FAnimCurveLUTTiming UAnimBlueprintLibrary::MeasureCurveLUTEvaluation(UAnimSequence* AnimationSequence, const TArray<FName>& CurveNames, const FAnimCurveLUT& LUT, int32 NumEvaluations)
+{
+	if (!AnimationSequence)
+	{
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("Invalid Animation Sequence for MeasureCurveLUTEvaluation"));
+		return FAnimCurveLUTTiming();
+	}
+
+	TArray<const FRichCurve*> Curves;
+	GatherFloatCurves(AnimationSequence, CurveNames, Curves);
+	const FAnimCurveLUTTiming Timing = AnimCurveLUT::MeasureEvaluation(LUT, Curves, NumEvaluations);
+
+	UE_LOG(LogAnimBlueprintLibrary, Log, TEXT("Curve LUT: %.1f ns per curve, FRichCurve::Eval: %.1f ns per curve (%.1fx)"),
+		Timing.LUTNanosecondsPerCurve, Timing.RichCurveNanosecondsPerCurve, Timing.Speedup);
+	return Timing;
+}
+
+void UAnimBlueprintLibrary::BeginCurveBatch()
+{
+	check(IsInGameThread());
+	using namespace AnimBlueprintLibraryHelpers;
+
+	// Script calls do not span frames, a batch still open from an earlier one was abandoned
+	if (ScriptCurveBatchDepth > 0 && ScriptCurveBatchFrame != GFrameCounter)
+	{
+		CloseStaleScriptCurveBatches(0, TEXT("in an earlier frame"));
+	}
+
+	if (ScriptCurveBatchDepth == 0)
+	{
+		ScriptCurveBatchFrame = GFrameCounter;
+	}
+	OpenCurveBatch(ScriptCurveBatchDepth);
+}
+
+void UAnimBlueprintLibrary::EndCurveBatch()
+{
+	check(IsInGameThread());
+	using namespace AnimBlueprintLibraryHelpers;
+
+	if (ScriptCurveBatchDepth <= 0)
+	{
+		UE_LOG(LogAnimBlueprintLibrary, Warning, TEXT("EndCurveBatch called without a matching BeginCurveBatch"));
+		return;
+	}
+
+	CloseCurveBatch(ScriptCurveBatchDepth);
+}
+
+FAnimCurveBatchScope::FAnimCurveBatchScope()
+	: OuterScriptBatchDepth(AnimBlueprintLibraryHelpers::ScriptCurveBatchDepth)
+{
+	check(IsInGameThread());
+	AnimBlueprintLibraryHelpers::OpenCurveBatch(AnimBlueprintLibraryHelpers::NativeCurveBatchDepth);
+}
+
+FAnimCurveBatchScope::~FAnimCurveBatchScope()
+{
+	AnimBlueprintLibraryHelpers::CloseStaleScriptCurveBatches(OuterScriptBatchDepth, TEXT("inside a native curve batch, like a modifier run"));
+	AnimBlueprintLibraryHelpers::CloseCurveBatch(AnimBlueprintLibraryHelpers::NativeCurveBatchDepth);
+}
+
+FAnimCurveNameCacheStats UAnimBlueprintLibrary::GetCurveNameCacheStats()
+{
+	return FAnimCurveNameCache::Get().GetStats();
+}
+
+void UAnimBlueprintLibrary::ResetCurveNameCacheStats()
+{
+	FAnimCurveNameCache::Get().ResetStats();
+}
+
+FAnimPoseSampleCacheStats UAnimBlueprintLibrary::GetPoseSampleCacheStats()
+{
+	return FAnimPoseSampleCache::Get().GetStats();
+}
+
+void UAnimBlueprintLibrary::ResetPoseSampleCacheStats()
+{
+	FAnimPoseSampleCache::Get().ResetStats();
+}
+
+void UAnimBlueprintLibrary::SetPoseSampleCacheBudget(int32 BudgetMegaBytes)
+{
+	FAnimPoseSampleCache::Get().SetBudgetBytes(static_cast<int64>(BudgetMegaBytes) * 1024 * 1024);
+}
+
+void UAnimBlueprintLibrary::GatherFloatCurves(const UAnimSequence* AnimationSequence, const TArray<FName>& CurveNames, TArray<const FRichCurve*>& OutCurves)
+{
+	OutCurves.Reset(CurveNames.Num());
+	for (const FName& CurveName : CurveNames)
+	{
+		// Missing curves keep their slot and bake as zero
+		const FFloatCurve* Curve = FindCurve<FFloatCurve>(AnimationSequence, CurveName, ERawCurveTrackTypes::RCT_Float);
+		OutCurves.Add(Curve ? &Curve->FloatCurve : nullptr);
+	}
+}
+
+bool UAnimBlueprintLibrary::FindCurveSmartName(const UAnimSequence* AnimationSequence, FName CurveName, FName& OutContainerName, FSmartName& OutSmartName)
+{
+	return FAnimCurveNameCache::Get().FindOrResolve(AnimationSequence->GetSkeleton(), CurveName, OutContainerName, OutSmartName,
+		[AnimationSequence, CurveName](FName& ContainerName, FSmartName& SmartName)
 		{
-			const int32 NumKeys = KeyData.Num();
-			for (int32 KeyIndex = 0; KeyIndex < NumKeys; ++KeyIndex)
+			ContainerName = RetrieveContainerNameForCurve(AnimationSequence, CurveName);
+			if (ContainerName == NAME_None)
 			{
-				//Curve->UpdateOrAddKey(, );
-
-				FKeyHandle handle= Curve->FloatCurve.UpdateOrAddKey(Times[KeyIndex], KeyData[KeyIndex]);
-
-				FRichCurveKey& InKey = Curve->FloatCurve.GetKey(handle);
-
-				InKey.InterpMode = RCIM_Linear;
-				InKey.TangentWeightMode = RCTWM_WeightedNone;
-				InKey.TangentMode = RCTM_Auto;
-
-				if (InterpMode == CIM_Constant)
-				{
-					InKey.InterpMode = RCIM_Constant;
-				}
-				else if (InterpMode == CIM_Linear)
-				{
-					InKey.InterpMode = RCIM_Linear;
-				}
-				else
-				{
-					InKey.InterpMode = RCIM_Cubic;
-
-					if (InterpMode == CIM_CurveAuto || InterpMode == CIM_CurveAutoClamped)
-					{
-						InKey.TangentMode = RCTM_Auto;
-					}
-					else if (InterpMode == CIM_CurveBreak)
-					{
-						InKey.TangentMode = RCTM_Break;
-					}
-					else if (InterpMode == CIM_CurveUser)
-					{
-						InKey.TangentMode = RCTM_User;
-					}
-				}
+				return false;
+			}
 
+			SmartName = RetrieveSmartNameForCurve(AnimationSequence, CurveName, ContainerName);
+			return true;
+		});
+}
 
+void UAnimBlueprintLibrary::RequestBakeTrackCurves(UAnimSequence* AnimationSequence)
+{
+	if (AnimBlueprintLibraryHelpers::IsInCurveBatch())
+	{
+		AnimBlueprintLibraryHelpers::PendingBakeSequences.Add(AnimationSequence);
+	}
+	else
+	{
+		AnimationSequence->BakeTrackCurvesToRawAnimation();
+	}
+}
+
+template <typename DataType, typename CurveClass>
+void UAnimBlueprintLibrary::AddCurveKeysInternal(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<DataType>& KeyData, ERawCurveTrackTypes CurveType, EInterpCurveMode InterpMode,
+	const FAnimCurveReductionSettings* Reduction, FAnimCurveReductionReport* OutReductionReport)
+{
+	checkf(Times.Num() == KeyData.Num(), TEXT("Not enough key data supplied"));
+
+	if (CurveClass* Curve = FindCurveForWrite<CurveClass>(AnimationSequence, CurveName, CurveType))
+	{
+		ERichCurveInterpMode KeyInterpMode;
+		ERichCurveTangentMode KeyTangentMode;
+		ConvertInterpMode(InterpMode, KeyInterpMode, KeyTangentMode);
+
+		TArray<int32> KeyOrder;
+		AnimBlueprintLibraryHelpers::SortKeyOrder(Times, KeyOrder);
+
+		FRichCurve* RichCurves[AnimBlueprintLibraryHelpers::MaxCurveComponents];
+		const int32 NumComponents = AnimBlueprintLibraryHelpers::GetRichCurves(*Curve, RichCurves);
+
+		// Decompose every key once, each component curve then gets its whole batch merged in one pass
+		TArray<FRichCurveKey> ComponentKeys[AnimBlueprintLibraryHelpers::MaxCurveComponents];
+		for (int32 ComponentIndex = 0; ComponentIndex < NumComponents; ++ComponentIndex)
+		{
+			ComponentKeys[ComponentIndex].Reserve(KeyOrder.Num());
+		}
+
+		float Components[AnimBlueprintLibraryHelpers::MaxCurveComponents];
+		for (const int32 KeyIndex : KeyOrder)
+		{
+			AnimBlueprintLibraryHelpers::GetKeyComponents(KeyData[KeyIndex], Components);
+
+			for (int32 ComponentIndex = 0; ComponentIndex < NumComponents; ++ComponentIndex)
+			{
+				FRichCurveKey& NewKey = ComponentKeys[ComponentIndex].Emplace_GetRef(Times[KeyIndex], Components[ComponentIndex]);
+				NewKey.InterpMode = KeyInterpMode;
+				NewKey.TangentMode = KeyTangentMode;
+				NewKey.TangentWeightMode = RCTWM_WeightedNone;
 			}
+		}
 
-			AnimationSequence->BakeTrackCurvesToRawAnimation();
+		for (int32 ComponentIndex = 0; ComponentIndex < NumComponents; ++ComponentIndex)
+		{
+			AnimBlueprintLibraryHelpers::WriteSortedKeys(*RichCurves[ComponentIndex], ComponentKeys[ComponentIndex], Reduction, OutReductionReport);
 		}
+
+		RequestBakeTrackCurves(AnimationSequence);
 	}
-}
\ No newline at end of file
+}
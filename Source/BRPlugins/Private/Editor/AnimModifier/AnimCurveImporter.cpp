@@ -0,0 +1,482 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/AnimCurveImporter.h"
+#include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+
+#include "Algo/StableSort.h"
+#include "Animation/AnimSequence.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimCurveImporter, Log, All);
+
+namespace AnimCurveImporter
+{
+	/** Bytes mapped at a time. A window is only consumed up to its last complete row, the rest is mapped again with the next one */
+	static const int64 WindowSize = 64 * 1024 * 1024;
+
+	/** Keys of the rows parsed since the last flush. Flushed after every window, so only one window worth of keys is held */
+	struct FParseState
+	{
+		explicit FParseState(const FAnimCurveImportSource& InSource)
+			: Source(InSource)
+		{
+			UAnimBlueprintLibrary::ConvertInterpMode(Source.InterpMode, KeyInterpMode, KeyTangentMode);
+		}
+
+		const FAnimCurveImportSource& Source;
+		TArray<FName> CurveNames;
+		TArray<TArray<FRichCurveKey>> CurveKeys;
+		TBitArray<> CurveNeedsSort;
+		TBitArray<> CurvePrepared;
+		/** Last key time written to each curve, a reduced window replaces the keys in its range so it must start after it */
+		TArray<float> CurveLastTime;
+		bool bWarnedOverlap = false;
+		ERichCurveInterpMode KeyInterpMode = RCIM_Linear;
+		ERichCurveTangentMode KeyTangentMode = RCTM_Auto;
+		bool bHeaderDone = false;
+		int64 NumRows = 0;
+		double ApplySeconds = 0.0;
+		FAnimCurveReductionReport KeyReduction;
+		FString Error;
+
+		void InitCurves(const TArray<FName>& InCurveNames)
+		{
+			CurveNames = InCurveNames;
+			CurveKeys.SetNum(CurveNames.Num());
+			CurveNeedsSort.Init(false, CurveNames.Num());
+			CurvePrepared.Init(false, CurveNames.Num());
+			CurveLastTime.Init(TNumericLimits<float>::Lowest(), CurveNames.Num());
+			bHeaderDone = true;
+		}
+
+		/**
+		 * Merges the pending keys into the sequence's curves. Curves are prepared on their first flush only, later flushes merge
+		 * into what the earlier ones wrote, so unsorted files still end up sorted. Key reduction runs per flush and replaces the
+		 * time range of the window, a window reaching back into keys already written is merged unreduced instead.
+		 */
+		bool FlushKeys()
+		{
+			const double StartTime = FPlatformTime::Seconds();
+
+			for (int32 CurveIndex = 0; CurveIndex < CurveKeys.Num(); ++CurveIndex)
+			{
+				TArray<FRichCurveKey>& Keys = CurveKeys[CurveIndex];
+				const FName CurveName = CurveNames[CurveIndex];
+				if (Keys.Num() == 0 || CurveName == NAME_None)
+				{
+					continue;
+				}
+
+				if (CurveNeedsSort[CurveIndex])
+				{
+					Algo::StableSortBy(Keys, &FRichCurveKey::Time);
+					CurveNeedsSort[CurveIndex] = false;
+				}
+
+				if (!CurvePrepared[CurveIndex])
+				{
+					UAnimBlueprintLibrary::PrepareFloatCurve(Source.AnimationSequence, CurveName, Source.bReplaceExistingCurves);
+					CurvePrepared[CurveIndex] = true;
+				}
+
+				const bool bOverlaps = Keys[0].Time <= CurveLastTime[CurveIndex] + KINDA_SMALL_NUMBER;
+				if (bOverlaps && Source.KeyReduction.bEnabled && !bWarnedOverlap)
+				{
+					UE_LOG(LogAnimCurveImporter, Warning, TEXT("%s is not sorted by time across windows, overlapping rows are imported without key reduction"), *Source.FilePath);
+					bWarnedOverlap = true;
+				}
+				CurveLastTime[CurveIndex] = FMath::Max(CurveLastTime[CurveIndex], Keys.Last().Time);
+
+				FAnimCurveReductionReport CurveReport;
+				if (!UAnimBlueprintLibrary::AddSortedFloatCurveKeys(Source.AnimationSequence, CurveName, Keys, bOverlaps ? nullptr : &Source.KeyReduction, &CurveReport))
+				{
+					Error = FString::Printf(TEXT("curve %s could not be written"), *CurveName.ToString());
+					return false;
+				}
+				KeyReduction.Accumulate(CurveReport);
+
+				// Keeps the allocation for the next window
+				Keys.Reset();
+			}
+
+			ApplySeconds += FPlatformTime::Seconds() - StartTime;
+			return true;
+		}
+
+		FORCEINLINE void AddKey(int32 CurveIndex, float Time, float Value)
+		{
+			TArray<FRichCurveKey>& Keys = CurveKeys[CurveIndex];
+			if (Keys.Num() > 0 && Keys.Last().Time > Time)
+			{
+				CurveNeedsSort[CurveIndex] = true;
+			}
+
+			FRichCurveKey& Key = Keys.Emplace_GetRef(Time, Value);
+			Key.InterpMode = KeyInterpMode;
+			Key.TangentMode = KeyTangentMode;
+			Key.TangentWeightMode = RCTWM_WeightedNone;
+		}
+	};
+
+	static FORCEINLINE bool IsDigit(ANSICHAR Char)
+	{
+		return Char >= '0' && Char <= '9';
+	}
+
+	/** Parses a decimal float in [Cursor, End), the text does not need to be null terminated. Values out of float range are rejected */
+	static bool ParseFloat(const ANSICHAR*& Cursor, const ANSICHAR* End, float& OutValue)
+	{
+		const ANSICHAR* Pos = Cursor;
+		while (Pos < End && (*Pos == ' ' || *Pos == '\t'))
+		{
+			++Pos;
+		}
+
+		bool bNegative = false;
+		if (Pos < End && (*Pos == '-' || *Pos == '+'))
+		{
+			bNegative = *Pos == '-';
+			++Pos;
+		}
+
+		double Mantissa = 0.0;
+		int32 Exponent = 0;
+		bool bHasDigits = false;
+		for (; Pos < End && IsDigit(*Pos); ++Pos)
+		{
+			Mantissa = Mantissa * 10.0 + (*Pos - '0');
+			bHasDigits = true;
+		}
+		if (Pos < End && *Pos == '.')
+		{
+			for (++Pos; Pos < End && IsDigit(*Pos); ++Pos)
+			{
+				Mantissa = Mantissa * 10.0 + (*Pos - '0');
+				--Exponent;
+				bHasDigits = true;
+			}
+		}
+		if (!bHasDigits)
+		{
+			return false;
+		}
+
+		if (Pos < End && (*Pos == 'e' || *Pos == 'E'))
+		{
+			++Pos;
+			bool bNegativeExponent = false;
+			if (Pos < End && (*Pos == '-' || *Pos == '+'))
+			{
+				bNegativeExponent = *Pos == '-';
+				++Pos;
+			}
+
+			// Clamped so the sum below can not overflow, anything this large is out of range anyway
+			int32 ExponentValue = 0;
+			for (; Pos < End && IsDigit(*Pos); ++Pos)
+			{
+				ExponentValue = FMath::Min(ExponentValue * 10 + (*Pos - '0'), 1000);
+			}
+			Exponent += bNegativeExponent ? -ExponentValue : ExponentValue;
+		}
+
+		while (Pos < End && (*Pos == ' ' || *Pos == '\t'))
+		{
+			++Pos;
+		}
+
+		// A zero mantissa stays zero whatever the exponent, 0 * 10^999 would be NaN
+		const double Value = Exponent != 0 && Mantissa != 0.0 ? Mantissa * FMath::Pow(10.0, static_cast<double>(FMath::Clamp(Exponent, -1000, 1000))) : Mantissa;
+		const float FloatValue = static_cast<float>(bNegative ? -Value : Value);
+		if (!FMath::IsFinite(FloatValue))
+		{
+			return false;
+		}
+
+		OutValue = FloatValue;
+		Cursor = Pos;
+		return true;
+	}
+
+	static void ParseCsvHeader(const ANSICHAR* LineBegin, const ANSICHAR* LineEnd, const TArray<FName>& OverrideCurveNames, FParseState& State)
+	{
+		TArray<FName> HeaderNames;
+		const ANSICHAR* FieldBegin = LineBegin;
+		for (const ANSICHAR* Pos = LineBegin; Pos <= LineEnd; ++Pos)
+		{
+			if (Pos == LineEnd || *Pos == ',')
+			{
+				FString Field(static_cast<int32>(Pos - FieldBegin), FieldBegin);
+				Field.TrimStartAndEndInline();
+				Field.TrimQuotesInline();
+				HeaderNames.Add(FName(*Field));
+				FieldBegin = Pos + 1;
+			}
+		}
+
+		// The first column holds the times
+		if (HeaderNames.Num() > 0)
+		{
+			HeaderNames.RemoveAt(0);
+		}
+
+		State.InitCurves(OverrideCurveNames.Num() > 0 ? OverrideCurveNames : HeaderNames);
+	}
+
+	static void ParseCsvRow(const ANSICHAR* LineBegin, const ANSICHAR* LineEnd, FParseState& State)
+	{
+		const ANSICHAR* Pos = LineBegin;
+
+		float Time;
+		if (!ParseFloat(Pos, LineEnd, Time))
+		{
+			return;
+		}
+
+		for (int32 CurveIndex = 0; CurveIndex < State.CurveKeys.Num() && Pos < LineEnd; ++CurveIndex)
+		{
+			// Skip to the next field, empty fields add no key
+			while (Pos < LineEnd && *Pos != ',')
+			{
+				++Pos;
+			}
+			if (Pos == LineEnd)
+			{
+				break;
+			}
+			++Pos;
+
+			float Value;
+			if (ParseFloat(Pos, LineEnd, Value))
+			{
+				State.AddKey(CurveIndex, Time, Value);
+			}
+		}
+
+		++State.NumRows;
+	}
+
+	/** Parses the complete rows of a window, returns the number of bytes consumed */
+	static int64 ParseCsvWindow(const ANSICHAR* Begin, const ANSICHAR* End, bool bLastWindow, const TArray<FName>& OverrideCurveNames, FParseState& State)
+	{
+		const ANSICHAR* LineBegin = Begin;
+		while (LineBegin < End)
+		{
+			const ANSICHAR* LineEnd = LineBegin;
+			while (LineEnd < End && *LineEnd != '\n')
+			{
+				++LineEnd;
+			}
+
+			if (LineEnd == End && !bLastWindow)
+			{
+				break;
+			}
+
+			const ANSICHAR* NextLine = LineEnd < End ? LineEnd + 1 : End;
+			if (LineEnd > LineBegin && LineEnd[-1] == '\r')
+			{
+				--LineEnd;
+			}
+
+			if (LineEnd > LineBegin)
+			{
+				if (!State.bHeaderDone)
+				{
+					const ANSICHAR* Pos = LineBegin;
+					float FirstValue;
+					if (ParseFloat(Pos, LineEnd, FirstValue) && (Pos == LineEnd || *Pos == ','))
+					{
+						// No header row
+						State.InitCurves(OverrideCurveNames);
+						ParseCsvRow(LineBegin, LineEnd, State);
+					}
+					else
+					{
+						ParseCsvHeader(LineBegin, LineEnd, OverrideCurveNames, State);
+					}
+				}
+				else
+				{
+					ParseCsvRow(LineBegin, LineEnd, State);
+				}
+			}
+
+			LineBegin = NextLine;
+		}
+
+		return LineBegin - Begin;
+	}
+
+	/** Parses the complete rows of a window of a raw float file, returns the number of bytes consumed */
+	static int64 ParseRawWindow(const uint8* Begin, int64 NumBytes, FParseState& State)
+	{
+		const int32 NumCurves = State.CurveKeys.Num();
+		const int64 RowBytes = (NumCurves + 1) * sizeof(float);
+		const int64 NumWindowRows = NumBytes / RowBytes;
+
+		for (int64 Row = 0; Row < NumWindowRows; ++Row)
+		{
+			const uint8* RowData = Begin + Row * RowBytes;
+
+			float Time;
+			FMemory::Memcpy(&Time, RowData, sizeof(float));
+			if (!FMath::IsFinite(Time))
+			{
+				continue;
+			}
+
+			// Non-finite values add no key, like unparsable csv fields
+			for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+			{
+				float Value;
+				FMemory::Memcpy(&Value, RowData + (CurveIndex + 1) * sizeof(float), sizeof(float));
+				if (FMath::IsFinite(Value))
+				{
+					State.AddKey(CurveIndex, Time, Value);
+				}
+			}
+		}
+
+		State.NumRows += NumWindowRows;
+		return NumWindowRows * RowBytes;
+	}
+
+	static bool ParseFile(FParseState& State, int64& OutFileSize)
+	{
+		const FAnimCurveImportSource& Source = State.Source;
+
+		TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Source.FilePath));
+		if (!MappedFile)
+		{
+			State.Error = TEXT("could not be memory mapped");
+			return false;
+		}
+
+		const bool bRaw = Source.Format == EAnimCurveImportFormat::RawFloat32;
+		if (bRaw)
+		{
+			if (Source.CurveNames.Num() == 0)
+			{
+				State.Error = TEXT("raw files need curve names");
+				return false;
+			}
+			State.InitCurves(Source.CurveNames);
+		}
+
+		const int64 FileSize = MappedFile->GetFileSize();
+		const int64 RawRowBytes = (Source.CurveNames.Num() + 1) * sizeof(float);
+		OutFileSize = FileSize;
+
+		int64 Offset = 0;
+		int64 WindowBytes = bRaw ? FMath::Max<int64>(WindowSize / RawRowBytes, 1) * RawRowBytes : WindowSize;
+
+		while (Offset < FileSize)
+		{
+			const int64 BytesToMap = FMath::Min(WindowBytes, FileSize - Offset);
+			const bool bLastWindow = Offset + BytesToMap == FileSize;
+
+			TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(Offset, BytesToMap));
+			if (!Region)
+			{
+				State.Error = FString::Printf(TEXT("could not map %lld bytes at offset %lld"), BytesToMap, Offset);
+				return false;
+			}
+
+			const uint8* Begin = Region->GetMappedPtr();
+			int64 Consumed = 0;
+			if (bRaw)
+			{
+				Consumed = ParseRawWindow(Begin, BytesToMap, State);
+				if (bLastWindow && Consumed < BytesToMap)
+				{
+					UE_LOG(LogAnimCurveImporter, Warning, TEXT("%s ends with %lld bytes of a partial row"), *Source.FilePath, BytesToMap - Consumed);
+					break;
+				}
+			}
+			else
+			{
+				// Skip the UTF-8 byte order mark
+				int64 Skip = 0;
+				if (Offset == 0 && BytesToMap >= 3 && Begin[0] == 0xEF && Begin[1] == 0xBB && Begin[2] == 0xBF)
+				{
+					Skip = 3;
+				}
+
+				const ANSICHAR* Text = reinterpret_cast<const ANSICHAR*>(Begin);
+				Consumed = Skip + ParseCsvWindow(Text + Skip, Text + BytesToMap, bLastWindow, Source.CurveNames, State);
+
+				if (State.bHeaderDone && State.CurveKeys.Num() == 0)
+				{
+					State.Error = TEXT("no curve names in header or import source");
+					return false;
+				}
+			}
+
+			if (!State.FlushKeys())
+			{
+				return false;
+			}
+
+			if (Consumed == 0)
+			{
+				// A single row is longer than the window
+				WindowBytes *= 2;
+				continue;
+			}
+
+			Offset += Consumed;
+		}
+
+		return true;
+	}
+}
+
+void FAnimCurveImporter::Import(const TArray<FAnimCurveImportSource>& Sources, FAnimCurveImportReport& OutReport)
+{
+	check(IsInGameThread());
+
+	OutReport = FAnimCurveImportReport();
+
+	// Several files may feed the same sequence, bake each sequence once
+	FAnimCurveBatchScope BatchScope;
+
+	for (const FAnimCurveImportSource& Source : Sources)
+	{
+		if (!Source.AnimationSequence)
+		{
+			UE_LOG(LogAnimCurveImporter, Warning, TEXT("Invalid Animation Sequence for %s"), *Source.FilePath);
+			++OutReport.NumFilesFailed;
+			continue;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		AnimCurveImporter::FParseState State(Source);
+
+		int64 FileSize = 0;
+		const bool bParsed = AnimCurveImporter::ParseFile(State, FileSize);
+
+		// Keys are merged window by window while parsing
+		OutReport.ParseSeconds += static_cast<float>(FPlatformTime::Seconds() - StartTime - State.ApplySeconds);
+		OutReport.ApplySeconds += static_cast<float>(State.ApplySeconds);
+		OutReport.KeyReduction.Accumulate(State.KeyReduction);
+
+		if (!bParsed)
+		{
+			UE_LOG(LogAnimCurveImporter, Warning, TEXT("Failed to import %s: %s"), *Source.FilePath, *State.Error);
+			++OutReport.NumFilesFailed;
+			continue;
+		}
+
+		OutReport.NumBytes += FileSize;
+		OutReport.NumRows += State.NumRows;
+		++OutReport.NumFilesImported;
+	}
+
+	OutReport.ParseMegaBytesPerSecond = OutReport.ParseSeconds > 0.0f ? static_cast<float>(OutReport.NumBytes / (1024.0 * 1024.0) / OutReport.ParseSeconds) : 0.0f;
+
+	UE_LOG(LogAnimCurveImporter, Log, TEXT("Imported %i files, %lld rows, %.1f MB parsed at %.1f MB/s, %.2fs applying"),
+		OutReport.NumFilesImported, OutReport.NumRows, OutReport.NumBytes / (1024.0 * 1024.0), OutReport.ParseMegaBytesPerSecond, OutReport.ApplySeconds);
+}
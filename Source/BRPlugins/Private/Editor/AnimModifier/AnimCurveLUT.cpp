@@ -0,0 +1,249 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/AnimCurveLUT.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimCurveLUT, Log, All);
+
+int32 FAnimCurveLUT::GetAllocatedSize() const
+{
+	return Samples.GetAllocatedSize() + QuantizedSamples.GetAllocatedSize() + Scales.GetAllocatedSize() + Offsets.GetAllocatedSize();
+}
+
+void FAnimCurveLUT::Build(TArrayView<const FRichCurve* const> Curves, const FAnimCurveLUTSettings& Settings, FAnimCurveLUTReport& OutReport)
+{
+	OutReport = FAnimCurveLUTReport();
+	*this = FAnimCurveLUT();
+
+	if (Curves.Num() == 0)
+	{
+		return;
+	}
+
+	float MinTime = MAX_flt;
+	float MaxTime = -MAX_flt;
+	for (const FRichCurve* Curve : Curves)
+	{
+		if (Curve && Curve->GetNumKeys() > 0)
+		{
+			float CurveMinTime, CurveMaxTime;
+			Curve->GetTimeRange(CurveMinTime, CurveMaxTime);
+			MinTime = FMath::Min(MinTime, CurveMinTime);
+			MaxTime = FMath::Max(MaxTime, CurveMaxTime);
+		}
+	}
+	if (MinTime > MaxTime)
+	{
+		MinTime = MaxTime = 0.0f;
+	}
+
+	NumCurves = Curves.Num();
+	Stride = Align(NumCurves, 4);
+	StartTime = MinTime;
+
+	TArray<float> InterpolationErrors;
+	TArray<float> MidpointValues;
+	const float MaxSampleRate = FMath::Max(Settings.MaxSampleRate, 1.0f);
+	float SampleRate = FMath::Min(FMath::Max(Settings.SampleRate, 1.0f), MaxSampleRate);
+	for (;;)
+	{
+		NumSamples = FMath::Max(1, FMath::CeilToInt((MaxTime - MinTime) * SampleRate) + 1);
+		// Stretch the interval slightly so the last sample lands exactly on the last key
+		SampleInterval = NumSamples > 1 ? (MaxTime - MinTime) / (NumSamples - 1) : 0.0f;
+
+		Samples.SetNumZeroed(NumSamples * Stride);
+		InterpolationErrors.SetNumZeroed(NumCurves);
+
+		// Reference values halfway between samples, where linear interpolation is furthest from the curve
+		const int32 NumMidpoints = NumSamples - 1;
+		MidpointValues.SetNumZeroed(NumMidpoints * Stride);
+
+		float MaxInterpolationError = 0.0f;
+		for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+		{
+			const FRichCurve* Curve = Curves[CurveIndex];
+			if (!Curve)
+			{
+				continue;
+			}
+
+			for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+			{
+				Samples[SampleIndex * Stride + CurveIndex] = Curve->Eval(StartTime + SampleIndex * SampleInterval);
+			}
+
+			for (int32 SampleIndex = 0; SampleIndex < NumMidpoints; ++SampleIndex)
+			{
+				const float Value = Curve->Eval(StartTime + (SampleIndex + 0.5f) * SampleInterval);
+				const float Interpolated = 0.5f * (Samples[SampleIndex * Stride + CurveIndex] + Samples[(SampleIndex + 1) * Stride + CurveIndex]);
+				MidpointValues[SampleIndex * Stride + CurveIndex] = Value;
+				InterpolationErrors[CurveIndex] = FMath::Max(InterpolationErrors[CurveIndex], FMath::Abs(Value - Interpolated));
+			}
+			MaxInterpolationError = FMath::Max(MaxInterpolationError, InterpolationErrors[CurveIndex]);
+		}
+
+		if (MaxInterpolationError <= Settings.MaxError || SampleRate >= MaxSampleRate)
+		{
+			break;
+		}
+
+		// Linear interpolation error falls with the square of the interval, aim a little below the budget
+		SampleRate = FMath::Min(MaxSampleRate, SampleRate * FMath::Max(1.5f, 1.1f * FMath::Sqrt(MaxInterpolationError / Settings.MaxError)));
+	}
+	const int32 NumMidpoints = NumSamples - 1;
+
+	Scales.SetNumZeroed(Stride);
+	Offsets.SetNumZeroed(Stride);
+
+	// Quantize only when every curve stays in budget, rounding adds at most half a step
+	bool bQuantize = Settings.bAllowQuantization;
+	for (int32 CurveIndex = 0; CurveIndex < NumCurves && bQuantize; ++CurveIndex)
+	{
+		float MinValue = MAX_flt;
+		float MaxValue = -MAX_flt;
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			const float Value = Samples[SampleIndex * Stride + CurveIndex];
+			MinValue = FMath::Min(MinValue, Value);
+			MaxValue = FMath::Max(MaxValue, Value);
+		}
+
+		Offsets[CurveIndex] = MinValue;
+		Scales[CurveIndex] = (MaxValue - MinValue) / MAX_uint16;
+		bQuantize = InterpolationErrors[CurveIndex] + 0.5f * Scales[CurveIndex] <= Settings.MaxError;
+	}
+
+	if (bQuantize)
+	{
+		QuantizedSamples.SetNumZeroed(NumSamples * Stride);
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+			{
+				const float Scale = Scales[CurveIndex];
+				const float Normalized = Scale > 0.0f ? (Samples[SampleIndex * Stride + CurveIndex] - Offsets[CurveIndex]) / Scale : 0.0f;
+				QuantizedSamples[SampleIndex * Stride + CurveIndex] = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Normalized), 0, static_cast<int32>(MAX_uint16)));
+			}
+		}
+		Samples.Empty();
+	}
+	else
+	{
+		Scales.Empty();
+		Offsets.Empty();
+	}
+
+	// Measure through the evaluator itself so the report covers quantization too
+	TArray<float, TAlignedHeapAllocator<16>> Values;
+	Values.SetNumUninitialized(Stride);
+	for (int32 SampleIndex = 0; SampleIndex < NumMidpoints; ++SampleIndex)
+	{
+		Evaluate(StartTime + (SampleIndex + 0.5f) * SampleInterval, Values.GetData());
+		for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+		{
+			OutReport.MaxError = FMath::Max(OutReport.MaxError, FMath::Abs(Values[CurveIndex] - MidpointValues[SampleIndex * Stride + CurveIndex]));
+		}
+	}
+
+	if (OutReport.MaxError > Settings.MaxError)
+	{
+		UE_LOG(LogAnimCurveLUT, Warning, TEXT("Curve table misses MaxError %f by %f at the largest sample rate %.0f, raise MaxSampleRate"), Settings.MaxError, OutReport.MaxError, MaxSampleRate);
+	}
+
+	OutReport.NumSamples = NumSamples;
+	OutReport.SampleRate = SampleRate;
+	OutReport.bQuantized = bQuantize;
+	OutReport.NumBytes = GetAllocatedSize();
+}
+
+void FAnimCurveLUT::Evaluate(float Time, float* OutValues) const
+{
+	if (!IsValid())
+	{
+		FMemory::Memzero(OutValues, Stride * sizeof(float));
+		return;
+	}
+
+	const float Position = SampleInterval > 0.0f ? FMath::Clamp((Time - StartTime) / SampleInterval, 0.0f, static_cast<float>(NumSamples - 1)) : 0.0f;
+	const int32 SampleIndex = FMath::Min(FMath::FloorToInt(Position), FMath::Max(NumSamples - 2, 0));
+	const int32 NextOffset = NumSamples > 1 ? Stride : 0;
+	const VectorRegister4Float AlphaVec = VectorSetFloat1(Position - SampleIndex);
+
+	if (IsQuantized())
+	{
+		const uint16* Row = QuantizedSamples.GetData() + SampleIndex * Stride;
+		for (int32 CurveIndex = 0; CurveIndex < Stride; CurveIndex += 4)
+		{
+			const uint16* Quantized0 = Row + CurveIndex;
+			const uint16* Quantized1 = Quantized0 + NextOffset;
+			const VectorRegister4Float Value0 = MakeVectorRegisterFloat(static_cast<float>(Quantized0[0]), static_cast<float>(Quantized0[1]), static_cast<float>(Quantized0[2]), static_cast<float>(Quantized0[3]));
+			const VectorRegister4Float Value1 = MakeVectorRegisterFloat(static_cast<float>(Quantized1[0]), static_cast<float>(Quantized1[1]), static_cast<float>(Quantized1[2]), static_cast<float>(Quantized1[3]));
+			const VectorRegister4Float Interpolated = VectorMultiplyAdd(VectorSubtract(Value1, Value0), AlphaVec, Value0);
+			VectorStore(VectorMultiplyAdd(Interpolated, VectorLoad(Scales.GetData() + CurveIndex), VectorLoad(Offsets.GetData() + CurveIndex)), OutValues + CurveIndex);
+		}
+	}
+	else
+	{
+		const float* Row = Samples.GetData() + SampleIndex * Stride;
+		for (int32 CurveIndex = 0; CurveIndex < Stride; CurveIndex += 4)
+		{
+			const VectorRegister4Float Value0 = VectorLoad(Row + CurveIndex);
+			const VectorRegister4Float Value1 = VectorLoad(Row + CurveIndex + NextOffset);
+			VectorStore(VectorMultiplyAdd(VectorSubtract(Value1, Value0), AlphaVec, Value0), OutValues + CurveIndex);
+		}
+	}
+}
+
+namespace AnimCurveLUT
+{
+	FAnimCurveLUTTiming MeasureEvaluation(const FAnimCurveLUT& LUT, TArrayView<const FRichCurve* const> Curves, int32 NumEvaluations)
+	{
+		FAnimCurveLUTTiming Timing;
+		if (!LUT.IsValid() || Curves.Num() != LUT.NumCurves || NumEvaluations <= 0)
+		{
+			return Timing;
+		}
+
+		FRandomStream RandomStream(0x4C5554);
+		TArray<float> Times;
+		Times.SetNumUninitialized(NumEvaluations);
+		const float EndTime = LUT.StartTime + LUT.SampleInterval * (LUT.NumSamples - 1);
+		for (float& Time : Times)
+		{
+			Time = RandomStream.FRandRange(LUT.StartTime, EndTime);
+		}
+
+		// Summed into a volatile so neither loop can be optimized away
+		volatile float Sink = 0.0f;
+
+		const double RichCurveStartTime = FPlatformTime::Seconds();
+		float RichCurveSum = 0.0f;
+		for (const float Time : Times)
+		{
+			for (const FRichCurve* Curve : Curves)
+			{
+				RichCurveSum += Curve ? Curve->Eval(Time) : 0.0f;
+			}
+		}
+		const double RichCurveSeconds = FPlatformTime::Seconds() - RichCurveStartTime;
+		Sink = RichCurveSum;
+
+		TArray<float, TAlignedHeapAllocator<16>> Values;
+		Values.SetNumZeroed(LUT.Stride);
+
+		const double LUTStartTime = FPlatformTime::Seconds();
+		float LUTSum = 0.0f;
+		for (const float Time : Times)
+		{
+			LUT.Evaluate(Time, Values.GetData());
+			LUTSum += Values[0];
+		}
+		const double LUTSeconds = FPlatformTime::Seconds() - LUTStartTime;
+		Sink = LUTSum;
+
+		const double NumCurveEvaluations = static_cast<double>(NumEvaluations) * Curves.Num();
+		Timing.RichCurveNanosecondsPerCurve = static_cast<float>(RichCurveSeconds * 1.0e9 / NumCurveEvaluations);
+		Timing.LUTNanosecondsPerCurve = static_cast<float>(LUTSeconds * 1.0e9 / NumCurveEvaluations);
+		Timing.Speedup = LUTSeconds > 0.0 ? static_cast<float>(RichCurveSeconds / LUTSeconds) : 0.0f;
+		return Timing;
+	}
+}
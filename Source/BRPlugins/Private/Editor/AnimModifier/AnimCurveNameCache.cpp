@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/AnimCurveNameCache.h"
+
+#include "Animation/Skeleton.h"
+
+FAnimCurveNameCache& FAnimCurveNameCache::Get()
+{
+	static FAnimCurveNameCache Instance;
+	return Instance;
+}
+
+bool FAnimCurveNameCache::FindOrResolve(USkeleton* Skeleton, FName CurveName, FName& OutContainerName, FSmartName& OutSmartName, FResolveCurveName Resolve)
+{
+	check(IsInGameThread());
+
+	if (!Skeleton)
+	{
+		return Resolve(OutContainerName, OutSmartName);
+	}
+
+	const TWeakObjectPtr<USkeleton> SkeletonKey(Skeleton);
+	FSkeletonEntry* Entry = SkeletonEntries.Find(SkeletonKey);
+
+	if (Entry)
+	{
+		if (const FCachedCurveName* CachedName = Entry->Curves.Find(CurveName))
+		{
+			++Stats.Hits;
+			OutContainerName = CachedName->ContainerName;
+			OutSmartName = CachedName->SmartName;
+			return true;
+		}
+	}
+
+	++Stats.Misses;
+	if (!Resolve(OutContainerName, OutSmartName))
+	{
+		return false;
+	}
+
+	if (!Entry)
+	{
+		RemoveStaleEntries();
+
+		Entry = &SkeletonEntries.Add(SkeletonKey);
+		Entry->SmartNamesChangedHandle = Skeleton->RegisterOnSmartNamesChanged(USkeleton::FOnSmartNamesChanged::CreateRaw(this, &FAnimCurveNameCache::HandleSmartNamesChanged, SkeletonKey));
+	}
+
+	FCachedCurveName& CachedName = Entry->Curves.Add(CurveName);
+	CachedName.ContainerName = OutContainerName;
+	CachedName.SmartName = OutSmartName;
+	return true;
+}
+
+void FAnimCurveNameCache::Invalidate(const USkeleton* Skeleton)
+{
+	if (FSkeletonEntry* Entry = SkeletonEntries.Find(TWeakObjectPtr<USkeleton>(const_cast<USkeleton*>(Skeleton))))
+	{
+		++Stats.Invalidations;
+		Entry->Curves.Reset();
+	}
+}
+
+void FAnimCurveNameCache::Reset()
+{
+	for (TPair<TWeakObjectPtr<USkeleton>, FSkeletonEntry>& EntryPair : SkeletonEntries)
+	{
+		if (USkeleton* Skeleton = EntryPair.Key.Get())
+		{
+			Skeleton->UnregisterOnSmartNamesChanged(EntryPair.Value.SmartNamesChangedHandle);
+		}
+	}
+	SkeletonEntries.Reset();
+}
+
+void FAnimCurveNameCache::RemoveStaleEntries()
+{
+	// The delegates of a destroyed skeleton went with it, there is nothing to unregister
+	for (auto It = SkeletonEntries.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FAnimCurveNameCache::HandleSmartNamesChanged(TWeakObjectPtr<USkeleton> Skeleton)
+{
+	Invalidate(Skeleton.Get());
+}
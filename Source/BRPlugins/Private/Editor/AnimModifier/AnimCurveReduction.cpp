@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/AnimCurveReduction.h"
+
+#include "Algo/BinarySearch.h"
+
+namespace AnimCurveReduction
+{
+	struct FSegmentFit
+	{
+		bool bFits = false;
+		ERichCurveInterpMode InterpMode = RCIM_Linear;
+		float Error = 0.0f;
+	};
+
+	/**
+	 * Cheapest interp mode up to MaxInterpMode for a segment from key First to key Last that stays within MaxError at every key in between.
+	 * Constant segments of constant curves step at Last, otherwise the end key has to be within tolerance too so there is no step between keys
+	 */
+	static FSegmentFit FitSegment(const TArray<float>& Times, const TArray<float>& Values, const TArray<float>& Tangents, int32 First, int32 Last, ERichCurveInterpMode MaxInterpMode,
+		const FAnimCurveReductionSettings& Settings)
+	{
+		FSegmentFit Fit;
+
+		const int32 LastConstant = MaxInterpMode == RCIM_Constant ? Last - 1 : Last;
+		float ConstantError = 0.0f;
+		for (int32 Index = First + 1; Index <= LastConstant && ConstantError <= Settings.MaxError; ++Index)
+		{
+			ConstantError = FMath::Max(ConstantError, FMath::Abs(Values[Index] - Values[First]));
+		}
+		if (ConstantError <= Settings.MaxError)
+		{
+			Fit.bFits = true;
+			Fit.InterpMode = RCIM_Constant;
+			Fit.Error = ConstantError;
+			return Fit;
+		}
+
+		if (MaxInterpMode == RCIM_Constant)
+		{
+			return Fit;
+		}
+
+		const float Duration = Times[Last] - Times[First];
+		const float Delta = Values[Last] - Values[First];
+
+		float LinearError = 0.0f;
+		for (int32 Index = First + 1; Index < Last && LinearError <= Settings.MaxError; ++Index)
+		{
+			const float Alpha = (Times[Index] - Times[First]) / Duration;
+			LinearError = FMath::Max(LinearError, FMath::Abs(Values[First] + Delta * Alpha - Values[Index]));
+		}
+		if (LinearError <= Settings.MaxError)
+		{
+			Fit.bFits = true;
+			Fit.InterpMode = RCIM_Linear;
+			Fit.Error = LinearError;
+			return Fit;
+		}
+
+		if (MaxInterpMode == RCIM_Cubic && Settings.bAllowCubic)
+		{
+			// Hermite form of FRichCurve's non weighted cubic interpolation
+			const float StartTangent = Tangents[First] * Duration;
+			const float EndTangent = Tangents[Last] * Duration;
+
+			float CubicError = 0.0f;
+			for (int32 Index = First + 1; Index < Last && CubicError <= Settings.MaxError; ++Index)
+			{
+				const float S = (Times[Index] - Times[First]) / Duration;
+				const float S2 = S * S;
+				const float S3 = S2 * S;
+				const float Value = (2.0f * S3 - 3.0f * S2 + 1.0f) * Values[First] + (S3 - 2.0f * S2 + S) * StartTangent
+					+ (-2.0f * S3 + 3.0f * S2) * Values[Last] + (S3 - S2) * EndTangent;
+				CubicError = FMath::Max(CubicError, FMath::Abs(Value - Values[Index]));
+			}
+			if (CubicError <= Settings.MaxError)
+			{
+				Fit.bFits = true;
+				Fit.InterpMode = RCIM_Cubic;
+				Fit.Error = CubicError;
+			}
+		}
+
+		return Fit;
+	}
+}
+
+void AnimCurveReduction::ReduceKeys(TArray<FRichCurveKey>& InOutKeys, const FAnimCurveReductionSettings& Settings, FAnimCurveReductionReport& OutReport)
+{
+	OutReport = FAnimCurveReductionReport();
+	OutReport.OriginalKeyCount = InOutKeys.Num();
+
+	if (InOutKeys.Num() == 0)
+	{
+		return;
+	}
+
+	const ERichCurveInterpMode MaxInterpMode = InOutKeys[0].InterpMode;
+	const ERichCurveTangentMode TangentMode = InOutKeys[0].TangentMode;
+
+	TArray<float> Times;
+	TArray<float> Values;
+	Times.Reserve(InOutKeys.Num());
+	Values.Reserve(InOutKeys.Num());
+	for (const FRichCurveKey& Key : InOutKeys)
+	{
+		if (Times.Num() > 0 && FMath::IsNearlyEqual(Times.Last(), Key.Time, KINDA_SMALL_NUMBER))
+		{
+			Values.Last() = Key.Value;
+		}
+		else
+		{
+			Times.Add(Key.Time);
+			Values.Add(Key.Value);
+		}
+	}
+
+	const int32 NumKeys = Times.Num();
+
+	// Tangents of the sampled signal, used by cubic segments on both sides of a key
+	TArray<float> Tangents;
+	Tangents.SetNumZeroed(NumKeys);
+	if (NumKeys > 1)
+	{
+		Tangents[0] = (Values[1] - Values[0]) / (Times[1] - Times[0]);
+		Tangents[NumKeys - 1] = (Values[NumKeys - 1] - Values[NumKeys - 2]) / (Times[NumKeys - 1] - Times[NumKeys - 2]);
+	}
+	for (int32 Index = 1; Index < NumKeys - 1; ++Index)
+	{
+		Tangents[Index] = (Values[Index + 1] - Values[Index - 1]) / (Times[Index + 1] - Times[Index - 1]);
+	}
+
+	// Input index and interp mode of every reduced key
+	TArray<int32> ReducedIndices;
+	TArray<ERichCurveInterpMode> ReducedModes;
+	int32 First = 0;
+	while (First < NumKeys - 1)
+	{
+		// A single step always fits, grow exponentially until a fit fails then binary search between the last good and first bad end
+		int32 GoodLast = First + 1;
+		FSegmentFit GoodFit = FitSegment(Times, Values, Tangents, First, GoodLast, MaxInterpMode, Settings);
+		int32 BadLast = NumKeys;
+
+		for (int32 Step = 2; GoodLast < NumKeys - 1; Step *= 2)
+		{
+			const int32 Last = FMath::Min(First + Step, NumKeys - 1);
+			const FSegmentFit Fit = FitSegment(Times, Values, Tangents, First, Last, MaxInterpMode, Settings);
+			if (!Fit.bFits)
+			{
+				BadLast = Last;
+				break;
+			}
+			GoodLast = Last;
+			GoodFit = Fit;
+		}
+
+		while (BadLast - GoodLast > 1)
+		{
+			const int32 Last = (GoodLast + BadLast) / 2;
+			const FSegmentFit Fit = FitSegment(Times, Values, Tangents, First, Last, MaxInterpMode, Settings);
+			if (Fit.bFits)
+			{
+				GoodLast = Last;
+				GoodFit = Fit;
+			}
+			else
+			{
+				BadLast = Last;
+			}
+		}
+
+		ReducedIndices.Add(First);
+		ReducedModes.Add(GoodFit.InterpMode);
+		First = GoodLast;
+	}
+
+	ReducedIndices.Add(NumKeys - 1);
+	ReducedModes.Add(ReducedModes.Num() > 0 ? ReducedModes.Last() : MaxInterpMode);
+
+	auto MakeKeys = [&](TArray<FRichCurveKey>& OutKeys)
+	{
+		OutKeys.Reset(ReducedIndices.Num());
+		for (int32 ReducedIndex = 0; ReducedIndex < ReducedIndices.Num(); ++ReducedIndex)
+		{
+			const int32 Index = ReducedIndices[ReducedIndex];
+			FRichCurveKey& Key = OutKeys.Emplace_GetRef(Times[Index], Values[Index], Tangents[Index], Tangents[Index], ReducedModes[ReducedIndex]);
+			Key.TangentMode = TangentMode;
+			Key.TangentWeightMode = RCTWM_WeightedNone;
+		}
+	};
+
+	// The fit assumes the tangents above, auto tangents are recomputed from the reduced neighbours when the keys are set.
+	// Measure the curve the caller gets and add back the worst input key of every segment that drifted past MaxError
+	TArray<FRichCurveKey> ReducedKeys;
+	FRichCurve ReducedCurve;
+	TArray<int32> WorstIndices;
+	for (;;)
+	{
+		MakeKeys(ReducedKeys);
+		ReducedCurve.SetKeys(ReducedKeys);
+
+		OutReport.MaxError = 0.0f;
+		WorstIndices.Reset();
+
+		int32 Segment = 0;
+		int32 SegmentWorstIndex = INDEX_NONE;
+		float SegmentWorstError = Settings.MaxError;
+		for (int32 Index = 0; Index < NumKeys; ++Index)
+		{
+			if (Segment + 1 < ReducedIndices.Num() && Index >= ReducedIndices[Segment + 1])
+			{
+				if (SegmentWorstIndex != INDEX_NONE)
+				{
+					WorstIndices.Add(SegmentWorstIndex);
+				}
+				++Segment;
+				SegmentWorstIndex = INDEX_NONE;
+				SegmentWorstError = Settings.MaxError;
+			}
+
+			const float Error = FMath::Abs(ReducedCurve.Eval(Times[Index]) - Values[Index]);
+			OutReport.MaxError = FMath::Max(OutReport.MaxError, Error);
+			if (Error > SegmentWorstError && Index != ReducedIndices[Segment])
+			{
+				SegmentWorstIndex = Index;
+				SegmentWorstError = Error;
+			}
+		}
+		if (SegmentWorstIndex != INDEX_NONE)
+		{
+			WorstIndices.Add(SegmentWorstIndex);
+		}
+
+		if (WorstIndices.Num() == 0)
+		{
+			break;
+		}
+
+		// Worst keys are found in time order, each splits a segment and keeps its mode
+		for (int32 WorstIndex = WorstIndices.Num() - 1; WorstIndex >= 0; --WorstIndex)
+		{
+			const int32 InsertAt = Algo::UpperBound(ReducedIndices, WorstIndices[WorstIndex]);
+			ReducedIndices.Insert(WorstIndices[WorstIndex], InsertAt);
+			ReducedModes.Insert(ReducedModes[InsertAt - 1], InsertAt);
+		}
+	}
+
+	OutReport.ReducedKeyCount = ReducedKeys.Num();
+	InOutKeys = MoveTemp(ReducedKeys);
+}
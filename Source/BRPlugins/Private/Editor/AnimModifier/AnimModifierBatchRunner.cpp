@@ -0,0 +1,246 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/AnimModifierBatchRunner.h"
+#include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+#include "Editor/AnimModifier/AnimPoseSampleCache.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "AnimationModifier.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Unique.h"
+#include "Misc/Optional.h"
+#include "Misc/ScopedSlowTask.h"
+#include "UObject/StrongObjectPtr.h"
+
+#define LOCTEXT_NAMESPACE "AnimModifierBatchRunner"
+
+namespace AnimModifierBatchRunner
+{
+	/** Sequences analyzed ahead of the game thread, bounds the memory held by pending curve output */
+	static const int32 ChunkSize = 64;
+
+	/**
+	 * Adds the curve and sync marker names the analyzed output will write to the skeletons of its sequences. Applying the
+	 * output then finds every name in place, instead of adding them while workers read the skeletons for the next chunk
+	 */
+	static void RegisterOutputNames(TArrayView<UAnimSequence* const> AnimationSequences, TArrayView<const TArray<FAnimModifierCurveOutput>> CurveOutputs)
+	{
+		for (int32 SequenceIndex = 0; SequenceIndex < AnimationSequences.Num(); ++SequenceIndex)
+		{
+			USkeleton* Skeleton = AnimationSequences[SequenceIndex]->GetSkeleton();
+			if (!Skeleton)
+			{
+				continue;
+			}
+
+			for (const FAnimModifierCurveOutput& CurveOutput : CurveOutputs[SequenceIndex])
+			{
+				for (const FAnimModifierCurveOutput::FCurve& Curve : CurveOutput.Curves)
+				{
+					FSmartName SmartName;
+					if (!Skeleton->GetSmartNameByName(USkeleton::AnimCurveMappingName, Curve.CurveName, SmartName))
+					{
+						Skeleton->AddSmartNameAndModify(USkeleton::AnimCurveMappingName, Curve.CurveName, SmartName);
+					}
+				}
+
+				for (const FAnimModifierCurveOutput::FSyncMarker& SyncMarker : CurveOutput.SyncMarkers)
+				{
+					Skeleton->RegisterMarkerName(SyncMarker.MarkerName);
+				}
+			}
+		}
+	}
+}
+
+void FAnimModifierBatchRunner::Run(const TArray<UAnimSequence*>& InAnimationSequences, const TArray<TSubclassOf<UAnimationModifier>>& ModifierClasses, bool bRunInParallel, FAnimModifierBatchReport& OutReport)
+{
+	check(IsInGameThread());
+
+	const double BatchStartTime = FPlatformTime::Seconds();
+	OutReport = FAnimModifierBatchReport();
+
+	TArray<TStrongObjectPtr<UAnimationModifier>> Modifiers;
+	TArray<const IParallelAnimModifier*> ParallelModifiers;
+	for (const TSubclassOf<UAnimationModifier>& ModifierClass : ModifierClasses)
+	{
+		if (ModifierClass && !ModifierClass->HasAnyClassFlags(CLASS_Abstract))
+		{
+			UAnimationModifier* Modifier = NewObject<UAnimationModifier>(GetTransientPackage(), ModifierClass);
+			Modifiers.Emplace(Modifier);
+
+			const IParallelAnimModifier* ParallelModifier = Cast<IParallelAnimModifier>(Modifier);
+			ParallelModifiers.Add(ParallelModifier);
+			if (ParallelModifier)
+			{
+				++OutReport.NumParallelModifiers;
+			}
+			else
+			{
+				++OutReport.NumSerialModifiers;
+			}
+		}
+	}
+
+	// Only the modifiers before the first serial one see the sequence as it was before the run, the ones after it analyze on the game thread
+	const int32 FirstSerialModifier = ParallelModifiers.IndexOfByKey(nullptr);
+	const int32 NumAheadModifiers = FirstSerialModifier != INDEX_NONE ? FirstSerialModifier : ParallelModifiers.Num();
+
+	// A sequence listed twice would be read by the workers while the game thread writes it
+	TArray<UAnimSequence*> AnimationSequences;
+	{
+		TSet<UAnimSequence*> SeenSequences;
+		for (UAnimSequence* AnimationSequence : InAnimationSequences)
+		{
+			bool bAlreadySeen = false;
+			SeenSequences.Add(AnimationSequence, &bAlreadySeen);
+			if (AnimationSequence && !bAlreadySeen)
+			{
+				AnimationSequences.Add(AnimationSequence);
+			}
+		}
+	}
+
+	const int32 NumSequences = AnimationSequences.Num();
+	OutReport.Sequences.SetNum(NumSequences);
+
+	// Curve output of the modifiers analyzed ahead, indexed [Sequence][Modifier]
+	TArray<TArray<FAnimModifierCurveOutput>> CurveOutputs;
+	CurveOutputs.SetNum(NumSequences);
+
+	auto AnalyzeChunk = [&](const int32 ChunkIndex)
+	{
+		const int32 FirstSequence = ChunkIndex * AnimModifierBatchRunner::ChunkSize;
+		const int32 NumChunkSequences = FMath::Min(AnimModifierBatchRunner::ChunkSize, NumSequences - FirstSequence);
+
+		ParallelFor(NumChunkSequences, [&](const int32 ChunkSequenceIndex)
+		{
+			const int32 SequenceIndex = FirstSequence + ChunkSequenceIndex;
+			const double StartTime = FPlatformTime::Seconds();
+
+			TArray<FAnimModifierCurveOutput>& Outputs = CurveOutputs[SequenceIndex];
+			Outputs.SetNum(NumAheadModifiers);
+
+			const UAnimSequence* AnimationSequence = AnimationSequences[SequenceIndex];
+
+			// Sample every bone any modifier needs at once, the modifiers then hit the cache
+			TArray<FName> RequiredBones;
+			for (int32 ModifierIndex = 0; ModifierIndex < NumAheadModifiers; ++ModifierIndex)
+			{
+				ParallelModifiers[ModifierIndex]->GetRequiredBones(AnimationSequence, RequiredBones);
+			}
+
+			// Keeps the samples alive while the modifiers run. The cache entry itself can still be evicted by other workers,
+			// in which case a modifier samples the sequence again instead of sharing
+			FAnimPoseSamplesPtr SharedSamples;
+			if (RequiredBones.Num() > 0)
+			{
+				RequiredBones.Sort(FNameLexicalLess());
+				RequiredBones.SetNum(Algo::Unique(RequiredBones));
+				SharedSamples = FAnimPoseSampleCache::Get().FindOrSample(AnimationSequence, RequiredBones);
+			}
+
+			for (int32 ModifierIndex = 0; ModifierIndex < NumAheadModifiers; ++ModifierIndex)
+			{
+				ParallelModifiers[ModifierIndex]->AnalyzeSequence(AnimationSequence, Outputs[ModifierIndex]);
+			}
+
+			OutReport.Sequences[SequenceIndex].AnalyzeSeconds = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+		}, !bRunInParallel);
+	};
+
+	FAnimPoseSampleCacheScope PoseCacheScope;
+
+	FScopedSlowTask SlowTask(static_cast<float>(NumSequences), LOCTEXT("ApplyingModifiers", "Applying Animation Modifiers"));
+	SlowTask.MakeDialog(true);
+
+	const bool bAnalyzeAhead = NumAheadModifiers > 0;
+
+	// Serial modifiers may change anything on the skeletons the next chunk is analyzed against, so analysis only overlaps
+	// the game thread when every modifier is parallel and all it writes is the analyzed output
+	const bool bOverlapAnalysis = bRunInParallel && bAnalyzeAhead && FirstSerialModifier == INDEX_NONE;
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumSequences, AnimModifierBatchRunner::ChunkSize);
+	if (NumChunks > 0 && bAnalyzeAhead)
+	{
+		AnalyzeChunk(0);
+	}
+
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks && !OutReport.bCancelled; ++ChunkIndex)
+	{
+		const int32 FirstSequence = ChunkIndex * AnimModifierBatchRunner::ChunkSize;
+		const int32 LastSequence = FMath::Min(FirstSequence + AnimModifierBatchRunner::ChunkSize, NumSequences);
+
+		// Analyze the next chunk while this one is written
+		TFuture<void> NextAnalysis;
+		if (ChunkIndex + 1 < NumChunks && bOverlapAnalysis)
+		{
+			AnimModifierBatchRunner::RegisterOutputNames(MakeArrayView(AnimationSequences).Slice(FirstSequence, LastSequence - FirstSequence),
+				MakeArrayView(CurveOutputs).Slice(FirstSequence, LastSequence - FirstSequence));
+			NextAnalysis = Async(EAsyncExecution::ThreadPool, [&AnalyzeChunk, ChunkIndex]() { AnalyzeChunk(ChunkIndex + 1); });
+		}
+		for (int32 SequenceIndex = FirstSequence; SequenceIndex < LastSequence; ++SequenceIndex)
+		{
+			if (SlowTask.ShouldCancel())
+			{
+				OutReport.bCancelled = true;
+				break;
+			}
+
+			UAnimSequence* AnimationSequence = AnimationSequences[SequenceIndex];
+			FAnimModifierSequenceTiming& Timing = OutReport.Sequences[SequenceIndex];
+			Timing.AnimationSequence = AnimationSequence;
+
+			SlowTask.EnterProgressFrame(1.0f, FText::Format(LOCTEXT("ApplyingModifiersTo", "Applying Animation Modifiers to {0}"), FText::FromName(AnimationSequence->GetFName())));
+
+			const double StartTime = FPlatformTime::Seconds();
+			{
+				TOptional<FAnimCurveBatchScope> BatchScope;
+				BatchScope.Emplace();
+
+				for (int32 ModifierIndex = 0; ModifierIndex < Modifiers.Num(); ++ModifierIndex)
+				{
+					// Modifiers running on the game thread read the sequence, so what the ones before them wrote is baked first
+					if (ModifierIndex > 0 && ModifierIndex >= NumAheadModifiers)
+					{
+						BatchScope.Reset();
+						BatchScope.Emplace();
+					}
+
+					if (ModifierIndex < NumAheadModifiers)
+					{
+						UAnimBlueprintLibrary::ApplyCurveOutput(AnimationSequence, CurveOutputs[SequenceIndex][ModifierIndex], &OutReport.KeyReduction);
+					}
+					else if (ParallelModifiers[ModifierIndex])
+					{
+						// Has to see what the serial modifiers before it wrote
+						FAnimModifierCurveOutput CurveOutput;
+						ParallelModifiers[ModifierIndex]->AnalyzeSequence(AnimationSequence, CurveOutput);
+						UAnimBlueprintLibrary::ApplyCurveOutput(AnimationSequence, CurveOutput, &OutReport.KeyReduction);
+					}
+					else
+					{
+						Modifiers[ModifierIndex]->ApplyToAnimationSequence(AnimationSequence);
+					}
+				}
+			}
+			Timing.ApplySeconds = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+
+			CurveOutputs[SequenceIndex].Empty();
+		}
+
+		if (NextAnalysis.IsValid())
+		{
+			NextAnalysis.Wait();
+		}
+		else if (ChunkIndex + 1 < NumChunks && bAnalyzeAhead && !OutReport.bCancelled)
+		{
+			AnalyzeChunk(ChunkIndex + 1);
+		}
+	}
+
+	OutReport.TotalSeconds = static_cast<float>(FPlatformTime::Seconds() - BatchStartTime);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/AnimPoseSampleCache.h"
+#include "Editor/AnimModifier/AnimPoseSampling.h"
+
+#include "Algo/AllOf.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimData/AnimDataModel.h"
+
+FAnimPoseSampleCache& FAnimPoseSampleCache::Get()
+{
+	static FAnimPoseSampleCache Instance;
+	return Instance;
+}
+
+FAnimPoseSamplesPtr FAnimPoseSampleCache::FindOrSample(const UAnimSequence* AnimationSequence, TArrayView<const FName> BoneNames)
+{
+	const UAnimDataModel* DataModel = AnimationSequence ? AnimationSequence->GetDataModel() : nullptr;
+	if (!DataModel)
+	{
+		return nullptr;
+	}
+
+	if (IsInGameThread())
+	{
+		WatchPendingModels();
+	}
+
+	const FObjectKey SequenceKey(AnimationSequence);
+
+	bool bCacheEnabled;
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		bCacheEnabled = ScopeDepth > 0;
+		if (bCacheEnabled)
+		{
+			for (FEntry& Entry : Entries)
+			{
+				if (Entry.Sequence == SequenceKey && Algo::AllOf(BoneNames, [&Entry](const FName BoneName) { return Entry.Samples->BoneNames.Contains(BoneName); }))
+				{
+					++Stats.Hits;
+					Entry.LastUse = ++UseCounter;
+					return Entry.Samples;
+				}
+			}
+			++Stats.Misses;
+		}
+	}
+
+	// Sample outside of the lock, concurrent misses on the same key only duplicate work
+	TSharedRef<FAnimPoseSamples, ESPMode::ThreadSafe> Samples = MakeShared<FAnimPoseSamples, ESPMode::ThreadSafe>();
+	if (!AnimPoseSampling::SampleComponentSpace(AnimationSequence, BoneNames, Samples.Get()))
+	{
+		return nullptr;
+	}
+
+	if (bCacheEnabled)
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		// The scope may have closed while sampling
+		if (ScopeDepth > 0)
+		{
+			FEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.Sequence = SequenceKey;
+			Entry.DataModel = FObjectKey(DataModel);
+			Entry.Samples = Samples;
+			Entry.AllocatedBytes = Samples->GetAllocatedSize();
+			Entry.LastUse = ++UseCounter;
+			Stats.AllocatedBytes += Entry.AllocatedBytes;
+
+			PendingModels.Add(const_cast<UAnimDataModel*>(DataModel));
+
+			EvictToBudget();
+		}
+	}
+
+	if (bCacheEnabled && IsInGameThread())
+	{
+		WatchPendingModels();
+	}
+
+	return Samples;
+}
+
+void FAnimPoseSampleCache::SetBudgetBytes(int64 InBudgetBytes)
+{
+	FScopeLock Lock(&CriticalSection);
+	BudgetBytes = FMath::Max<int64>(0, InBudgetBytes);
+	EvictToBudget();
+}
+
+FAnimPoseSampleCacheStats FAnimPoseSampleCache::GetStats() const
+{
+	FScopeLock Lock(&CriticalSection);
+	FAnimPoseSampleCacheStats Result = Stats;
+	Result.HitRate = Stats.Hits + Stats.Misses > 0 ? static_cast<float>(Stats.Hits) / (Stats.Hits + Stats.Misses) : 0.0f;
+	return Result;
+}
+
+void FAnimPoseSampleCache::ResetStats()
+{
+	FScopeLock Lock(&CriticalSection);
+	const int64 AllocatedBytes = Stats.AllocatedBytes;
+	Stats = FAnimPoseSampleCacheStats();
+	Stats.AllocatedBytes = AllocatedBytes;
+}
+
+void FAnimPoseSampleCache::BeginScope()
+{
+	{
+		FScopeLock Lock(&CriticalSection);
+		++ScopeDepth;
+	}
+
+	if (IsInGameThread())
+	{
+		WatchPendingModels();
+	}
+}
+
+void FAnimPoseSampleCache::EndScope()
+{
+	FScopeLock Lock(&CriticalSection);
+	check(ScopeDepth > 0);
+
+	if (--ScopeDepth == 0)
+	{
+		Entries.Empty();
+		PendingModels.Empty();
+		Stats.AllocatedBytes = 0;
+
+		if (IsInGameThread())
+		{
+			for (const TPair<TWeakObjectPtr<UAnimDataModel>, FDelegateHandle>& WatchedModel : WatchedModels)
+			{
+				if (UAnimDataModel* DataModel = WatchedModel.Key.Get())
+				{
+					DataModel->GetModifiedEvent().Remove(WatchedModel.Value);
+				}
+			}
+			WatchedModels.Empty();
+		}
+	}
+}
+
+void FAnimPoseSampleCache::EvictToBudget()
+{
+	while (Stats.AllocatedBytes > BudgetBytes && Entries.Num() > 0)
+	{
+		int32 OldestIndex = 0;
+		for (int32 EntryIndex = 1; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			if (Entries[EntryIndex].LastUse < Entries[OldestIndex].LastUse)
+			{
+				OldestIndex = EntryIndex;
+			}
+		}
+
+		Stats.AllocatedBytes -= Entries[OldestIndex].AllocatedBytes;
+		++Stats.Evictions;
+		Entries.RemoveAtSwap(OldestIndex);
+	}
+}
+
+void FAnimPoseSampleCache::WatchPendingModels()
+{
+	check(IsInGameThread());
+
+	TArray<TWeakObjectPtr<UAnimDataModel>> Models;
+	{
+		FScopeLock Lock(&CriticalSection);
+		Models = MoveTemp(PendingModels);
+		PendingModels.Reset();
+	}
+
+	for (const TWeakObjectPtr<UAnimDataModel>& WeakModel : Models)
+	{
+		UAnimDataModel* DataModel = WeakModel.Get();
+		if (DataModel && !WatchedModels.Contains(WeakModel))
+		{
+			WatchedModels.Add(WeakModel, DataModel->GetModifiedEvent().AddRaw(this, &FAnimPoseSampleCache::OnModelModified));
+		}
+	}
+}
+
+void FAnimPoseSampleCache::OnModelModified(const EAnimDataModelNotifyType& NotifyType, UAnimDataModel* Model, const FAnimDataModelNotifPayload& Payload)
+{
+	switch (NotifyType)
+	{
+	case EAnimDataModelNotifyType::Populated:
+	case EAnimDataModelNotifyType::Reset:
+	case EAnimDataModelNotifyType::TrackAdded:
+	case EAnimDataModelNotifyType::TrackChanged:
+	case EAnimDataModelNotifyType::TrackRemoved:
+	case EAnimDataModelNotifyType::SequenceLengthChanged:
+	case EAnimDataModelNotifyType::FrameRateChanged:
+		break;
+	default:
+		// Curve writes of the modifiers do not change the sampled poses
+		return;
+	}
+
+	const FObjectKey ModelKey(Model);
+
+	FScopeLock Lock(&CriticalSection);
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		if (Entries[EntryIndex].DataModel == ModelKey)
+		{
+			Stats.AllocatedBytes -= Entries[EntryIndex].AllocatedBytes;
+			Entries.RemoveAtSwap(EntryIndex);
+		}
+	}
+}
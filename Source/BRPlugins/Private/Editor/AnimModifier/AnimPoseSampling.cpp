@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/AnimPoseSampling.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimData/AnimDataModel.h"
+#include "Animation/Skeleton.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAnimPoseSampling, Log, All);
+
+SIZE_T FAnimPoseSamples::GetAllocatedSize() const
+{
+	return BoneNames.GetAllocatedSize()
+		+ PositionX.GetAllocatedSize() + PositionY.GetAllocatedSize() + PositionZ.GetAllocatedSize()
+		+ RotationX.GetAllocatedSize() + RotationY.GetAllocatedSize() + RotationZ.GetAllocatedSize() + RotationW.GetAllocatedSize();
+}
+
+bool AnimPoseSampling::SampleComponentSpace(const UAnimSequence* AnimationSequence, TArrayView<const FName> BoneNames, FAnimPoseSamples& OutSamples)
+{
+	const USkeleton* Skeleton = AnimationSequence ? AnimationSequence->GetSkeleton() : nullptr;
+	const UAnimDataModel* DataModel = AnimationSequence ? AnimationSequence->GetDataModel() : nullptr;
+	if (!Skeleton || !DataModel)
+	{
+		return false;
+	}
+
+	const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+	for (const FName BoneName : BoneNames)
+	{
+		if (RefSkeleton.FindBoneIndex(BoneName) == INDEX_NONE)
+		{
+			UE_LOG(LogAnimPoseSampling, Warning, TEXT("Bone %s is not part of skeleton %s, cannot sample %s"), *BoneName.ToString(), *Skeleton->GetName(), *AnimationSequence->GetName());
+			return false;
+		}
+	}
+
+	const TArray<FTransform>& RefPose = RefSkeleton.GetRefBonePose();
+	const int32 NumRefBones = RefSkeleton.GetNum();
+	const int32 NumFrames = DataModel->GetNumberOfKeys();
+	const int32 NumBones = BoneNames.Num();
+
+	OutSamples.NumFrames = NumFrames;
+	OutSamples.FrameRate = DataModel->GetFrameRate();
+	OutSamples.BoneNames = TArray<FName>(BoneNames);
+
+	const int32 NumSamples = NumBones * NumFrames;
+	for (TArray<float>* Component : { &OutSamples.PositionX, &OutSamples.PositionY, &OutSamples.PositionZ, &OutSamples.RotationX, &OutSamples.RotationY, &OutSamples.RotationZ, &OutSamples.RotationW })
+	{
+		Component->SetNumUninitialized(NumSamples);
+	}
+
+	// Every requested bone and its parent chain, parents always have a lower index than their children
+	TArray<int32> RequestedBoneIndices;
+	TBitArray<> RequiredBones(false, NumRefBones);
+	for (const FName BoneName : BoneNames)
+	{
+		const int32 RefBoneIndex = RefSkeleton.FindBoneIndex(BoneName);
+		RequestedBoneIndices.Add(RefBoneIndex);
+
+		for (int32 ChainIndex = RefBoneIndex; ChainIndex != INDEX_NONE && !RequiredBones[ChainIndex]; ChainIndex = RefSkeleton.GetParentIndex(ChainIndex))
+		{
+			RequiredBones[ChainIndex] = true;
+		}
+	}
+
+	TArray<int32> RequiredBoneIndices;
+	TArray<const FRawAnimSequenceTrack*> RequiredTracks;
+	for (TConstSetBitIterator<> It(RequiredBones); It; ++It)
+	{
+		const int32 RefBoneIndex = It.GetIndex();
+		const FBoneAnimationTrack* BoneTrack = DataModel->FindBoneTrackByName(RefSkeleton.GetBoneName(RefBoneIndex));
+
+		RequiredBoneIndices.Add(RefBoneIndex);
+		RequiredTracks.Add(BoneTrack ? &BoneTrack->InternalTrackData : nullptr);
+	}
+
+	TArray<FTransform> ComponentSpaceTransforms;
+	ComponentSpaceTransforms.SetNum(NumRefBones);
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		for (int32 RequiredIndex = 0; RequiredIndex < RequiredBoneIndices.Num(); ++RequiredIndex)
+		{
+			const int32 RefBoneIndex = RequiredBoneIndices[RequiredIndex];
+
+			FTransform LocalTransform = RefPose[RefBoneIndex];
+			if (const FRawAnimSequenceTrack* Track = RequiredTracks[RequiredIndex])
+			{
+				if (Track->PosKeys.Num() > 0)
+				{
+					LocalTransform.SetTranslation(FVector(Track->PosKeys[FMath::Min(Frame, Track->PosKeys.Num() - 1)]));
+				}
+				if (Track->RotKeys.Num() > 0)
+				{
+					LocalTransform.SetRotation(FQuat(Track->RotKeys[FMath::Min(Frame, Track->RotKeys.Num() - 1)]));
+				}
+				if (Track->ScaleKeys.Num() > 0)
+				{
+					LocalTransform.SetScale3D(FVector(Track->ScaleKeys[FMath::Min(Frame, Track->ScaleKeys.Num() - 1)]));
+				}
+			}
+
+			const int32 ParentIndex = RefSkeleton.GetParentIndex(RefBoneIndex);
+			ComponentSpaceTransforms[RefBoneIndex] = ParentIndex != INDEX_NONE ? LocalTransform * ComponentSpaceTransforms[ParentIndex] : LocalTransform;
+		}
+
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			const int32 RefBoneIndex = RequestedBoneIndices[BoneIndex];
+			const FTransform& Transform = ComponentSpaceTransforms[RefBoneIndex];
+			const FVector Position = Transform.GetTranslation();
+			const FQuat Rotation = Transform.GetRotation();
+
+			const int32 SampleIndex = BoneIndex * NumFrames + Frame;
+			OutSamples.PositionX[SampleIndex] = static_cast<float>(Position.X);
+			OutSamples.PositionY[SampleIndex] = static_cast<float>(Position.Y);
+			OutSamples.PositionZ[SampleIndex] = static_cast<float>(Position.Z);
+			OutSamples.RotationX[SampleIndex] = static_cast<float>(Rotation.X);
+			OutSamples.RotationY[SampleIndex] = static_cast<float>(Rotation.Y);
+			OutSamples.RotationZ[SampleIndex] = static_cast<float>(Rotation.Z);
+			OutSamples.RotationW[SampleIndex] = static_cast<float>(Rotation.W);
+		}
+	}
+
+	return true;
+}
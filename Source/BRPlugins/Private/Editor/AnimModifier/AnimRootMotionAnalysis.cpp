@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/AnimRootMotionAnalysis.h"
+#include "Editor/AnimModifier/AnimCurveKernels.h"
+#include "Editor/AnimModifier/AnimModifierBatchRunner.h"
+#include "Editor/AnimModifier/AnimPoseSampleCache.h"
+#include "Editor/AnimModifier/AnimPoseSampling.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+
+bool AnimRootMotionAnalysis::Analyze(const UAnimSequence* AnimationSequence, const FRootMotionDirectionSettings& Settings, FAnimModifierCurveOutput& OutCurves)
+{
+	const USkeleton* Skeleton = AnimationSequence ? AnimationSequence->GetSkeleton() : nullptr;
+	if (!Skeleton || Skeleton->GetReferenceSkeleton().GetNum() == 0)
+	{
+		return false;
+	}
+
+	const FName RootBone = Settings.RootBone != NAME_None ? Settings.RootBone : Skeleton->GetReferenceSkeleton().GetBoneName(0);
+
+	const FAnimPoseSamplesPtr SamplesPtr = FAnimPoseSampleCache::Get().FindOrSample(AnimationSequence, MakeArrayView(&RootBone, 1));
+	if (!SamplesPtr.IsValid() || SamplesPtr->NumFrames == 0)
+	{
+		return false;
+	}
+
+	const FAnimPoseSamples& Samples = *SamplesPtr;
+	const int32 RootIndex = Samples.FindBone(RootBone);
+
+	const int32 NumFrames = Samples.NumFrames;
+	const float InvDeltaTime = 1.0f / Samples.GetFrameInterval();
+	const int32 HalfWindow = Settings.SmoothingHalfWindow;
+
+	TArray<float> Times;
+	Times.SetNumUninitialized(NumFrames);
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		Times[Frame] = Samples.GetFrameTime(Frame);
+	}
+
+	TArray<float> Scratch, VelocityX, VelocityY, MoveYaw, FacingYaw;
+	for (TArray<float>* Buffer : { &Scratch, &VelocityX, &VelocityY, &MoveYaw, &FacingYaw })
+	{
+		Buffer->SetNumUninitialized(NumFrames);
+	}
+
+	// Velocity, smoothed before anything is derived from it
+	AnimCurveKernels::Derivative(Samples.GetPositionX(RootIndex), NumFrames, InvDeltaTime, Scratch.GetData());
+	AnimCurveKernels::MovingAverage(Scratch.GetData(), NumFrames, HalfWindow, VelocityX.GetData());
+	AnimCurveKernels::Derivative(Samples.GetPositionY(RootIndex), NumFrames, InvDeltaTime, Scratch.GetData());
+	AnimCurveKernels::MovingAverage(Scratch.GetData(), NumFrames, HalfWindow, VelocityY.GetData());
+
+	// Continuous facing yaw
+	AnimCurveKernels::QuatYawDegrees(Samples.GetRotationX(RootIndex), Samples.GetRotationY(RootIndex), Samples.GetRotationZ(RootIndex), Samples.GetRotationW(RootIndex), NumFrames, Scratch.GetData());
+	AnimCurveKernels::UnwindDegrees(Scratch.GetData(), NumFrames);
+	AnimCurveKernels::MovingAverage(Scratch.GetData(), NumFrames, HalfWindow, FacingYaw.GetData());
+
+	AnimCurveKernels::Atan2Degrees(VelocityY.GetData(), VelocityX.GetData(), NumFrames, MoveYaw.GetData());
+
+	OutCurves.Reduction = Settings.KeyReduction;
+	OutCurves.Reduction.MaxError = FMath::Min(OutCurves.Reduction.MaxError, Settings.Tolerance);
+	OutCurves.Curves.Reserve(OutCurves.Curves.Num() + 3);
+
+	FAnimModifierCurveOutput::FCurve& SpeedCurve = OutCurves.AddCurve(Settings.SpeedCurveName, CIM_Linear);
+	SpeedCurve.Times = Times;
+	SpeedCurve.Values.SetNumUninitialized(NumFrames);
+	AnimCurveKernels::Length2(VelocityX.GetData(), VelocityY.GetData(), NumFrames, SpeedCurve.Values.GetData());
+
+	FAnimModifierCurveOutput::FCurve& HeadingCurve = OutCurves.AddCurve(Settings.HeadingCurveName, CIM_Linear);
+	HeadingCurve.Times = Times;
+	HeadingCurve.Values.SetNumUninitialized(NumFrames);
+	if (Settings.bHeadingRelativeToFacing)
+	{
+		AnimCurveKernels::ScaleOffset(FacingYaw.GetData(), NumFrames, -1.0f, 0.0f, Scratch.GetData());
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			MoveYaw[Frame] += Scratch[Frame];
+		}
+	}
+
+	// Hold the last defined heading while standing still, the first moving frame covers the start
+	const int32 FirstMovingFrame = SpeedCurve.Values.IndexByPredicate([&Settings](const float Speed) { return Speed >= Settings.MinSpeed; });
+	float HeldHeading = FirstMovingFrame != INDEX_NONE ? FMath::UnwindDegrees(MoveYaw[FirstMovingFrame]) : 0.0f;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		if (SpeedCurve.Values[Frame] >= Settings.MinSpeed)
+		{
+			HeldHeading = FMath::UnwindDegrees(MoveYaw[Frame]);
+		}
+		HeadingCurve.Values[Frame] = HeldHeading;
+	}
+
+	// Linear keys would otherwise sweep through 0 where the heading crosses -180/180
+	AnimCurveKernels::UnwindDegrees(HeadingCurve.Values.GetData(), NumFrames);
+
+	FAnimModifierCurveOutput::FCurve& TurnRateCurve = OutCurves.AddCurve(Settings.TurnRateCurveName, CIM_Linear);
+	TurnRateCurve.Times = MoveTemp(Times);
+	TurnRateCurve.Values.SetNumUninitialized(NumFrames);
+	AnimCurveKernels::Derivative(FacingYaw.GetData(), NumFrames, InvDeltaTime, TurnRateCurve.Values.GetData());
+
+	return true;
+}
@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Editor/AnimModifier/FeetAnimationModifier.h"
+#include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+#include "Editor/AnimModifier/AnimCurveKernels.h"
+#include "Editor/AnimModifier/AnimPoseSampleCache.h"
+#include "Editor/AnimModifier/AnimPoseSampling.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFeetAnimationModifier, Log, All);
+
+UFeetAnimationModifier::UFeetAnimationModifier()
+{
+	FootBones.Add(TEXT("foot_l"));
+	FootBones.Add(TEXT("foot_r"));
+}
+
+void UFeetAnimationModifier::OnApply_Implementation(UAnimSequence* AnimationSequence)
+{
+	FAnimModifierCurveOutput CurveOutput;
+	AnalyzeSequence(AnimationSequence, CurveOutput);
+	UAnimBlueprintLibrary::ApplyCurveOutput(AnimationSequence, CurveOutput);
+}
+
+void UFeetAnimationModifier::OnRevert_Implementation(UAnimSequence* AnimationSequence)
+{
+	UAnimBlueprintLibrary::RemoveCurve(AnimationSequence, CurveName, false);
+	for (const FName BoneName : FootBones)
+	{
+		UAnimBlueprintLibrary::RemoveCurve(AnimationSequence, GetBonePositionCurveName(BoneName), false);
+	}
+
+	for (const FName TrackName : { SyncTrackName, NotifyTrackName })
+	{
+		if (UAnimBlueprintLibrary::IsValidAnimNotifyTrackName(AnimationSequence, TrackName))
+		{
+			UAnimBlueprintLibrary::RemoveAnimationSyncMarkersByTrack(AnimationSequence, TrackName);
+			UAnimBlueprintLibrary::RemoveAnimationNotifyTrack(AnimationSequence, TrackName);
+		}
+	}
+}
+
+void UFeetAnimationModifier::AnalyzeSequence(const UAnimSequence* AnimationSequence, FAnimModifierCurveOutput& OutCurves) const
+{
+	if (FootBones.Num() < 2)
+	{
+		UE_LOG(LogFeetAnimationModifier, Warning, TEXT("%s needs two foot bones, %s is not modified"), *GetName(), *GetNameSafe(AnimationSequence));
+		return;
+	}
+
+	const FAnimPoseSamplesPtr SamplesPtr = FAnimPoseSampleCache::Get().FindOrSample(AnimationSequence, FootBones);
+	if (!SamplesPtr.IsValid() || SamplesPtr->NumFrames == 0)
+	{
+		return;
+	}
+
+	const FAnimPoseSamples& Samples = *SamplesPtr;
+	const int32 NumFrames = Samples.NumFrames;
+	const FVector3f Direction = FVector3f(MotionDirection.GetSafeNormal());
+
+	TArray<float> Times;
+	Times.SetNumUninitialized(NumFrames);
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		Times[Frame] = Samples.GetFrameTime(Frame);
+	}
+
+	OutCurves.Reduction = KeyReduction;
+	OutCurves.ReplaceNotifyTracks.Add(SyncTrackName);
+	OutCurves.ReplaceNotifyTracks.AddUnique(NotifyTrackName);
+
+	// Position of every foot along the motion direction
+	TArray<TArray<float>> BonePositions;
+	BonePositions.SetNum(FootBones.Num());
+	for (int32 FootIndex = 0; FootIndex < FootBones.Num(); ++FootIndex)
+	{
+		const int32 BoneIndex = Samples.FindBone(FootBones[FootIndex]);
+		BonePositions[FootIndex].SetNumUninitialized(NumFrames);
+		AnimCurveKernels::Dot3(Samples.GetPositionX(BoneIndex), Samples.GetPositionY(BoneIndex), Samples.GetPositionZ(BoneIndex), Direction, NumFrames, BonePositions[FootIndex].GetData());
+
+		if (bCreateBonePositionCurves)
+		{
+			FAnimModifierCurveOutput::FCurve& BoneCurve = OutCurves.AddCurve(GetBonePositionCurveName(FootBones[FootIndex]), CIM_Linear);
+			BoneCurve.Times = Times;
+			BoneCurve.Values = BonePositions[FootIndex];
+		}
+	}
+
+	// Distance of the first foot ahead of the second, normalized to the range it covers over the clip
+	TArray<float> FeetOffset;
+	FeetOffset.SetNumUninitialized(NumFrames);
+	float MinOffset = TNumericLimits<float>::Max();
+	float MaxOffset = TNumericLimits<float>::Lowest();
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		FeetOffset[Frame] = BonePositions[0][Frame] - BonePositions[1][Frame];
+		MinOffset = FMath::Min(MinOffset, FeetOffset[Frame]);
+		MaxOffset = FMath::Max(MaxOffset, FeetOffset[Frame]);
+	}
+
+	if (MaxOffset - MinOffset <= KINDA_SMALL_NUMBER)
+	{
+		UE_LOG(LogFeetAnimationModifier, Warning, TEXT("%s: %s and %s do not move relative to each other in %s, no steps found"),
+			*GetName(), *FootBones[0].ToString(), *FootBones[1].ToString(), *GetNameSafe(AnimationSequence));
+		return;
+	}
+
+	const float Scale = 1.0f / (MaxOffset - MinOffset);
+	TArray<float> FeetPosition;
+	FeetPosition.SetNumUninitialized(NumFrames);
+	AnimCurveKernels::ScaleOffset(FeetOffset.GetData(), NumFrames, Scale, -MinOffset * Scale, FeetPosition.GetData());
+
+	// Markers alternate, a step is only placed once the curve went through the other threshold
+	enum class EStep : uint8 { None, On, Next };
+	EStep LastStep = FeetPosition[0] >= StepOnValue ? EStep::On : (FeetPosition[0] <= StepNextValue ? EStep::Next : EStep::None);
+
+	auto AddStep = [&](FName MarkerName, float Threshold, int32 Frame)
+	{
+		const float Alpha = (Threshold - FeetPosition[Frame - 1]) / (FeetPosition[Frame] - FeetPosition[Frame - 1]);
+		const float Time = FMath::Lerp(Times[Frame - 1], Times[Frame], Alpha);
+
+		OutCurves.SyncMarkers.Add({ MarkerName, Time, SyncTrackName });
+		if (bCreateAnimNotify)
+		{
+			OutCurves.Notifies.Add({ Time, NotifyTrackName, NotifyClass });
+		}
+	};
+
+	for (int32 Frame = 1; Frame < NumFrames; ++Frame)
+	{
+		if (LastStep != EStep::On && FeetPosition[Frame - 1] < StepOnValue && FeetPosition[Frame] >= StepOnValue)
+		{
+			AddStep(StepOnMarkerName, StepOnValue, Frame);
+			LastStep = EStep::On;
+		}
+		else if (LastStep != EStep::Next && FeetPosition[Frame - 1] > StepNextValue && FeetPosition[Frame] <= StepNextValue)
+		{
+			AddStep(StepNextMarkerName, StepNextValue, Frame);
+			LastStep = EStep::Next;
+		}
+	}
+
+	if (bCreateFootPositionCurve)
+	{
+		FAnimModifierCurveOutput::FCurve& PositionCurve = OutCurves.AddCurve(CurveName, CIM_Linear);
+		PositionCurve.Times = MoveTemp(Times);
+		PositionCurve.Values = MoveTemp(FeetPosition);
+	}
+}
+
+void UFeetAnimationModifier::GetRequiredBones(const UAnimSequence* AnimationSequence, TArray<FName>& OutBoneNames) const
+{
+	OutBoneNames.Append(FootBones);
+}
+
+FName UFeetAnimationModifier::GetBonePositionCurveName(FName BoneName) const
+{
+	return FName(*(BoneName.ToString() + BonePositionCurveSuffix));
+}
@@ -0,0 +1,227 @@
+#include "Rendering/LensDistortion.h"
+
+#include "Rendering/SimpleRenderingExample.h"
+#include "Engine/Texture2D.h"
+
+#include "Async/ParallelFor.h"
+
+FVector2f FLensDistortionCameraModel::UndistortViewportUV(const FVector2f& ViewportUV) const
+{
+	const FVector4f DistortedCameraMatrix = GetDistortedCameraMatrix();
+	const FVector4f UndistortedCameraMatrix = GetUndistortedCameraMatrix();
+
+	const FVector2f V((ViewportUV.X - DistortedCameraMatrix.Z) / DistortedCameraMatrix.X, (ViewportUV.Y - DistortedCameraMatrix.W) / DistortedCameraMatrix.Y);
+	const FVector2f V2 = V * V;
+	const float R2 = V2.X + V2.Y;
+
+	FVector2f UndistortedV = V * (1.0f + R2 * (K1 + R2 * (K2 + R2 * K3)));
+	UndistortedV.X += P2 * (R2 + 2.0f * V2.X) + 2.0f * P1 * V.X * V.Y;
+	UndistortedV.Y += P1 * (R2 + 2.0f * V2.Y) + 2.0f * P2 * V.X * V.Y;
+
+	return FVector2f(UndistortedCameraMatrix.X * UndistortedV.X + UndistortedCameraMatrix.Z, UndistortedCameraMatrix.Y * UndistortedV.Y + UndistortedCameraMatrix.W);
+}
+
+namespace SimpleRenderingExample
+{
+	struct FLensDistortionCoefsVec
+	{
+		VectorRegister4Float K1, K2, K3, P1, P2;
+
+		explicit FLensDistortionCoefsVec(const FLensDistortionCameraModel& CameraModel)
+			: K1(VectorSetFloat1(CameraModel.K1))
+			, K2(VectorSetFloat1(CameraModel.K2))
+			, K3(VectorSetFloat1(CameraModel.K3))
+			, P1(VectorSetFloat1(CameraModel.P1))
+			, P2(VectorSetFloat1(CameraModel.P2))
+		{
+		}
+	};
+
+	/** UndistortNormalizedViewPosition for 4 view positions, plus its symmetric Jacobian (Dxx, Dxy, Dyy) when requested */
+	static FORCEINLINE void UndistortNormalizedViewPosition(const FLensDistortionCoefsVec& Coefs, const VectorRegister4Float& X, const VectorRegister4Float& Y,
+		VectorRegister4Float& OutX, VectorRegister4Float& OutY, VectorRegister4Float* OutJacobian = nullptr)
+	{
+		const VectorRegister4Float One = VectorOneFloat();
+		const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+		const VectorRegister4Float XX = VectorMultiply(X, X);
+		const VectorRegister4Float YY = VectorMultiply(Y, Y);
+		const VectorRegister4Float XY = VectorMultiply(X, Y);
+		const VectorRegister4Float R2 = VectorAdd(XX, YY);
+
+		// 1 + R2 * (K1 + R2 * (K2 + R2 * K3))
+		const VectorRegister4Float Radial = VectorMultiplyAdd(R2, VectorMultiplyAdd(R2, VectorMultiplyAdd(R2, Coefs.K3, Coefs.K2), Coefs.K1), One);
+
+		// X * Radial + P2 * (R2 + 2 * XX) + 2 * P1 * XY
+		OutX = VectorMultiplyAdd(X, Radial, VectorMultiplyAdd(Coefs.P2, VectorMultiplyAdd(Two, XX, R2), VectorMultiply(Two, VectorMultiply(Coefs.P1, XY))));
+		OutY = VectorMultiplyAdd(Y, Radial, VectorMultiplyAdd(Coefs.P1, VectorMultiplyAdd(Two, YY, R2), VectorMultiply(Two, VectorMultiply(Coefs.P2, XY))));
+
+		if (OutJacobian)
+		{
+			// dRadial/dR2 = K1 + 2 K2 R2 + 3 K3 R2^2, and dR2/dX = 2X
+			const VectorRegister4Float RadialDerivative = VectorMultiplyAdd(R2, VectorMultiplyAdd(R2, VectorMultiply(VectorSetFloat1(3.0f), Coefs.K3), VectorMultiply(Two, Coefs.K2)), Coefs.K1);
+			const VectorRegister4Float TwoRadialDerivative = VectorMultiply(Two, RadialDerivative);
+			const VectorRegister4Float Six = VectorSetFloat1(6.0f);
+
+			// Dxx = Radial + 2 XX Radial' + 6 P2 X + 2 P1 Y
+			OutJacobian[0] = VectorMultiplyAdd(XX, TwoRadialDerivative, VectorMultiplyAdd(Six, VectorMultiply(Coefs.P2, X), VectorMultiplyAdd(Two, VectorMultiply(Coefs.P1, Y), Radial)));
+			// Dxy = Dyx = 2 XY Radial' + 2 P1 X + 2 P2 Y
+			OutJacobian[1] = VectorMultiplyAdd(XY, TwoRadialDerivative, VectorMultiply(Two, VectorMultiplyAdd(Coefs.P1, X, VectorMultiply(Coefs.P2, Y))));
+			// Dyy = Radial + 2 YY Radial' + 6 P1 Y + 2 P2 X
+			OutJacobian[2] = VectorMultiplyAdd(YY, TwoRadialDerivative, VectorMultiplyAdd(Six, VectorMultiply(Coefs.P1, Y), VectorMultiplyAdd(Two, VectorMultiply(Coefs.P2, X), Radial)));
+		}
+	}
+
+	void GenerateLensDistortionMapCPU(const FLensDistortionCameraModel& CameraModel, int32 SizeX, int32 SizeY, TArray<FVector4f>& OutDisplacement,
+		FLensDistortionMapReport& OutReport, int32 NumNewtonIterations, float TolerancePixels)
+	{
+		OutReport = FLensDistortionMapReport();
+		OutDisplacement.SetNumUninitialized(FMath::Max(SizeX, 0) * FMath::Max(SizeY, 0));
+		if (OutDisplacement.Num() == 0)
+		{
+			return;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		const FLensDistortionCoefsVec Coefs(CameraModel);
+		const FVector4f DistortedCameraMatrix = CameraModel.GetDistortedCameraMatrix();
+		const FVector4f UndistortedCameraMatrix = CameraModel.GetUndistortedCameraMatrix();
+		const FVector2f PixelUVSize(1.0f / SizeX, 1.0f / SizeY);
+
+		const VectorRegister4Float DistortedFocalX = VectorSetFloat1(DistortedCameraMatrix.X);
+		const VectorRegister4Float DistortedFocalY = VectorSetFloat1(DistortedCameraMatrix.Y);
+		const VectorRegister4Float DistortedCenterX = VectorSetFloat1(DistortedCameraMatrix.Z);
+		const VectorRegister4Float DistortedCenterY = VectorSetFloat1(DistortedCameraMatrix.W);
+		const VectorRegister4Float UndistortedFocalX = VectorSetFloat1(UndistortedCameraMatrix.X);
+		const VectorRegister4Float UndistortedFocalY = VectorSetFloat1(UndistortedCameraMatrix.Y);
+		const VectorRegister4Float UndistortedCenterX = VectorSetFloat1(UndistortedCameraMatrix.Z);
+		const VectorRegister4Float UndistortedCenterY = VectorSetFloat1(UndistortedCameraMatrix.W);
+		const VectorRegister4Float MinDeterminant = VectorSetFloat1(SMALL_NUMBER);
+		const FVector4f OutputAdd(CameraModel.OutputAdd, CameraModel.OutputAdd, CameraModel.OutputAdd, CameraModel.OutputAdd);
+
+		TArray<float> RowMaxResidual;
+		TArray<double> RowResidualSum;
+		TArray<int32> RowUnconverged;
+		RowMaxResidual.SetNumZeroed(SizeY);
+		RowResidualSum.SetNumZeroed(SizeY);
+		RowUnconverged.SetNumZeroed(SizeY);
+
+		ParallelFor(SizeY, [&](int32 Y)
+		{
+			// SvPosition * PixelUVSize minus the half pixel shift, top left originated
+			const VectorRegister4Float ViewportV = VectorSetFloat1(Y * PixelUVSize.Y);
+			FVector4f* Row = OutDisplacement.GetData() + Y * SizeX;
+
+			for (int32 X = 0; X < SizeX; X += 4)
+			{
+				const VectorRegister4Float ViewportU = MakeVectorRegisterFloat(X * PixelUVSize.X, (X + 1) * PixelUVSize.X, (X + 2) * PixelUVSize.X, (X + 3) * PixelUVSize.X);
+
+				// Distort to undistort, UndistortViewportUV(ViewportUV) - ViewportUV
+				VectorRegister4Float UndistortedX, UndistortedY;
+				UndistortNormalizedViewPosition(Coefs,
+					VectorDivide(VectorSubtract(ViewportU, DistortedCenterX), DistortedFocalX),
+					VectorDivide(VectorSubtract(ViewportV, DistortedCenterY), DistortedFocalY),
+					UndistortedX, UndistortedY);
+				const VectorRegister4Float ForwardU = VectorSubtract(VectorMultiplyAdd(UndistortedFocalX, UndistortedX, UndistortedCenterX), ViewportU);
+				const VectorRegister4Float ForwardV = VectorSubtract(VectorMultiplyAdd(UndistortedFocalY, UndistortedY, UndistortedCenterY), ViewportV);
+
+				// Undistort to distort, solve UndistortNormalizedViewPosition(View) = Target starting from the target itself
+				const VectorRegister4Float TargetX = VectorDivide(VectorSubtract(ViewportU, UndistortedCenterX), UndistortedFocalX);
+				const VectorRegister4Float TargetY = VectorDivide(VectorSubtract(ViewportV, UndistortedCenterY), UndistortedFocalY);
+				VectorRegister4Float ViewX = TargetX;
+				VectorRegister4Float ViewY = TargetY;
+
+				for (int32 Iteration = 0; Iteration < NumNewtonIterations; ++Iteration)
+				{
+					VectorRegister4Float ValueX, ValueY, Jacobian[3];
+					UndistortNormalizedViewPosition(Coefs, ViewX, ViewY, ValueX, ValueY, Jacobian);
+
+					const VectorRegister4Float ResidualX = VectorSubtract(ValueX, TargetX);
+					const VectorRegister4Float ResidualY = VectorSubtract(ValueY, TargetY);
+					const VectorRegister4Float Determinant = VectorSubtract(VectorMultiply(Jacobian[0], Jacobian[2]), VectorMultiply(Jacobian[1], Jacobian[1]));
+
+					// Lanes with a singular Jacobian keep their current estimate
+					const VectorRegister4Float Valid = VectorCompareGT(VectorAbs(Determinant), MinDeterminant);
+					const VectorRegister4Float InvDeterminant = VectorSelect(Valid, VectorDivide(VectorOneFloat(), Determinant), VectorZeroFloat());
+
+					ViewX = VectorSubtract(ViewX, VectorMultiply(VectorSubtract(VectorMultiply(Jacobian[2], ResidualX), VectorMultiply(Jacobian[1], ResidualY)), InvDeterminant));
+					ViewY = VectorSubtract(ViewY, VectorMultiply(VectorSubtract(VectorMultiply(Jacobian[0], ResidualY), VectorMultiply(Jacobian[1], ResidualX)), InvDeterminant));
+				}
+
+				const VectorRegister4Float InverseU = VectorSubtract(VectorMultiplyAdd(DistortedFocalX, ViewX, DistortedCenterX), ViewportU);
+				const VectorRegister4Float InverseV = VectorSubtract(VectorMultiplyAdd(DistortedFocalY, ViewY, DistortedCenterY), ViewportV);
+
+				// Residual against the analytic forward model, in pixels
+				VectorRegister4Float SolvedX, SolvedY;
+				UndistortNormalizedViewPosition(Coefs, ViewX, ViewY, SolvedX, SolvedY);
+				const VectorRegister4Float ResidualU = VectorMultiply(VectorMultiply(VectorSubtract(SolvedX, TargetX), UndistortedFocalX), VectorSetFloat1(static_cast<float>(SizeX)));
+				const VectorRegister4Float ResidualV = VectorMultiply(VectorMultiply(VectorSubtract(SolvedY, TargetY), UndistortedFocalY), VectorSetFloat1(static_cast<float>(SizeY)));
+				const VectorRegister4Float Residual = VectorSqrt(VectorMultiplyAdd(ResidualU, ResidualU, VectorMultiply(ResidualV, ResidualV)));
+
+				alignas(16) float Lanes[5][4];
+				VectorStoreAligned(ForwardU, Lanes[0]);
+				VectorStoreAligned(ForwardV, Lanes[1]);
+				VectorStoreAligned(InverseU, Lanes[2]);
+				VectorStoreAligned(InverseV, Lanes[3]);
+				VectorStoreAligned(Residual, Lanes[4]);
+
+				const int32 NumLanes = FMath::Min(4, SizeX - X);
+				for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+				{
+					Row[X + Lane] = FVector4f(Lanes[0][Lane], Lanes[1][Lane], Lanes[2][Lane], Lanes[3][Lane]) * CameraModel.OutputMultiply + OutputAdd;
+
+					// NaN residuals from diverged lanes count as unconverged
+					const float LaneResidual = Lanes[4][Lane];
+					if (!(LaneResidual <= TolerancePixels))
+					{
+						++RowUnconverged[Y];
+					}
+					if (FMath::IsFinite(LaneResidual))
+					{
+						RowMaxResidual[Y] = FMath::Max(RowMaxResidual[Y], LaneResidual);
+						RowResidualSum[Y] += LaneResidual;
+					}
+				}
+			}
+		});
+
+		double ResidualSum = 0.0;
+		for (int32 Y = 0; Y < SizeY; ++Y)
+		{
+			OutReport.MaxResidualPixels = FMath::Max(OutReport.MaxResidualPixels, RowMaxResidual[Y]);
+			OutReport.NumUnconverged += RowUnconverged[Y];
+			ResidualSum += RowResidualSum[Y];
+		}
+		OutReport.MeanResidualPixels = static_cast<float>(ResidualSum / OutDisplacement.Num());
+		OutReport.Seconds = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+	}
+} // namespace SimpleRenderingExample
+
+UTexture2D* USimpleRenderingExampleBlueprintLibrary::GenerateLensDistortionMapCPU(FLensDistortionCameraModel CameraModel, int32 SizeX, int32 SizeY, FLensDistortionMapReport& OutReport)
+{
+	check(IsInGameThread());
+	OutReport = FLensDistortionMapReport();
+
+	if (SizeX <= 0 || SizeY <= 0)
+	{
+		return nullptr;
+	}
+
+	TArray<FVector4f> Displacement;
+	SimpleRenderingExample::GenerateLensDistortionMapCPU(CameraModel, SizeX, SizeY, Displacement, OutReport);
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(SizeX, SizeY, PF_A32B32G32R32F);
+	if (!Texture)
+	{
+		return nullptr;
+	}
+
+	Texture->SRGB = false;
+	Texture->CompressionSettings = TC_HDR;
+	Texture->Filter = TF_Bilinear;
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	FMemory::Memcpy(Mip.BulkData.Lock(LOCK_READ_WRITE), Displacement.GetData(), Displacement.Num() * sizeof(FVector4f));
+	Mip.BulkData.Unlock();
+	Texture->UpdateResource();
+	return Texture;
+}
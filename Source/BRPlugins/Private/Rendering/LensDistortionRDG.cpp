@@ -0,0 +1,259 @@
+#include "Rendering/SimpleRenderingExample.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+#include "PipelineStateCache.h"
+
+#include "CommonRenderResources.h"
+#include "GlobalShader.h"
+#include "RenderGraphUtils.h"
+#include "RenderResource.h"
+#include "RenderTargetPool.h"
+#include "RHIStaticStates.h"
+#include "ShaderParameterUtils.h"
+
+namespace SimpleRenderingExample
+{
+	/*
+	 * Shader
+	 */
+	class FLensDistortionUVGenerationShader : public FGlobalShader
+	{
+	public:
+		class FGridSubdivisionX : SHADER_PERMUTATION_SPARSE_INT("GRID_SUBDIVISION_X", 16, 32, 64);
+		class FGridSubdivisionY : SHADER_PERMUTATION_SPARSE_INT("GRID_SUBDIVISION_Y", 16, 32, 64);
+		using FPermutationDomain = TShaderPermutationDomain<FGridSubdivisionX, FGridSubdivisionY>;
+
+		SHADER_USE_PARAMETER_STRUCT(FLensDistortionUVGenerationShader, FGlobalShader);
+
+		BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(FVector2f, PixelUVSize)
+		SHADER_PARAMETER(FVector3f, RadialDistortionCoefs)
+		SHADER_PARAMETER(FVector2f, TangentialDistortionCoefs)
+		SHADER_PARAMETER(FVector4f, UndistortedCameraMatrix)
+		SHADER_PARAMETER(FVector4f, DistortedCameraMatrix)
+		SHADER_PARAMETER(FVector2f, OutputMultiplyAndAdd)
+		RENDER_TARGET_BINDING_SLOTS()
+		END_SHADER_PARAMETER_STRUCT()
+
+		static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters &Parameters)
+		{
+			return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::ES3_1);
+		}
+	};
+
+	class FLensDistortionUVGenerationVS : public FLensDistortionUVGenerationShader
+	{
+	public:
+		DECLARE_GLOBAL_SHADER(FLensDistortionUVGenerationVS);
+
+		FLensDistortionUVGenerationVS() {}
+
+		FLensDistortionUVGenerationVS(const ShaderMetaType::CompiledShaderInitializerType &Initializer) : FLensDistortionUVGenerationShader(Initializer) {}
+	};
+
+	class FLensDistortionUVGenerationPS : public FLensDistortionUVGenerationShader
+	{
+	public:
+		DECLARE_GLOBAL_SHADER(FLensDistortionUVGenerationPS);
+
+		FLensDistortionUVGenerationPS() {}
+
+		FLensDistortionUVGenerationPS(const ShaderMetaType::CompiledShaderInitializerType &Initializer) : FLensDistortionUVGenerationShader(Initializer) {}
+	};
+
+	IMPLEMENT_GLOBAL_SHADER(FLensDistortionUVGenerationVS, "/BRPlugins/Private/LensDistortion.usf", "MainVS", SF_Vertex);
+	IMPLEMENT_GLOBAL_SHADER(FLensDistortionUVGenerationPS, "/BRPlugins/Private/LensDistortion.usf", "MainPS", SF_Pixel);
+
+	/*
+	 * Displacement Cache
+	 */
+	struct FLensDistortionMapKey
+	{
+		FLensDistortionCameraModel CameraModel;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		EPixelFormat Format = PF_Unknown;
+
+		bool operator==(const FLensDistortionMapKey& Other) const
+		{
+			return CameraModel == Other.CameraModel && Size == Other.Size && Format == Other.Format;
+		}
+	};
+
+	struct FLensDistortionMapEntry
+	{
+		FLensDistortionMapKey Key;
+		TRefCountPtr<IPooledRenderTarget> DisplacementMap;
+		uint64 LastUsedFrame = 0;
+	};
+
+	/** Generated maps, released with the RHI. Render thread only */
+	class FLensDistortionMapCache : public FRenderResource
+	{
+	public:
+		/**
+		 * Copies the displacement map of the camera model to the target, generating it on a miss. The copy is never skipped,
+		 * any other path may have written the target since the last call
+		 */
+		void Apply(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, const FLensDistortionCameraModel& CameraModel);
+
+		FLensDistortionMapCacheStats GetStats() const { return Stats; }
+
+		virtual void ReleaseRHI() override
+		{
+			Maps.Empty();
+		}
+
+	private:
+		static const int32 MaxMaps = 4;
+
+		/** Least recently used is dropped first */
+		TArray<FLensDistortionMapEntry> Maps;
+
+		FLensDistortionMapCacheStats Stats;
+	};
+
+	static TGlobalResource<FLensDistortionMapCache> GLensDistortionMapCache;
+
+	/** Finer grids for larger targets keep the piecewise linear inverse within a fraction of a pixel */
+	static int32 GetGridSubdivision(int32 Size)
+	{
+		return Size >= 2048 ? 64 : (Size >= 512 ? 32 : 16);
+	}
+
+	static void AddLensDistortionPass(FRDGBuilder& GraphBuilder, FRDGTextureRef OutputTexture, const FLensDistortionCameraModel& CameraModel)
+	{
+		const FIntPoint Size = OutputTexture->Desc.Extent;
+
+		FLensDistortionUVGenerationShader::FParameters *Parameters = GraphBuilder.AllocParameters<FLensDistortionUVGenerationShader::FParameters>();
+		Parameters->PixelUVSize = FVector2f(1.0f / Size.X, 1.0f / Size.Y);
+		Parameters->RadialDistortionCoefs = CameraModel.GetRadialDistortionCoefs();
+		Parameters->TangentialDistortionCoefs = CameraModel.GetTangentialDistortionCoefs();
+		Parameters->UndistortedCameraMatrix = CameraModel.GetUndistortedCameraMatrix();
+		Parameters->DistortedCameraMatrix = CameraModel.GetDistortedCameraMatrix();
+		Parameters->OutputMultiplyAndAdd = CameraModel.GetOutputMultiplyAndAdd();
+		Parameters->RenderTargets[0] = FRenderTargetBinding(OutputTexture, ERenderTargetLoadAction::EClear);
+
+		const int32 GridSubdivisionX = GetGridSubdivision(Size.X);
+		const int32 GridSubdivisionY = GetGridSubdivision(Size.Y);
+
+		FLensDistortionUVGenerationShader::FPermutationDomain PermutationVector;
+		PermutationVector.Set<FLensDistortionUVGenerationShader::FGridSubdivisionX>(GridSubdivisionX);
+		PermutationVector.Set<FLensDistortionUVGenerationShader::FGridSubdivisionY>(GridSubdivisionY);
+
+		FGlobalShaderMap *GlobalShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+		TShaderMapRef<FLensDistortionUVGenerationVS> VertexShader(GlobalShaderMap, PermutationVector);
+		TShaderMapRef<FLensDistortionUVGenerationPS> PixelShader(GlobalShaderMap, PermutationVector);
+
+		// Two triangles per grid cell, positions come from SV_VertexID
+		const uint32 NumPrimitives = GridSubdivisionX * GridSubdivisionY * 2;
+
+		GraphBuilder.AddPass(
+			RDG_EVENT_NAME("LensDistortionUVGeneration %dx%d", Size.X, Size.Y),
+			Parameters,
+			ERDGPassFlags::Raster,
+			[Parameters, VertexShader, PixelShader, Size, NumPrimitives](FRHICommandList &RHICmdList) {
+				RHICmdList.SetViewport(0, 0, 0.0f, Size.X, Size.Y, 1.0f);
+
+				FGraphicsPipelineStateInitializer GraphicsPSOInit;
+				RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+				GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+				GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+				GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+				GraphicsPSOInit.PrimitiveType = PT_TriangleList;
+				GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GEmptyVertexDeclaration.VertexDeclarationRHI;
+
+				GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
+				GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
+				SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit, 0);
+				SetShaderParameters(RHICmdList, VertexShader, VertexShader.GetVertexShader(), *Parameters);
+				SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), *Parameters);
+
+				RHICmdList.DrawPrimitive(0, NumPrimitives, 1);
+			});
+	}
+
+	void FLensDistortionMapCache::Apply(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, const FLensDistortionCameraModel& CameraModel)
+	{
+		FLensDistortionMapKey Key;
+		Key.CameraModel = CameraModel;
+		Key.Size = RenderTargetRHI->GetSizeXY();
+		Key.Format = RenderTargetRHI->GetFormat();
+
+		FLensDistortionMapEntry* Entry = Maps.FindByPredicate([&Key](const FLensDistortionMapEntry& Map)
+		{
+			return Map.Key == Key;
+		});
+
+		if (Entry)
+		{
+			++Stats.NumHits;
+		}
+		else
+		{
+			++Stats.NumMisses;
+
+			if (Maps.Num() >= MaxMaps)
+			{
+				int32 OldestIndex = 0;
+				for (int32 Index = 1; Index < Maps.Num(); ++Index)
+				{
+					if (Maps[Index].LastUsedFrame < Maps[OldestIndex].LastUsedFrame)
+					{
+						OldestIndex = Index;
+					}
+				}
+				Maps.RemoveAtSwap(OldestIndex);
+			}
+
+			Entry = &Maps.AddDefaulted_GetRef();
+			Entry->Key = Key;
+
+			const FRDGTextureDesc& DisplacementDesc = FRDGTextureDesc::Create2D(Key.Size, Key.Format, FClearValueBinding::Black, TexCreate_RenderTargetable | TexCreate_ShaderResource);
+
+			//RDG Begin
+			FRDGBuilder GraphBuilder(RHIImmCmdList);
+			FRDGTextureRef DisplacementMap = GraphBuilder.CreateTexture(DisplacementDesc, TEXT("LensDistortionDisplacementMap"));
+			AddLensDistortionPass(GraphBuilder, DisplacementMap, CameraModel);
+			GraphBuilder.QueueTextureExtraction(DisplacementMap, &Entry->DisplacementMap);
+			GraphBuilder.Execute();
+		}
+
+		Entry->LastUsedFrame = GFrameCounterRenderThread;
+
+		//Copy Result To RenderTarget Asset
+		RHIImmCmdList.CopyTexture(Entry->DisplacementMap->GetRenderTargetItem().ShaderResourceTexture, RenderTargetRHI->GetTexture2D(), FRHICopyTextureInfo());
+	}
+
+	/*
+	 * Render Function
+	 */
+	void RDGLensDistortion(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, const FLensDistortionCameraModel& CameraModel)
+	{
+		check(IsInRenderingThread());
+
+		FlushDeferredRDGRequests(RHIImmCmdList, RenderTargetRHI);
+
+		GLensDistortionMapCache.Apply(RHIImmCmdList, RenderTargetRHI, CameraModel);
+	}
+
+	FLensDistortionMapCacheStats GetLensDistortionMapCacheStats()
+	{
+		return GLensDistortionMapCache.GetStats();
+	}
+} // namespace SimpleRenderingExample
+
+void USimpleRenderingExampleBlueprintLibrary::UseRDGLensDistortion(const UObject *WorldContextObject, UTextureRenderTarget2D *OutputRenderTarget, FLensDistortionCameraModel CameraModel)
+{
+	check(IsInGameThread());
+
+	FTexture2DRHIRef RenderTargetRHI = OutputRenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
+
+	// Requests batched earlier this frame write first, as they were made first
+	SimpleRenderingExample::FlushRDGRequests();
+
+	ENQUEUE_RENDER_COMMAND(CaptureCommand)
+	(
+		[RenderTargetRHI, CameraModel](FRHICommandListImmediate &RHICmdList) {
+			SimpleRenderingExample::RDGLensDistortion(RHICmdList, RenderTargetRHI, CameraModel);
+		});
+}
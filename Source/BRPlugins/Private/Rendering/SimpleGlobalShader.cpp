@@ -4,6 +4,18 @@
 #include "PipelineStateCache.h"
 #include "GlobalShader.h"
 #include "ShaderCompilerCore.h"
+#include "RenderGraphUtils.h"
+
+#include "SimpleRenderingCommon.h"
+
+static TAutoConsoleVariable<int32> CVarSimpleRenderingPoolIntermediates(
+	TEXT("r.SimpleRendering.PoolIntermediates"),
+	1,
+	TEXT("0: GlobalShaderCompute and GlobalShaderDraw create their texture, UAV and vertex declaration on every call.\n")
+	TEXT("1: Reuse pooled intermediate textures and the global vertex declaration (default)."),
+	ECVF_RenderThreadSafe);
+
+DECLARE_GPU_STAT_NAMED(SimpleRenderingGlobalShaderCompute, TEXT("SimpleRendering GlobalShaderCompute"));
 
 namespace SimpleRenderingExample
 {
@@ -60,6 +72,8 @@ namespace SimpleRenderingExample
 	{
 		DECLARE_GLOBAL_SHADER(FSimplePixelShader)
 	public:
+		using FPermutationDomain = TShaderPermutationDomain<FSimpleColorIndexDim>;
+
 		FSimplePixelShader(){}
 
   		FSimplePixelShader(const ShaderMetaType::CompiledShaderInitializerType& Initializer):FSimpleGlobalShader(Initializer){}
@@ -69,9 +83,32 @@ namespace SimpleRenderingExample
 	{
 		DECLARE_GLOBAL_SHADER(FSimpleComputeShader)
 
+	public:
+		/** Matches ESimpleRenderingPrecision, selects the RWTexture2D element type */
+		class FOutputFormat : SHADER_PERMUTATION_INT("OUTPUT_FORMAT", 4);
+		using FPermutationDomain = TShaderPermutationDomain<FOutputFormat, FSimpleColorIndexDim, FSimpleThreadGroupSizeDim>;
+
+		/**
+		 * Only the default 32x32 group size compiles ColorIndex in, the other sizes take the dynamic index.
+		 * That keeps the domain at 4 formats by 8 instead of 80 permutations
+		 */
+		static FPermutationDomain RemapPermutation(FPermutationDomain PermutationVector)
+		{
+			const int32 DefaultThreadGroupSizeMode = static_cast<int32>(ESimpleThreadGroupSize::Group32x32) - 1;
+			if (PermutationVector.Get<FSimpleThreadGroupSizeDim>() != DefaultThreadGroupSizeMode)
+			{
+				PermutationVector.Set<FSimpleColorIndexDim>(DynamicColorIndex);
+			}
+			return PermutationVector;
+		}
+
+	private:
+
 		static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 		{
-			return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+			const FPermutationDomain PermutationVector(Parameters.PermutationId);
+			return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5)
+				&& RemapPermutation(PermutationVector) == PermutationVector;
 		}
 
 		static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
@@ -86,32 +123,37 @@ namespace SimpleRenderingExample
 			: FGlobalShader(Initializer)
 		{
 			OutTexture.Bind(Initializer.ParameterMap, TEXT("OutTexture"));
+			DispatchOffset.Bind(Initializer.ParameterMap, TEXT("DispatchOffset"));
+			DispatchMax.Bind(Initializer.ParameterMap, TEXT("DispatchMax"));
+			OutputOffset.Bind(Initializer.ParameterMap, TEXT("OutputOffset"));
+			TargetSize.Bind(Initializer.ParameterMap, TEXT("TargetSize"));
 		}
 
-		void SetParameters(FRHICommandList& RHICmdList, FRHIUnorderedAccessView* InOutUAV, FSimpleShaderParameter UniformStruct)
+		/** Always writes the whole texture of InSize */
+		void SetParameters(FRHICommandList& RHICmdList, FRHIComputeShader* ComputeShaderRHI, FRHIUnorderedAccessView* InOutUAV, FIntPoint InSize, const TUniformBufferRef<FSimpleUniformStructParameters>& UniformBuffer)
 		{
-			FRHIComputeShader* ComputeShaderRHI = RHICmdList.GetBoundComputeShader();
 			if (OutTexture.IsBound())
 				RHICmdList.SetUAVParameter(ComputeShaderRHI, OutTexture.GetBaseIndex(), InOutUAV);
 
-			FSimpleUniformStructParameters ShaderStructData;
-			ShaderStructData.Color1 = UniformStruct.Color1;
-			ShaderStructData.Color2 = UniformStruct.Color2;
-			ShaderStructData.Color3 = UniformStruct.Color3;
-			ShaderStructData.Color4 = UniformStruct.Color4;
-			ShaderStructData.ColorIndex = UniformStruct.ColorIndex;
+			SetShaderValue(RHICmdList, ComputeShaderRHI, DispatchOffset, FIntPoint::ZeroValue);
+			SetShaderValue(RHICmdList, ComputeShaderRHI, DispatchMax, InSize);
+			SetShaderValue(RHICmdList, ComputeShaderRHI, OutputOffset, FIntPoint::ZeroValue);
+			SetShaderValue(RHICmdList, ComputeShaderRHI, TargetSize, InSize);
 
-			SetUniformBufferParameterImmediate(RHICmdList, ComputeShaderRHI, GetUniformBufferParameter<FSimpleUniformStructParameters>(), ShaderStructData);
+			SetUniformBufferParameter(RHICmdList, ComputeShaderRHI, GetUniformBufferParameter<FSimpleUniformStructParameters>(), UniformBuffer);
 		}
 
-		void UnbindBuffers(FRHICommandList& RHICmdList)
+		void UnbindBuffers(FRHICommandList& RHICmdList, FRHIComputeShader* ComputeShaderRHI)
 		{
-			FRHIComputeShader* ComputeShaderRHI = RHICmdList.GetBoundComputeShader();
 			if (OutTexture.IsBound())
 				RHICmdList.SetUAVParameter(ComputeShaderRHI, OutTexture.GetBaseIndex(), nullptr);
 		}
 	private:
 		LAYOUT_FIELD(FShaderResourceParameter, OutTexture);	
+		LAYOUT_FIELD(FShaderParameter, DispatchOffset);
+		LAYOUT_FIELD(FShaderParameter, DispatchMax);
+		LAYOUT_FIELD(FShaderParameter, OutputOffset);
+		LAYOUT_FIELD(FShaderParameter, TargetSize);
 	};
 
 	IMPLEMENT_SHADER_TYPE(, FSimpleComputeShader, TEXT("/BRPlugins/Private/SimpleComputeShader.usf"), TEXT("MainCS"), SF_Compute)
@@ -125,19 +167,58 @@ namespace SimpleRenderingExample
     {
 		check(IsInRenderingThread());
 
+		FlushDeferredRDGRequests(RHIImmCmdList, InTexRenderTargetRHIture);
+
+		SCOPED_GPU_STAT(RHIImmCmdList, SimpleRenderingGlobalShaderCompute);
+
+		const EPixelFormat IntermediateFormat = GetIntermediateFormat(InParameter.Precision);
+		SCOPED_DRAW_EVENTF(RHIImmCmdList, GlobalShaderCompute, TEXT("GlobalShaderCompute %s"), GPixelFormats[IntermediateFormat].Name);
+
+		// FP16 fallbacks of unsupported formats keep the float4 permutation
+		ESimpleRenderingPrecision Precision = InParameter.Precision;
+		if (IntermediateFormat == PF_FloatRGBA)
+		{
+			Precision = ESimpleRenderingPrecision::FP16;
+		}
+
+		FSimpleComputeShader::FPermutationDomain PermutationVector;
+		PermutationVector.Set<FSimpleComputeShader::FOutputFormat>(static_cast<int32>(Precision));
+		PermutationVector.Set<FSimpleColorIndexDim>(GetColorIndexPermutation(InParameter));
+		const int32 ThreadGroupSizeMode = GetThreadGroupSizePermutation(RHIImmCmdList, InParameter.ThreadGroupSize);
+		PermutationVector.Set<FSimpleThreadGroupSizeDim>(ThreadGroupSizeMode);
+		PermutationVector = FSimpleComputeShader::RemapPermutation(PermutationVector);
+
 		const ERHIFeatureLevel::Type FeatureLevel = GMaxRHIFeatureLevel;
-		TShaderMapRef<FSimpleComputeShader> ComputeShader(GetGlobalShaderMap(FeatureLevel));
-		RHIImmCmdList.SetComputeShader(RHIImmCmdList.GetBoundComputeShader());
-		
+		TShaderMapRef<FSimpleComputeShader> ComputeShader(GetGlobalShaderMap(FeatureLevel), PermutationVector);
+		FRHIComputeShader* ComputeShaderRHI = ComputeShader.GetComputeShader();
+		SetComputePipelineState(RHIImmCmdList, ComputeShaderRHI);
+
 		FIntPoint Size = InTexRenderTargetRHIture->GetSizeXY();
 
-		FRHIResourceCreateInfo CreateInfo(TEXT("GlobalShader_ComputeShader_UAV"));
+		FTexture2DRHIRef Texture;
+		FUnorderedAccessViewRHIRef TextureUAV;
+		if (CVarSimpleRenderingPoolIntermediates.GetValueOnRenderThread() != 0)
+		{
+			const FSimpleIntermediateTexture& Intermediate = GSimpleIntermediateTexturePool.FindOrCreate(Size, IntermediateFormat);
+			Texture = Intermediate.Texture;
+			TextureUAV = Intermediate.UAV;
+		}
+		else
+		{
+			FRHIResourceCreateInfo CreateInfo(TEXT("GlobalShader_ComputeShader_UAV"));
+			Texture = RHICreateTexture2D(Size.X, Size.Y, IntermediateFormat, 1, 1, TexCreate_ShaderResource | TexCreate_UAV, CreateInfo);
+			TextureUAV = RHICreateUnorderedAccessView(Texture);
+			INC_DWORD_STAT(STAT_SimpleRenderingTextureAllocations);
+			INC_DWORD_STAT(STAT_SimpleRenderingUAVAllocations);
+		}
 
-		FTexture2DRHIRef Texture = RHICreateTexture2D(Size.X, Size.Y, PF_A32B32G32R32F, 1, 1, TexCreate_ShaderResource | TexCreate_UAV, CreateInfo);
-		FUnorderedAccessViewRHIRef TextureUAV = RHICreateUnorderedAccessView(Texture);
-		ComputeShader->SetParameters(RHIImmCmdList, TextureUAV, InParameter);
-		DispatchComputeShader(RHIImmCmdList, ComputeShader, Size.X / 32, Size.Y / 32, 1);
-		ComputeShader->UnbindBuffers(RHIImmCmdList);
+		// A pooled texture may still be bound for reading by the previous call
+		RHIImmCmdList.Transition(FRHITransitionInfo(TextureUAV, ERHIAccess::Unknown, ERHIAccess::UAVCompute));
+		ComputeShader->SetParameters(RHIImmCmdList, ComputeShaderRHI, TextureUAV, Size, GSimpleUniformBufferCache.Get(InTexRenderTargetRHIture, InParameter));
+		const FIntVector ThreadGroupCount = FComputeShaderUtils::GetGroupCount(Size, GetThreadGroupSize(ThreadGroupSizeMode));
+		DispatchComputeShader(RHIImmCmdList, ComputeShader, ThreadGroupCount.X, ThreadGroupCount.Y, 1);
+		ComputeShader->UnbindBuffers(RHIImmCmdList, ComputeShaderRHI);
+		RHIImmCmdList.Transition(FRHITransitionInfo(Texture, ERHIAccess::UAVCompute, ERHIAccess::SRVGraphics));
 
 		GlobalShaderDraw(RHIImmCmdList, InTexRenderTargetRHIture, InParameter,FLinearColor(), Texture);
     }
@@ -146,6 +227,8 @@ namespace SimpleRenderingExample
     {
         check(IsInRenderingThread());
 
+        FlushDeferredRDGRequests(RHIImmCmdList, RenderTargetRHI);
+
 	#if WANTS_DRAW_MESH_EVENTS  
 		SCOPED_DRAW_EVENTF(RHIImmCmdList, SceneCapture, TEXT("SimplePixelShaderPassTest"));
 	#else  
@@ -160,10 +243,18 @@ namespace SimpleRenderingExample
 		const ERHIFeatureLevel::Type FeatureLevel = GMaxRHIFeatureLevel; 
 		FGlobalShaderMap* GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
 		TShaderMapRef<FSimpleVertexShader> VertexShader(GlobalShaderMap);
-		TShaderMapRef<FSimplePixelShader> PixelShader(GlobalShaderMap);
+		FSimplePixelShader::FPermutationDomain PermutationVector;
+		PermutationVector.Set<FSimpleColorIndexDim>(GetColorIndexPermutation(InParameter));
+		TShaderMapRef<FSimplePixelShader> PixelShader(GlobalShaderMap, PermutationVector);
 
-		FTextureVertexDeclaration VertexDeclaration;
-		VertexDeclaration.InitRHI();
+		FTextureVertexDeclaration LocalVertexDeclaration;
+		FRHIVertexDeclaration* VertexDeclarationRHI = GTextureVertexDeclaration.VertexDeclarationRHI;
+		if (CVarSimpleRenderingPoolIntermediates.GetValueOnRenderThread() == 0)
+		{
+			LocalVertexDeclaration.InitRHI();
+			VertexDeclarationRHI = LocalVertexDeclaration.VertexDeclarationRHI;
+			INC_DWORD_STAT(STAT_SimpleRenderingVertexDeclarationAllocations);
+		}
 
 		// Set the graphic pipeline state.
 		FGraphicsPipelineStateInitializer GraphicsPSOInit;
@@ -172,7 +263,7 @@ namespace SimpleRenderingExample
 		GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
 		GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
 		GraphicsPSOInit.PrimitiveType = PT_TriangleList;
-		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = VertexDeclaration.VertexDeclarationRHI;
+		GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = VertexDeclarationRHI;
 		GraphicsPSOInit.BoundShaderState.VertexShaderRHI = VertexShader.GetVertexShader();
 		GraphicsPSOInit.BoundShaderState.PixelShaderRHI = PixelShader.GetPixelShader();
 		SetGraphicsPipelineState(RHIImmCmdList, GraphicsPSOInit,0);
@@ -181,15 +272,8 @@ namespace SimpleRenderingExample
 		RHIImmCmdList.SetViewport(
 			0, 0, 0.f,RenderTargetRHI->GetSizeX(), RenderTargetRHI->GetSizeY(), 1.f);
 
-		// Update shader uniform parameters.
-		FSimpleUniformStructParameters Parameters;
-		Parameters.Color1 = InParameter.Color1;
-		Parameters.Color2 = InParameter.Color2;
-		Parameters.Color3 = InParameter.Color3;
-		Parameters.Color4 = InParameter.Color4;
-		Parameters.ColorIndex = InParameter.ColorIndex;
-
-		SetUniformBufferParameterImmediate(RHIImmCmdList, PixelShader.GetPixelShader(), PixelShader->GetUniformBufferParameter<FSimpleUniformStructParameters>(), Parameters);
+		// Update shader uniform parameters, only uploaded when they changed since the last call for this target.
+		SetUniformBufferParameter(RHIImmCmdList, PixelShader.GetPixelShader(), PixelShader->GetUniformBufferParameter<FSimpleUniformStructParameters>(), GSimpleUniformBufferCache.Get(RenderTargetRHI, InParameter));
 		VertexShader->SetParameters(RHIImmCmdList, VertexShader.GetVertexShader(), InColor, InTexture);
 		PixelShader->SetParameters(RHIImmCmdList, PixelShader.GetPixelShader(), InColor, InTexture);
 
@@ -212,6 +296,9 @@ void USimpleRenderingExampleBlueprintLibrary::UseGlobalShaderCompute(const UObje
 	check(IsInGameThread());
 	FTexture2DRHIRef RenderTargetRHI = OutputRenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
 
+	// Requests batched earlier this frame write first, as they were made first
+	SimpleRenderingExample::FlushRDGRequests();
+
 	ENQUEUE_RENDER_COMMAND(CaptureCommand)(
 		[RenderTargetRHI, Parameter](FRHICommandListImmediate& RHICmdList) {
 			SimpleRenderingExample::GlobalShaderCompute(RHICmdList, RenderTargetRHI, Parameter);
@@ -224,6 +311,9 @@ void USimpleRenderingExampleBlueprintLibrary::UseGlobalShaderDraw(const UObject
 	FTexture2DRHIRef RenderTargetRHI= OutputRenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
 	FTexture2DRHIRef InTextureRHI = InTexture->GetResource()->TextureRHI->GetTexture2D();
 
+	// Requests batched earlier this frame write first, as they were made first
+	SimpleRenderingExample::FlushRDGRequests();
+
 	ENQUEUE_RENDER_COMMAND(CaptureCommand)(
 		[RenderTargetRHI,Parameter,InColor,InTextureRHI](FRHICommandListImmediate& RHICmdList) {
 			SimpleRenderingExample::GlobalShaderDraw(RHICmdList, RenderTargetRHI, Parameter, InColor, InTextureRHI);
@@ -9,6 +9,51 @@
 #include "RHIStaticStates.h"
 #include "ShaderParameterUtils.h"
 #include "PixelShaderUtils.h"
+#include "Misc/CoreDelegates.h"
+#include "Async/Async.h"
+#include "SceneViewExtension.h"
+
+#include "SimpleRenderingCommon.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSimpleRendering, Log, All);
+
+static TAutoConsoleVariable<int32> CVarSimpleRenderingDirectOutput(
+	TEXT("r.SimpleRendering.DirectOutput"),
+	1,
+	TEXT("0: RDG passes render into a transient texture that is copied into the render target.\n")
+	TEXT("1: RDG passes write into the render target directly when its format and flags allow it (default)."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarSimpleRenderingBatch(
+	TEXT("r.SimpleRendering.Batch"),
+	0,
+	TEXT("0: Every UseRDGComput and UseRDGDraw call builds and executes its own render graph (default).\n")
+	TEXT("1: Calls made during a game thread frame are recorded into one render graph at the end of the frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSimpleRenderingAsyncCompute(
+	TEXT("r.SimpleRendering.AsyncCompute"),
+	0,
+	TEXT("0: RDG compute passes run on the graphics queue (default).\n")
+	TEXT("1: RDG compute passes run on the async compute queue where the RHI supports it efficiently, and fall back to the graphics queue otherwise.\n")
+	TEXT("   Blueprint calls are recorded into the scene renderer's graph of the frame, so they overlap the scene passes instead of joining right away."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarSimpleRenderingTiledThreshold(
+	TEXT("r.SimpleRendering.TiledThreshold"),
+	16384,
+	TEXT("Render targets whose width or height reaches this many pixels are rendered one tile per render graph,\n")
+	TEXT("which bounds the transient memory of the copy path. 0 disables tiling (default 16384)."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarSimpleRenderingTileSize(
+	TEXT("r.SimpleRendering.TileSize"),
+	4096,
+	TEXT("Tile size in pixels of r.SimpleRendering.TiledThreshold (default 4096)."),
+	ECVF_RenderThreadSafe);
+
+DECLARE_GPU_STAT_NAMED(SimpleRenderingRDGCompute, TEXT("SimpleRendering RDGCompute"));
+DECLARE_GPU_STAT_NAMED(SimpleRenderingRDGDraw, TEXT("SimpleRendering RDGDraw"));
 
 namespace SimpleRenderingExample
 {
@@ -28,9 +73,15 @@ namespace SimpleRenderingExample
 		DECLARE_GLOBAL_SHADER(FSimpleRDGComputeShader);
 		SHADER_USE_PARAMETER_STRUCT(FSimpleRDGComputeShader, FGlobalShader);
 
+		using FPermutationDomain = TShaderPermutationDomain<FSimpleColorIndexDim, FSimpleThreadGroupSizeDim>;
+
 		BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 		SHADER_PARAMETER_STRUCT_REF(FSimpleUniformStructParameters, SimpleUniformStruct)
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutTexture)
+		SHADER_PARAMETER(FIntPoint, DispatchOffset)
+		SHADER_PARAMETER(FIntPoint, DispatchMax)
+		SHADER_PARAMETER(FIntPoint, OutputOffset)
+		SHADER_PARAMETER(FIntPoint, TargetSize)
 		END_SHADER_PARAMETER_STRUCT()
 
 		static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters &Parameters)
@@ -73,6 +124,8 @@ namespace SimpleRenderingExample
 	public:
 		DECLARE_GLOBAL_SHADER(FSimpleRDGPixelShader);
 
+		using FPermutationDomain = TShaderPermutationDomain<FSimpleColorIndexDim>;
+
 		FSimpleRDGPixelShader() {}
 
 		FSimpleRDGPixelShader(const ShaderMetaType::CompiledShaderInitializerType &Initializer) : FSimpleRDGGlobalShader(Initializer) {}
@@ -85,106 +138,490 @@ namespace SimpleRenderingExample
 	IMPLEMENT_GLOBAL_SHADER(FSimpleRDGPixelShader, "/BRPlugins/Private/SimplePixelShader.usf", "MainPS", SF_Pixel);
 
 	/*
-	 * Render Function 
+	 * Output Target
 	 */
-	void RDGCompute(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter)
+
+	/**
+	 * Whether a pass can write the target itself instead of a transient copy. sRGB targets always take the copy path,
+	 * hardware encoding on write would change the values compared to the raw copy. So do UAV writes to formats the RHI can not store typed
+	 */
+	static bool CanWriteDirectly(FRHITexture* RenderTargetRHI, ETextureCreateFlags RequiredFlags)
 	{
-		check(IsInRenderingThread());
+		const ETextureCreateFlags Flags = RenderTargetRHI->GetFlags();
+		const EPixelFormat Format = RenderTargetRHI->GetFormat();
+		return CVarSimpleRenderingDirectOutput.GetValueOnRenderThread() != 0
+			&& GPixelFormats[Format].Supported
+			&& EnumHasAllFlags(Flags, RequiredFlags)
+			&& !EnumHasAnyFlags(Flags, TexCreate_SRGB)
+			&& (!EnumHasAnyFlags(RequiredFlags, TexCreate_UAV) || RHIIsTypedUAVStoreSupported(Format));
+	}
 
-		//Create RenderTargetDesc
-		const FRDGTextureDesc& RenderTargetDesc = FRDGTextureDesc::Create2D(RenderTargetRHI->GetSizeXY(),RenderTargetRHI->GetFormat(), FClearValueBinding::Black, TexCreate_RenderTargetable | TexCreate_ShaderResource | TexCreate_UAV);
-		
-		TRefCountPtr<IPooledRenderTarget> PooledRenderTarget;
+	/** Registers the target, leaving it readable by materials and UMG at the end of the graph */
+	static FRDGTextureRef RegisterOutputTexture(FRDGBuilder& GraphBuilder, FTexture2DRHIRef RenderTargetRHI)
+	{
+		FRDGTextureRef RDGOutput = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(RenderTargetRHI, TEXT("RDGRenderTarget")));
+		GraphBuilder.SetTextureAccessFinal(RDGOutput, ERHIAccess::SRVMask);
+		return RDGOutput;
+	}
 
-		//RDG Begin
-		FRDGBuilder GraphBuilder(RHIImmCmdList);
-		FRDGTextureRef RDGRenderTarget = GraphBuilder.CreateTexture(RenderTargetDesc, TEXT("RDGRenderTarget"));
+	/** Transient texture in the format of the target for the copy path, sized to the region it holds */
+	static FRDGTextureRef CreateTransientOutputTexture(FRDGBuilder& GraphBuilder, FTexture2DRHIRef RenderTargetRHI, FIntPoint Extent)
+	{
+		const FRDGTextureDesc& RenderTargetDesc = FRDGTextureDesc::Create2D(Extent, RenderTargetRHI->GetFormat(), FClearValueBinding::Black, TexCreate_RenderTargetable | TexCreate_ShaderResource | TexCreate_UAV);
+		return GraphBuilder.CreateTexture(RenderTargetDesc, TEXT("RDGRenderTarget"));
+	}
 
-		//Setup Parameters
-		FSimpleUniformStructParameters StructParameters;
-		StructParameters.Color1 = InParameter.Color1;
-		StructParameters.Color2 = InParameter.Color2;
-		StructParameters.Color3 = InParameter.Color3;
-		StructParameters.Color4 = InParameter.Color4;
-		StructParameters.ColorIndex = InParameter.ColorIndex;
+	/*
+	 * Regions
+	 */
 
-		FSimpleRDGComputeShader::FParameters *Parameters = GraphBuilder.AllocParameters<FSimpleRDGComputeShader::FParameters>();
-		FRDGTextureUAVDesc UAVDesc(RDGRenderTarget);
-		Parameters->SimpleUniformStruct = TUniformBufferRef<FSimpleUniformStructParameters>::CreateUniformBufferImmediate(StructParameters, UniformBuffer_SingleFrame);
-		Parameters->OutTexture = GraphBuilder.CreateUAV(UAVDesc);
+	/** Dirty rects clipped to the target, or the whole target when there are none */
+	static void GetRegions(FIntPoint TargetSize, TArrayView<const FIntRect> DirtyRects, TArray<FIntRect>& OutRegions)
+	{
+		const FIntRect Bounds(FIntPoint::ZeroValue, TargetSize);
+		if (DirtyRects.Num() == 0)
+		{
+			OutRegions.Add(Bounds);
+			return;
+		}
 
-		//Get ComputeShader From GlobalShaderMap
-		const ERHIFeatureLevel::Type FeatureLevel = GMaxRHIFeatureLevel; //ERHIFeatureLevel::SM5
-		FGlobalShaderMap *GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
-		TShaderMapRef<FSimpleRDGComputeShader> ComputeShader(GlobalShaderMap);
+		for (FIntRect Rect : DirtyRects)
+		{
+			Rect.Clip(Bounds);
+			if (Rect.Area() > 0)
+			{
+				OutRegions.Add(Rect);
+			}
+		}
+	}
 
-		//Compute Thread Group Count
-		FIntVector ThreadGroupCount(
-			RenderTargetRHI->GetSizeX() / 32,
-			RenderTargetRHI->GetSizeY() / 32,
-			1);
+	static bool ShouldRenderTiled(FIntPoint TargetSize)
+	{
+		const int32 Threshold = CVarSimpleRenderingTiledThreshold.GetValueOnRenderThread();
+		return Threshold > 0 && FMath::Max(TargetSize.X, TargetSize.Y) >= Threshold;
+	}
 
-		//ValidateShaderParameters(PixelShader, Parameters);
-		//ClearUnusedGraphResources(PixelShader, Parameters);
+	/** Splits the regions at tile borders, one list per tile that has anything to update */
+	static void GetTiles(FIntPoint TargetSize, TArrayView<const FIntRect> DirtyRects, TArray<TArray<FIntRect>>& OutTiles)
+	{
+		TArray<FIntRect> Regions;
+		GetRegions(TargetSize, DirtyRects, Regions);
 
-		GraphBuilder.AddPass(
-			RDG_EVENT_NAME("RDGCompute"),
-			Parameters,
-			ERDGPassFlags::Compute,
-			[Parameters, ComputeShader, ThreadGroupCount](FRHICommandList &RHICmdList) {
-				FComputeShaderUtils::Dispatch(RHICmdList, ComputeShader, *Parameters, ThreadGroupCount);
-			});
+		const int32 TileSize = FMath::Max(CVarSimpleRenderingTileSize.GetValueOnRenderThread(), 64);
+		for (int32 TileY = 0; TileY < TargetSize.Y; TileY += TileSize)
+		{
+			for (int32 TileX = 0; TileX < TargetSize.X; TileX += TileSize)
+			{
+				const FIntRect Tile(TileX, TileY, FMath::Min(TileX + TileSize, TargetSize.X), FMath::Min(TileY + TileSize, TargetSize.Y));
+				TArray<FIntRect> TileRegions;
+				for (FIntRect Region : Regions)
+				{
+					Region.Clip(Tile);
+					if (Region.Area() > 0)
+					{
+						TileRegions.Add(Region);
+					}
+				}
+				if (TileRegions.Num() > 0)
+				{
+					OutTiles.Add(MoveTemp(TileRegions));
+				}
+			}
+		}
+	}
 
-		GraphBuilder.QueueTextureExtraction(RDGRenderTarget, &PooledRenderTarget);
+	/*
+	 * Thread Group Size
+	 */
+
+	/** Benchmark winner of this process, INDEX_NONE until the first Auto request */
+	static int32 GAutoThreadGroupSizeMode = INDEX_NONE;
+
+	static const TCHAR* ThreadGroupSizeConfigSection = TEXT("SimpleRenderingExample.ThreadGroupSize");
+
+	static FString GetThreadGroupSizeConfigKey()
+	{
+		FString Key = FString::Printf(TEXT("%s_%s"), *GRHIAdapterName, *GRHIAdapterUserDriverVersion);
+		// Config keys can not hold spaces or separators
+		for (TCHAR& Character : Key)
+		{
+			if (!FChar::IsAlnum(Character))
+			{
+				Character = TEXT('_');
+			}
+		}
+		return Key;
+	}
+
+	/** Times each thread group size on a 2048x2048 dispatch of MainCS and returns the fastest, waits for the GPU */
+	static int32 BenchmarkThreadGroupSizes(FRHICommandListImmediate& RHIImmCmdList)
+	{
+		const int32 NumModes = FSimpleThreadGroupSizeDim::PermutationCount;
+		const int32 NumRepeats = 4;
+		const FIntPoint BenchmarkSize(2048, 2048);
+
+		TArray<FRenderQueryRHIRef> Queries;
+		for (int32 QueryIndex = 0; QueryIndex < NumModes * 2; ++QueryIndex)
+		{
+			Queries.Add(RHICreateRenderQuery(RQT_AbsoluteTime));
+		}
+
+		FSimpleUniformStructParameters StructParameters;
+		StructParameters.Color1 = FVector4f(1.0f, 1.0f, 1.0f, 1.0f);
+		StructParameters.Color2 = StructParameters.Color1;
+		StructParameters.Color3 = StructParameters.Color1;
+		StructParameters.Color4 = StructParameters.Color1;
+		StructParameters.ColorIndex = 0;
+		TUniformBufferRef<FSimpleUniformStructParameters> UniformBuffer = TUniformBufferRef<FSimpleUniformStructParameters>::CreateUniformBufferImmediate(StructParameters, UniformBuffer_SingleFrame);
+
+		FRDGBuilder GraphBuilder(RHIImmCmdList);
+		FRDGTextureRef BenchmarkTexture = GraphBuilder.CreateTexture(
+			FRDGTextureDesc::Create2D(BenchmarkSize, PF_FloatRGBA, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV), TEXT("ThreadGroupSizeBenchmark"));
+		FRDGTextureUAVRef BenchmarkUAV = GraphBuilder.CreateUAV(FRDGTextureUAVDesc(BenchmarkTexture));
+
+		FGlobalShaderMap *GlobalShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+		for (int32 Mode = 0; Mode < NumModes; ++Mode)
+		{
+			FSimpleRDGComputeShader::FPermutationDomain PermutationVector;
+			PermutationVector.Set<FSimpleColorIndexDim>(0);
+			PermutationVector.Set<FSimpleThreadGroupSizeDim>(Mode);
+			TShaderMapRef<FSimpleRDGComputeShader> ComputeShader(GlobalShaderMap, PermutationVector);
+
+			FSimpleRDGComputeShader::FParameters *Parameters = GraphBuilder.AllocParameters<FSimpleRDGComputeShader::FParameters>();
+			Parameters->SimpleUniformStruct = UniformBuffer;
+			Parameters->OutTexture = BenchmarkUAV;
+			Parameters->DispatchOffset = FIntPoint::ZeroValue;
+			Parameters->DispatchMax = BenchmarkSize;
+			Parameters->OutputOffset = FIntPoint::ZeroValue;
+			Parameters->TargetSize = BenchmarkSize;
+
+			const FIntVector ThreadGroupCount = FComputeShaderUtils::GetGroupCount(BenchmarkSize, GetThreadGroupSize(Mode));
+			FRHIRenderQuery* BeginQuery = Queries[Mode * 2];
+			FRHIRenderQuery* EndQuery = Queries[Mode * 2 + 1];
+
+			GraphBuilder.AddPass(
+				RDG_EVENT_NAME("ThreadGroupSizeBenchmark %d", Mode),
+				Parameters,
+				ERDGPassFlags::Compute | ERDGPassFlags::NeverCull,
+				[Parameters, ComputeShader, ThreadGroupCount, BeginQuery, EndQuery, NumRepeats](FRHICommandList &RHICmdList) {
+					// Warm up outside the timed range so pipeline creation is not measured
+					FComputeShaderUtils::Dispatch(RHICmdList, ComputeShader, *Parameters, ThreadGroupCount);
+					RHICmdList.EndRenderQuery(BeginQuery);
+					for (int32 Repeat = 0; Repeat < NumRepeats; ++Repeat)
+					{
+						FComputeShaderUtils::Dispatch(RHICmdList, ComputeShader, *Parameters, ThreadGroupCount);
+					}
+					RHICmdList.EndRenderQuery(EndQuery);
+				});
+		}
 		GraphBuilder.Execute();
 
-		//Copy Result To RenderTarget Asset
-		RHIImmCmdList.CopyTexture(PooledRenderTarget->GetRenderTargetItem().ShaderResourceTexture, RenderTargetRHI->GetTexture2D(), FRHICopyTextureInfo());
-		//RHIImmCmdList.CopyToResolveTarget(PooledRenderTarget->GetRenderTargetItem().ShaderResourceTexture, RenderTargetRHI->GetTexture2D(), FResolveParams());
+		RHIImmCmdList.ImmediateFlush(EImmediateFlushType::FlushRHIThread);
+
+		// One wait for the last timestamp, every earlier one has landed by then
+		int32 BestMode = 2;
+		uint64 LastTime = 0;
+		if (!RHIGetRenderQueryResult(Queries.Last(), LastTime, true))
+		{
+			return BestMode;
+		}
+
+		uint64 BestTime = MAX_uint64;
+		for (int32 Mode = 0; Mode < NumModes; ++Mode)
+		{
+			uint64 BeginTime = 0;
+			uint64 EndTime = 0;
+			if (RHIGetRenderQueryResult(Queries[Mode * 2], BeginTime, false) && RHIGetRenderQueryResult(Queries[Mode * 2 + 1], EndTime, false) && EndTime >= BeginTime)
+			{
+				UE_LOG(LogSimpleRendering, Log, TEXT("SimpleRendering thread group %dx%d: %llu us"), GetThreadGroupSize(Mode).X, GetThreadGroupSize(Mode).Y, (EndTime - BeginTime) / NumRepeats);
+				if (EndTime - BeginTime < BestTime)
+				{
+					BestTime = EndTime - BeginTime;
+					BestMode = Mode;
+				}
+			}
+		}
+		return BestMode;
 	}
 
-	void RDGDraw(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter, const FLinearColor InColor, FTexture2DRHIRef InTexture)
+	int32 GetThreadGroupSizePermutation(FRHICommandListImmediate& RHIImmCmdList, ESimpleThreadGroupSize ThreadGroupSize)
 	{
 		check(IsInRenderingThread());
 
-		//Create PooledRenderTarget
-		const FRDGTextureDesc& RenderTargetDesc = FRDGTextureDesc::Create2D(RenderTargetRHI->GetSizeXY(), RenderTargetRHI->GetFormat(), FClearValueBinding::Black,  TexCreate_RenderTargetable | TexCreate_ShaderResource | TexCreate_UAV);
-		TRefCountPtr<IPooledRenderTarget> PooledRenderTarget;
+		if (ThreadGroupSize != ESimpleThreadGroupSize::Auto)
+		{
+			return static_cast<int32>(ThreadGroupSize) - 1;
+		}
 
-		//RDG Begin
-		FRDGBuilder GraphBuilder(RHIImmCmdList);
-		FRDGTextureRef RDGRenderTarget = GraphBuilder.CreateTexture(RenderTargetDesc, TEXT("RDGRenderTarget"));
+		if (GAutoThreadGroupSizeMode == INDEX_NONE)
+		{
+			const FString ConfigKey = GetThreadGroupSizeConfigKey();
+			int32 CachedMode = INDEX_NONE;
+			if (GConfig->GetInt(ThreadGroupSizeConfigSection, *ConfigKey, CachedMode, GEngineIni) && CachedMode >= 0 && CachedMode < FSimpleThreadGroupSizeDim::PermutationCount)
+			{
+				GAutoThreadGroupSizeMode = CachedMode;
+			}
+			else
+			{
+				// The render thread keeps using the winner from memory, only the game thread writes the config
+				GAutoThreadGroupSizeMode = BenchmarkThreadGroupSizes(RHIImmCmdList);
+				AsyncTask(ENamedThreads::GameThread, [ConfigKey, Mode = GAutoThreadGroupSizeMode]()
+				{
+					GConfig->SetInt(ThreadGroupSizeConfigSection, *ConfigKey, Mode, GEngineIni);
+					GConfig->Flush(false, GEngineIni);
+				});
+			}
+		}
+		return GAutoThreadGroupSizeMode;
+	}
 
-		//Setup Parameters
-		FSimpleUniformStructParameters StructParameters;
-		StructParameters.Color1 = InParameter.Color1;
-		StructParameters.Color2 = InParameter.Color2;
-		StructParameters.Color3 = InParameter.Color3;
-		StructParameters.Color4 = InParameter.Color4;
-		StructParameters.ColorIndex = InParameter.ColorIndex;
-
-		FSimpleRDGPixelShader::FParameters *Parameters = GraphBuilder.AllocParameters<FSimpleRDGPixelShader::FParameters>();
-		Parameters->TextureVal = InTexture;
-		Parameters->TextureSampler = TStaticSamplerState<SF_Trilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
-		Parameters->SimpleColor = InColor;
-		Parameters->SimpleUniformStruct = TUniformBufferRef<FSimpleUniformStructParameters>::CreateUniformBufferImmediate(StructParameters, UniformBuffer_SingleFrame);
-		Parameters->RenderTargets[0] = FRenderTargetBinding(RDGRenderTarget, ERenderTargetLoadAction::ENoAction);
+	/** Permutation of a size that needs no benchmark, or of Auto once GetThreadGroupSizePermutation resolved it. Safe while a graph is open */
+	static int32 GetResolvedThreadGroupSizePermutation(ESimpleThreadGroupSize ThreadGroupSize)
+	{
+		if (ThreadGroupSize != ESimpleThreadGroupSize::Auto)
+		{
+			return static_cast<int32>(ThreadGroupSize) - 1;
+		}
+
+		checkf(GAutoThreadGroupSizeMode != INDEX_NONE, TEXT("Auto thread group size has to be resolved before the graph is opened, its benchmark executes a graph of its own"));
+		return GAutoThreadGroupSizeMode;
+	}
 
+	/*
+	 * Passes
+	 */
+
+	static bool UseAsyncCompute()
+	{
+		return CVarSimpleRenderingAsyncCompute.GetValueOnRenderThread() != 0 && GSupportsEfficientAsyncCompute;
+	}
+
+	/** Timestamps written around the dispatch of one async pass, or on the graphics pipe around the scene graph that recorded it */
+	struct FAsyncComputeTiming
+	{
+		FRenderQueryRHIRef BeginQuery;
+		FRenderQueryRHIRef EndQuery;
+		uint64 Frame = 0;
+		bool bGraphicsSpan = false;
+
+		/** The graphics span is the one of a scene renderer's graph */
+		bool bSceneGraph = false;
+	};
+
+	/** Frames after which unresolved timestamps are dropped, their pass was culled or never ran */
+	static const uint64 AsyncComputeTimingLifetimeFrames = 30;
+
+	/** Issued timestamps that were not read back yet. Render thread only */
+	static TArray<FAsyncComputeTiming> GPendingAsyncComputeTimings;
+
+	static FCriticalSection GAsyncComputeTimeLock;
+	static FSimpleAsyncComputeTimings GAsyncComputeTimings;
+
+	static FAsyncComputeTiming& AddAsyncComputeTiming(bool bGraphicsSpan)
+	{
+		FAsyncComputeTiming& Timing = GPendingAsyncComputeTimings.AddDefaulted_GetRef();
+		Timing.BeginQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+		Timing.EndQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+		Timing.Frame = GFrameCounterRenderThread;
+		Timing.bGraphicsSpan = bGraphicsSpan;
+		return Timing;
+	}
+
+	/**
+	 * Reads back the finished timestamps without waiting, called at the end of every render thread frame.
+	 * A frame is published once all of its timestamps landed, the latest one wins
+	 */
+	static void ResolveAsyncComputeTimings()
+	{
+		check(IsInRenderingThread());
+
+		struct FFrameTiming
+		{
+			bool bComplete = true;
+			int32 NumPasses = 0;
+			uint64 ComputeMicroseconds = 0;
+			uint64 Begin = MAX_uint64;
+			uint64 End = 0;
+			uint64 GraphicsBegin = 0;
+			uint64 GraphicsEnd = 0;
+			bool bGraphicsSpan = false;
+			bool bSceneGraph = false;
+		};
+
+		TMap<uint64, FFrameTiming> Frames;
+		for (const FAsyncComputeTiming& Timing : GPendingAsyncComputeTimings)
+		{
+			FFrameTiming& Frame = Frames.FindOrAdd(Timing.Frame);
+			uint64 BeginTime = 0;
+			uint64 EndTime = 0;
+			if (!RHIGetRenderQueryResult(Timing.BeginQuery, BeginTime, false) || !RHIGetRenderQueryResult(Timing.EndQuery, EndTime, false))
+			{
+				Frame.bComplete = false;
+				continue;
+			}
+
+			EndTime = FMath::Max(EndTime, BeginTime);
+			Frame.Begin = FMath::Min(Frame.Begin, BeginTime);
+			Frame.End = FMath::Max(Frame.End, EndTime);
+			if (Timing.bGraphicsSpan)
+			{
+				// The scene graph's span is the one the passes overlap, it wins over flushed graphs of the same frame
+				if (Timing.bSceneGraph || !Frame.bSceneGraph)
+				{
+					Frame.GraphicsBegin = BeginTime;
+					Frame.GraphicsEnd = EndTime;
+				}
+				Frame.bGraphicsSpan = true;
+				Frame.bSceneGraph |= Timing.bSceneGraph;
+			}
+			else
+			{
+				Frame.ComputeMicroseconds += EndTime - BeginTime;
+				++Frame.NumPasses;
+			}
+		}
+
+		uint64 PublishedFrame = 0;
+		FSimpleAsyncComputeTimings Published;
+		for (const TPair<uint64, FFrameTiming>& Frame : Frames)
+		{
+			if (Frame.Value.bComplete && Frame.Value.NumPasses > 0 && Frame.Key >= PublishedFrame)
+			{
+				PublishedFrame = Frame.Key;
+				Published.Frame = Frame.Key;
+				Published.ComputeMilliseconds = Frame.Value.ComputeMicroseconds / 1000.0f;
+				Published.GraphicsMilliseconds = Frame.Value.bGraphicsSpan ? (Frame.Value.GraphicsEnd - Frame.Value.GraphicsBegin) / 1000.0f : 0.0f;
+				Published.TotalMilliseconds = Frame.Value.bGraphicsSpan ? (Frame.Value.End - Frame.Value.Begin) / 1000.0f : 0.0f;
+				Published.bSceneGraph = Frame.Value.bSceneGraph;
+			}
+		}
+
+		GPendingAsyncComputeTimings.RemoveAllSwap([&Frames](const FAsyncComputeTiming& Timing)
+		{
+			return Frames.FindChecked(Timing.Frame).bComplete || Timing.Frame + AsyncComputeTimingLifetimeFrames < GFrameCounterRenderThread;
+		});
+
+		if (PublishedFrame > 0)
+		{
+			SET_FLOAT_STAT(STAT_SimpleRenderingAsyncComputeTime, Published.ComputeMilliseconds);
+			SET_FLOAT_STAT(STAT_SimpleRenderingAsyncComputeGraphicsTime, Published.GraphicsMilliseconds);
+			SET_FLOAT_STAT(STAT_SimpleRenderingAsyncComputeTotalTime, Published.TotalMilliseconds);
+			UE_LOG(LogSimpleRendering, Verbose, TEXT("SimpleRendering async compute: %.3f ms on the compute pipe, %.3f ms on the graphics pipe, %.3f ms from first to last timestamp"),
+				Published.ComputeMilliseconds, Published.GraphicsMilliseconds, Published.TotalMilliseconds);
+
+			FScopeLock Lock(&GAsyncComputeTimeLock);
+			GAsyncComputeTimings = Published;
+		}
+	}
+
+	FSimpleAsyncComputeTimings GetAsyncComputeTimings()
+	{
+		FScopeLock Lock(&GAsyncComputeTimeLock);
+		return GAsyncComputeTimings;
+	}
+
+	/** Copies a region rendered into a transient texture of its own size to its place in the render target */
+	static void AddOutputCopyPass(FRDGBuilder& GraphBuilder, FRDGTextureRef RDGRenderTarget, FRDGTextureRef RDGOutput, FIntPoint DestPosition)
+	{
+		FRHICopyTextureInfo CopyInfo;
+		CopyInfo.Size = FIntVector(RDGRenderTarget->Desc.Extent.X, RDGRenderTarget->Desc.Extent.Y, 1);
+		CopyInfo.DestPosition = FIntVector(DestPosition.X, DestPosition.Y, 0);
+		AddCopyTexturePass(GraphBuilder, RDGRenderTarget, RDGOutput, CopyInfo);
+	}
+
+	void AddRDGComputePass(FRDGBuilder& GraphBuilder, FTexture2DRHIRef RenderTargetRHI, const FSimpleShaderParameter& InParameter, TArrayView<const FIntRect> DirtyRects)
+	{
+		const FIntPoint TargetSize = RenderTargetRHI->GetSizeXY();
+		TArray<FIntRect> Regions;
+		GetRegions(TargetSize, DirtyRects, Regions);
+		if (Regions.Num() == 0)
+		{
+			return;
+		}
+
+		const bool bDirectOutput = CanWriteDirectly(RenderTargetRHI, TexCreate_UAV);
+		FRDGTextureRef RDGOutput = RegisterOutputTexture(GraphBuilder, RenderTargetRHI);
+		TUniformBufferRef<FSimpleUniformStructParameters> UniformBuffer = GSimpleUniformBufferCache.Get(RenderTargetRHI, InParameter);
+
+		//Get ComputeShader From GlobalShaderMap
 		const ERHIFeatureLevel::Type FeatureLevel = GMaxRHIFeatureLevel; //ERHIFeatureLevel::SM5
 		FGlobalShaderMap *GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
-		TShaderMapRef<FSimpleRDGVertexShader> VertexShader(GlobalShaderMap);
-		TShaderMapRef<FSimpleRDGPixelShader> PixelShader(GlobalShaderMap);
+		const int32 ThreadGroupSizeMode = GetResolvedThreadGroupSizePermutation(InParameter.ThreadGroupSize);
+		FSimpleRDGComputeShader::FPermutationDomain PermutationVector;
+		PermutationVector.Set<FSimpleColorIndexDim>(GetColorIndexPermutation(InParameter));
+		PermutationVector.Set<FSimpleThreadGroupSizeDim>(ThreadGroupSizeMode);
+		TShaderMapRef<FSimpleRDGComputeShader> ComputeShader(GlobalShaderMap, PermutationVector);
 
-		//ValidateShaderParameters(PixelShader, Parameters);
-		//ClearUnusedGraphResources(PixelShader, Parameters);
+		// RDG forks to the async queue before the pass and joins on the first graphics use of the target,
+		// which is the copy pass or the final SRV transition at the end of the graph the pass was recorded into
+		const bool bAsyncCompute = UseAsyncCompute();
+
+		RDG_GPU_STAT_SCOPE(GraphBuilder, SimpleRenderingRDGCompute);
+		for (const FIntRect& Region : Regions)
+		{
+			// The copy path renders each region into a texture of its own size, so a small dirty rect costs a small texture and copy
+			FRDGTextureRef RDGRenderTarget = bDirectOutput ? RDGOutput : CreateTransientOutputTexture(GraphBuilder, RenderTargetRHI, Region.Size());
 
+			//Setup Parameters
+			FSimpleRDGComputeShader::FParameters *Parameters = GraphBuilder.AllocParameters<FSimpleRDGComputeShader::FParameters>();
+			FRDGTextureUAVDesc UAVDesc(RDGRenderTarget);
+			Parameters->SimpleUniformStruct = UniformBuffer;
+			Parameters->OutTexture = GraphBuilder.CreateUAV(UAVDesc);
+			Parameters->DispatchOffset = Region.Min;
+			Parameters->DispatchMax = Region.Max;
+			Parameters->OutputOffset = bDirectOutput ? FIntPoint::ZeroValue : Region.Min;
+			Parameters->TargetSize = TargetSize;
+
+			//Compute Thread Group Count of the region, rounded up so the edges are covered
+			const FIntVector ThreadGroupCount = FComputeShaderUtils::GetGroupCount(Region.Size(), GetThreadGroupSize(ThreadGroupSizeMode));
+
+			//ValidateShaderParameters(PixelShader, Parameters);
+			//ClearUnusedGraphResources(PixelShader, Parameters);
+
+			// The GPU stats only time the graphics pipe, async passes are timed with timestamps of their own
+			FRHIRenderQuery* BeginQuery = nullptr;
+			FRHIRenderQuery* EndQuery = nullptr;
+			if (bAsyncCompute)
+			{
+				const FAsyncComputeTiming& Timing = AddAsyncComputeTiming(false);
+				BeginQuery = Timing.BeginQuery;
+				EndQuery = Timing.EndQuery;
+			}
+
+			GraphBuilder.AddPass(
+				RDG_EVENT_NAME("RDGCompute%s %dx%d", bAsyncCompute ? TEXT(" (Async)") : TEXT(""), Region.Width(), Region.Height()),
+				Parameters,
+				bAsyncCompute ? ERDGPassFlags::AsyncCompute : ERDGPassFlags::Compute,
+				[Parameters, ComputeShader, ThreadGroupCount, BeginQuery, EndQuery](FRHIComputeCommandList &RHICmdList) {
+					if (BeginQuery)
+					{
+						RHICmdList.EndRenderQuery(BeginQuery);
+					}
+					FComputeShaderUtils::Dispatch(RHICmdList, ComputeShader, *Parameters, ThreadGroupCount);
+					if (EndQuery)
+					{
+						RHICmdList.EndRenderQuery(EndQuery);
+					}
+				});
+
+			//Copy Result To RenderTarget Asset
+			if (!bDirectOutput)
+			{
+				AddOutputCopyPass(GraphBuilder, RDGRenderTarget, RDGOutput, Region.Min);
+			}
+		}
+	}
+
+	/** Draws the full screen quad mapped to Viewport once per scissor rect */
+	static void AddQuadPass(FRDGBuilder& GraphBuilder, FSimpleRDGPixelShader::FParameters* Parameters, TShaderMapRef<FSimpleRDGVertexShader> VertexShader,
+		TShaderMapRef<FSimpleRDGPixelShader> PixelShader, FIntRect Viewport, TArray<FIntRect>&& ScissorRects)
+	{
 		GraphBuilder.AddPass(
-			RDG_EVENT_NAME("RDGDraw"),
+			RDG_EVENT_NAME("RDGDraw %dx%d", Viewport.Width(), Viewport.Height()),
 			Parameters,
 			ERDGPassFlags::Raster,
-			[Parameters, VertexShader, PixelShader, GlobalShaderMap](FRHICommandList &RHICmdList) {
-				FRHITexture2D *RT = Parameters->RenderTargets[0].GetTexture()->GetRHI()->GetTexture2D();
-				RHICmdList.SetViewport(0, 0, 0.0f, RT->GetSizeX(), RT->GetSizeY(), 1.0f);
+			[Parameters, VertexShader, PixelShader, Viewport, ScissorRects = MoveTemp(ScissorRects)](FRHICommandList &RHICmdList) {
+				RHICmdList.SetViewport(Viewport.Min.X, Viewport.Min.Y, 0.0f, Viewport.Max.X, Viewport.Max.Y, 1.0f);
 
 				FGraphicsPipelineStateInitializer GraphicsPSOInit;
 				RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
@@ -201,47 +638,532 @@ namespace SimpleRenderingExample
 				SetShaderParameters(RHICmdList, PixelShader, PixelShader.GetPixelShader(), *Parameters);
 
 				RHICmdList.SetStreamSource(0, GRectangleVertexBuffer.VertexBufferRHI, 0);
-				RHICmdList.DrawIndexedPrimitive(
-					GRectangleIndexBuffer.IndexBufferRHI,
-					/*BaseVertexIndex=*/0,
-					/*MinIndex=*/0,
-					/*NumVertices=*/4,
-					/*StartIndex=*/0,
-					/*NumPrimitives=*/2,
-					/*NumInstances=*/1);
+				for (const FIntRect& ScissorRect : ScissorRects)
+				{
+					RHICmdList.SetScissorRect(true, ScissorRect.Min.X, ScissorRect.Min.Y, ScissorRect.Max.X, ScissorRect.Max.Y);
+					RHICmdList.DrawIndexedPrimitive(
+						GRectangleIndexBuffer.IndexBufferRHI,
+						/*BaseVertexIndex=*/0,
+						/*MinIndex=*/0,
+						/*NumVertices=*/4,
+						/*StartIndex=*/0,
+						/*NumPrimitives=*/2,
+						/*NumInstances=*/1);
+				}
+				RHICmdList.SetScissorRect(false, 0, 0, 0, 0);
 			});
+	}
+
+	void AddRDGDrawPass(FRDGBuilder& GraphBuilder, FTexture2DRHIRef RenderTargetRHI, const FSimpleShaderParameter& InParameter, const FLinearColor InColor, FTexture2DRHIRef InTexture, TArrayView<const FIntRect> DirtyRects)
+	{
+		const FIntPoint TargetSize = RenderTargetRHI->GetSizeXY();
+		TArray<FIntRect> Regions;
+		GetRegions(TargetSize, DirtyRects, Regions);
+		if (Regions.Num() == 0)
+		{
+			return;
+		}
+
+		const bool bDirectOutput = CanWriteDirectly(RenderTargetRHI, TexCreate_RenderTargetable);
+		FRDGTextureRef RDGOutput = RegisterOutputTexture(GraphBuilder, RenderTargetRHI);
+		TUniformBufferRef<FSimpleUniformStructParameters> UniformBuffer = GSimpleUniformBufferCache.Get(RenderTargetRHI, InParameter);
+
+		const ERHIFeatureLevel::Type FeatureLevel = GMaxRHIFeatureLevel; //ERHIFeatureLevel::SM5
+		FGlobalShaderMap *GlobalShaderMap = GetGlobalShaderMap(FeatureLevel);
+		TShaderMapRef<FSimpleRDGVertexShader> VertexShader(GlobalShaderMap);
+		FSimpleRDGPixelShader::FPermutationDomain PermutationVector;
+		PermutationVector.Set<FSimpleColorIndexDim>(GetColorIndexPermutation(InParameter));
+		TShaderMapRef<FSimpleRDGPixelShader> PixelShader(GlobalShaderMap, PermutationVector);
+
+		//ValidateShaderParameters(PixelShader, Parameters);
+		//ClearUnusedGraphResources(PixelShader, Parameters);
+
+		auto AllocParameters = [&](FRDGTextureRef RDGRenderTarget, ERenderTargetLoadAction LoadAction)
+		{
+			//Setup Parameters
+			FSimpleRDGPixelShader::FParameters *Parameters = GraphBuilder.AllocParameters<FSimpleRDGPixelShader::FParameters>();
+			Parameters->TextureVal = InTexture;
+			Parameters->TextureSampler = TStaticSamplerState<SF_Trilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+			Parameters->SimpleColor = InColor;
+			Parameters->SimpleUniformStruct = UniformBuffer;
+			Parameters->RenderTargets[0] = FRenderTargetBinding(RDGRenderTarget, LoadAction);
+			return Parameters;
+		};
+
+		RDG_GPU_STAT_SCOPE(GraphBuilder, SimpleRenderingRDGDraw);
+		if (bDirectOutput)
+		{
+			// One pass scissored to every region, the target is loaded when parts of it are kept
+			const bool bWholeTarget = Regions.Num() == 1 && Regions[0] == FIntRect(FIntPoint::ZeroValue, TargetSize);
+			FSimpleRDGPixelShader::FParameters *Parameters = AllocParameters(RDGOutput, bWholeTarget ? ERenderTargetLoadAction::ENoAction : ERenderTargetLoadAction::ELoad);
+			AddQuadPass(GraphBuilder, Parameters, VertexShader, PixelShader, FIntRect(FIntPoint::ZeroValue, TargetSize), MoveTemp(Regions));
+			return;
+		}
+
+		for (const FIntRect& Region : Regions)
+		{
+			// The viewport keeps the full target mapping and is offset so the region lands at the origin of its transient texture.
+			// Viewports may extend past the render target within the viewport bounds range of the RHI
+			FRDGTextureRef RDGRenderTarget = CreateTransientOutputTexture(GraphBuilder, RenderTargetRHI, Region.Size());
+			FSimpleRDGPixelShader::FParameters *Parameters = AllocParameters(RDGRenderTarget, ERenderTargetLoadAction::ENoAction);
+			AddQuadPass(GraphBuilder, Parameters, VertexShader, PixelShader, FIntRect(FIntPoint::ZeroValue - Region.Min, TargetSize - Region.Min), { FIntRect(FIntPoint::ZeroValue, Region.Size()) });
+
+			//Copy Result To RenderTarget Asset
+			AddOutputCopyPass(GraphBuilder, RDGRenderTarget, RDGOutput, Region.Min);
+		}
+	}
 
-		GraphBuilder.QueueTextureExtraction(RDGRenderTarget, &PooledRenderTarget);
+	/*
+	 * Render Function 
+	 */
+	void RDGCompute(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter, TArrayView<const FIntRect> DirtyRects)
+	{
+		check(IsInRenderingThread());
+
+		FlushDeferredRDGRequests(RHIImmCmdList, RenderTargetRHI);
+
+		// Auto may run its benchmark graph, which has to happen before this one is opened
+		GetThreadGroupSizePermutation(RHIImmCmdList, InParameter.ThreadGroupSize);
+
+		if (ShouldRenderTiled(RenderTargetRHI->GetSizeXY()))
+		{
+			// One graph per tile, so the transient memory of one graph never exceeds a tile
+			TArray<TArray<FIntRect>> Tiles;
+			GetTiles(RenderTargetRHI->GetSizeXY(), DirtyRects, Tiles);
+			for (const TArray<FIntRect>& TileRegions : Tiles)
+			{
+				SCOPE_CYCLE_COUNTER(STAT_SimpleRenderingRDGGraph);
+				INC_DWORD_STAT(STAT_SimpleRenderingRDGGraphs);
+				FRDGBuilder GraphBuilder(RHIImmCmdList);
+				AddRDGComputePass(GraphBuilder, RenderTargetRHI, InParameter, TileRegions);
+				GraphBuilder.Execute();
+			}
+			return;
+		}
+
+		SCOPE_CYCLE_COUNTER(STAT_SimpleRenderingRDGGraph);
+		INC_DWORD_STAT(STAT_SimpleRenderingRDGGraphs);
+
+		//RDG Begin
+		FRDGBuilder GraphBuilder(RHIImmCmdList);
+		AddRDGComputePass(GraphBuilder, RenderTargetRHI, InParameter, DirtyRects);
 		GraphBuilder.Execute();
+	}
+
+	void RDGDraw(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter, const FLinearColor InColor, FTexture2DRHIRef InTexture, TArrayView<const FIntRect> DirtyRects)
+	{
+		check(IsInRenderingThread());
+
+		FlushDeferredRDGRequests(RHIImmCmdList, RenderTargetRHI);
+
+		if (ShouldRenderTiled(RenderTargetRHI->GetSizeXY()))
+		{
+			TArray<TArray<FIntRect>> Tiles;
+			GetTiles(RenderTargetRHI->GetSizeXY(), DirtyRects, Tiles);
+			for (const TArray<FIntRect>& TileRegions : Tiles)
+			{
+				SCOPE_CYCLE_COUNTER(STAT_SimpleRenderingRDGGraph);
+				INC_DWORD_STAT(STAT_SimpleRenderingRDGGraphs);
+				FRDGBuilder GraphBuilder(RHIImmCmdList);
+				AddRDGDrawPass(GraphBuilder, RenderTargetRHI, InParameter, InColor, InTexture, TileRegions);
+				GraphBuilder.Execute();
+			}
+			return;
+		}
 
-		//Copy Result To RenderTarget Asset
-		RHIImmCmdList.CopyTexture(PooledRenderTarget->GetRenderTargetItem().ShaderResourceTexture, RenderTargetRHI->GetTexture2D(), FRHICopyTextureInfo());
+		SCOPE_CYCLE_COUNTER(STAT_SimpleRenderingRDGGraph);
+		INC_DWORD_STAT(STAT_SimpleRenderingRDGGraphs);
+
+		//RDG Begin
+		FRDGBuilder GraphBuilder(RHIImmCmdList);
+		AddRDGDrawPass(GraphBuilder, RenderTargetRHI, InParameter, InColor, InTexture, DirtyRects);
+		GraphBuilder.Execute();
 	}
-} // namespace SimpleRenderingExample
 
-void USimpleRenderingExampleBlueprintLibrary::UseRDGComput(const UObject *WorldContextObject, UTextureRenderTarget2D *OutputRenderTarget, FSimpleShaderParameter Parameter)
-{
-	check(IsInGameThread());
+	/*
+	 * Batching
+	 */
+	struct FSimpleRDGRequest
+	{
+		FTexture2DRHIRef RenderTarget;
+		FSimpleShaderParameter Parameter;
+		bool bDraw = false;
+		FLinearColor Color;
+		FTexture2DRHIRef Texture;
+
+		/** Empty for the whole target */
+		TArray<FIntRect> DirtyRects;
+	};
+
+	/** Requests of the current game thread frame. Game thread only */
+	static TArray<FSimpleRDGRequest> GPendingRDGRequests;
+	static FDelegateHandle GFlushRDGRequestsHandle;
+
+	/*
+	 * Async Compute Scheduling
+	 */
+
+	/**
+	 * Async compute requests of Blueprint calls wait here for the scene renderer's graph, which records them first so they run
+	 * next to the scene passes and RDG only joins at the end of that graph. Requests no scene render picked up are executed
+	 * in a graph of their own at the end of the next render thread frame. Render thread only
+	 */
+	class FSimpleAsyncComputeScheduler : public FRenderResource
+	{
+	public:
+		/** Keeps the request for the scene graph when it is an async compute pass, returns false when it has to run now */
+		bool Defer(FRHICommandListImmediate& RHIImmCmdList, const FSimpleRDGRequest& Request)
+		{
+			if (Request.bDraw || !UseAsyncCompute() || ShouldRenderTiled(Request.RenderTarget->GetSizeXY()))
+			{
+				return false;
+			}
 
-	FTexture2DRHIRef RenderTargetRHI = OutputRenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
+			// Auto may run its benchmark graph, which can not happen inside the scene graph
+			GetThreadGroupSizePermutation(RHIImmCmdList, Request.Parameter.ThreadGroupSize);
 
-	ENQUEUE_RENDER_COMMAND(CaptureCommand)
-	(
-		[RenderTargetRHI, Parameter](FRHICommandListImmediate &RHICmdList) {
-			SimpleRenderingExample::RDGCompute(RHICmdList, RenderTargetRHI, Parameter);
+			FDeferredRequest& Deferred = Requests.AddDefaulted_GetRef();
+			Deferred.Request = Request;
+			Deferred.Frame = GFrameCounterRenderThread;
+			return true;
+		}
+
+		/** Records every deferred request into an open graph, bSceneGraph when it is the scene renderer's */
+		void Record(FRDGBuilder& GraphBuilder, bool bSceneGraph)
+		{
+			check(IsInRenderingThread());
+
+			if (Requests.Num() == 0)
+			{
+				return;
+			}
+
+			RDG_EVENT_SCOPE(GraphBuilder, "SimpleRenderingAsyncCompute %d", Requests.Num());
+			BeginGraphicsSpan(GraphBuilder, bSceneGraph);
+			for (const FDeferredRequest& Deferred : Requests)
+			{
+				AddRDGComputePass(GraphBuilder, Deferred.Request.RenderTarget, Deferred.Request.Parameter, Deferred.Request.DirtyRects);
+			}
+			Requests.Reset();
+		}
+
+		/** Closes the graphics pipe span opened by Record, after the last pass of the graph the async compute passes overlap */
+		void EndGraphicsSpan(FRDGBuilder& GraphBuilder)
+		{
+			check(IsInRenderingThread());
+
+			if (!GraphicsSpanEndQuery)
+			{
+				return;
+			}
+
+			GraphBuilder.AddPass(
+				RDG_EVENT_NAME("SimpleRenderingGraphicsSpanEnd"),
+				ERDGPassFlags::NeverCull,
+				[EndQuery = GraphicsSpanEndQuery](FRHICommandListImmediate& RHICmdList) {
+					RHICmdList.EndRenderQuery(EndQuery);
+				});
+			GraphicsSpanEndQuery.SafeRelease();
+		}
+
+		/** Executes the deferred requests in a graph of their own, all of them so their order is kept, if one of them writes RenderTarget or it is null */
+		void Flush(FRHICommandListImmediate& RHIImmCmdList, FRHITexture* RenderTarget)
+		{
+			check(IsInRenderingThread());
+
+			const bool bFlush = RenderTarget
+				? Requests.ContainsByPredicate([RenderTarget](const FDeferredRequest& Deferred) { return Deferred.Request.RenderTarget == RenderTarget; })
+				: Requests.Num() > 0;
+			if (!bFlush)
+			{
+				return;
+			}
+
+			SCOPE_CYCLE_COUNTER(STAT_SimpleRenderingRDGGraph);
+			INC_DWORD_STAT(STAT_SimpleRenderingRDGGraphs);
+
+			FRDGBuilder GraphBuilder(RHIImmCmdList);
+			Record(GraphBuilder, false);
+			EndGraphicsSpan(GraphBuilder);
+			GraphBuilder.Execute();
+		}
+
+		virtual void InitRHI() override
+		{
+			EndFrameHandle = FCoreDelegates::OnEndFrameRT.AddRaw(this, &FSimpleAsyncComputeScheduler::OnEndFrame);
+		}
+
+		virtual void ReleaseRHI() override
+		{
+			FCoreDelegates::OnEndFrameRT.Remove(EndFrameHandle);
+			EndFrameHandle.Reset();
+			Requests.Empty();
+			GraphicsSpanEndQuery.SafeRelease();
+			GPendingAsyncComputeTimings.Empty();
+		}
+
+	private:
+		struct FDeferredRequest
+		{
+			FSimpleRDGRequest Request;
+			uint64 Frame = 0;
+		};
+
+		/** Timestamps the graphics pipe before the async compute passes, so the frame reports both pipes and their overlap */
+		void BeginGraphicsSpan(FRDGBuilder& GraphBuilder, bool bSceneGraph)
+		{
+			if (!UseAsyncCompute() || GraphicsSpanEndQuery)
+			{
+				return;
+			}
+
+			FAsyncComputeTiming& Timing = AddAsyncComputeTiming(true);
+			Timing.bSceneGraph = bSceneGraph;
+			GraphicsSpanEndQuery = Timing.EndQuery;
+			GraphBuilder.AddPass(
+				RDG_EVENT_NAME("SimpleRenderingGraphicsSpanBegin"),
+				ERDGPassFlags::NeverCull,
+				[BeginQuery = Timing.BeginQuery](FRHICommandListImmediate& RHICmdList) {
+					RHICmdList.EndRenderQuery(BeginQuery);
+				});
+		}
+
+		void OnEndFrame()
+		{
+			// Requests of this frame may still be picked up by the next scene render, batched requests are only flushed after
+			// the scene render of the frame they were made in
+			if (Requests.ContainsByPredicate([](const FDeferredRequest& Deferred) { return Deferred.Frame < GFrameCounterRenderThread; }))
+			{
+				Flush(FRHICommandListExecutor::GetImmediateCommandList(), nullptr);
+			}
+
+			ResolveAsyncComputeTimings();
+		}
+
+		TArray<FDeferredRequest> Requests;
+
+		/** Set between Record and EndGraphicsSpan of the graph that recorded async compute passes */
+		FRenderQueryRHIRef GraphicsSpanEndQuery;
+
+		FDelegateHandle EndFrameHandle;
+	};
+
+	static TGlobalResource<FSimpleAsyncComputeScheduler> GSimpleAsyncComputeScheduler;
+
+	/** Hands the deferred async compute requests to the scene renderer's graph before any scene pass is recorded and times the graphics pipe until its last one */
+	class FSimpleRenderingViewExtension : public FSceneViewExtensionBase
+	{
+	public:
+		FSimpleRenderingViewExtension(const FAutoRegister& AutoRegister)
+			: FSceneViewExtensionBase(AutoRegister)
+		{
+		}
+
+		//~ Begin ISceneViewExtension Interface
+		virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override {}
+		virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override {}
+		virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override {}
+		virtual void PreRenderView_RenderThread(FRDGBuilder& GraphBuilder, FSceneView& InView) override {}
+
+		virtual void PreRenderViewFamily_RenderThread(FRDGBuilder& GraphBuilder, FSceneViewFamily& InViewFamily) override
+		{
+			GSimpleAsyncComputeScheduler.Record(GraphBuilder, true);
+		}
+
+		virtual void PostRenderViewFamily_RenderThread(FRDGBuilder& GraphBuilder, FSceneViewFamily& InViewFamily) override
+		{
+			GSimpleAsyncComputeScheduler.EndGraphicsSpan(GraphBuilder);
+		}
+		//~ End ISceneViewExtension Interface
+	};
+
+	/** Created with the first Blueprint request, scene view extensions need the engine. Game thread only */
+	static TSharedPtr<FSimpleRenderingViewExtension, ESPMode::ThreadSafe> GSimpleRenderingViewExtension;
+
+	void FlushDeferredRDGRequests(FRHICommandListImmediate& RHIImmCmdList, FRHITexture* RenderTarget)
+	{
+		GSimpleAsyncComputeScheduler.Flush(RHIImmCmdList, RenderTarget);
+	}
+
+	static void ExecuteRDGRequest(FRHICommandListImmediate& RHIImmCmdList, const FSimpleRDGRequest& Request)
+	{
+		if (GSimpleAsyncComputeScheduler.Defer(RHIImmCmdList, Request))
+		{
+			return;
+		}
+
+		if (Request.bDraw)
+		{
+			RDGDraw(RHIImmCmdList, Request.RenderTarget, Request.Parameter, Request.Color, Request.Texture, Request.DirtyRects);
+		}
+		else
+		{
+			RDGCompute(RHIImmCmdList, Request.RenderTarget, Request.Parameter, Request.DirtyRects);
+		}
+	}
+
+	static void ExecuteRDGBatch(FRHICommandListImmediate& RHIImmCmdList, TArrayView<const FSimpleRDGRequest> Requests)
+	{
+		check(IsInRenderingThread());
+		INC_DWORD_STAT_BY(STAT_SimpleRenderingBatchedRequests, Requests.Num());
+
+		// Tiled targets keep their graph per tile, everything else shares one graph
+		TArray<const FSimpleRDGRequest*, TInlineAllocator<64>> Batched;
+		for (const FSimpleRDGRequest& Request : Requests)
+		{
+			if (GSimpleAsyncComputeScheduler.Defer(RHIImmCmdList, Request))
+			{
+				continue;
+			}
+
+			// Deferred requests for the same target were made earlier and have to land first
+			GSimpleAsyncComputeScheduler.Flush(RHIImmCmdList, Request.RenderTarget);
+
+			if (ShouldRenderTiled(Request.RenderTarget->GetSizeXY()))
+			{
+				ExecuteRDGRequest(RHIImmCmdList, Request);
+				continue;
+			}
+
+			if (!Request.bDraw)
+			{
+				GetThreadGroupSizePermutation(RHIImmCmdList, Request.Parameter.ThreadGroupSize);
+			}
+			Batched.Add(&Request);
+		}
+
+		if (Batched.Num() == 0)
+		{
+			return;
+		}
+
+		SCOPE_CYCLE_COUNTER(STAT_SimpleRenderingRDGGraph);
+		INC_DWORD_STAT(STAT_SimpleRenderingRDGGraphs);
+
+		//RDG Begin
+		FRDGBuilder GraphBuilder(RHIImmCmdList);
+		RDG_EVENT_SCOPE(GraphBuilder, "SimpleRenderingBatch %d", Batched.Num());
+		for (const FSimpleRDGRequest* Request : Batched)
+		{
+			if (Request->bDraw)
+			{
+				AddRDGDrawPass(GraphBuilder, Request->RenderTarget, Request->Parameter, Request->Color, Request->Texture, Request->DirtyRects);
+			}
+			else
+			{
+				AddRDGComputePass(GraphBuilder, Request->RenderTarget, Request->Parameter, Request->DirtyRects);
+			}
+		}
+		GraphBuilder.Execute();
+	}
+
+	void FlushRDGRequests()
+	{
+		check(IsInGameThread());
+
+		if (GPendingRDGRequests.Num() == 0)
+		{
+			return;
+		}
+
+		TArray<FSimpleRDGRequest> Requests = MoveTemp(GPendingRDGRequests);
+		GPendingRDGRequests.Reset();
+
+		ENQUEUE_RENDER_COMMAND(SimpleRenderingBatch)
+		(
+			[Requests = MoveTemp(Requests)](FRHICommandListImmediate &RHICmdList) {
+				ExecuteRDGBatch(RHICmdList, Requests);
+			});
+	}
+
+	/** Adds a request to the batch of this frame, or renders it in a graph of its own when batching is off */
+	static void EnqueueRDGRequest(FSimpleRDGRequest&& Request)
+	{
+		check(IsInGameThread());
+
+		if (!GSimpleRenderingViewExtension.IsValid() && GEngine)
+		{
+			GSimpleRenderingViewExtension = FSceneViewExtensions::NewExtension<FSimpleRenderingViewExtension>();
+		}
+
+		if (CVarSimpleRenderingBatch.GetValueOnGameThread() == 0)
+		{
+			// Requests batched before r.SimpleRendering.Batch was turned off this frame still write first
+			FlushRDGRequests();
+
+			ENQUEUE_RENDER_COMMAND(CaptureCommand)
+			(
+				[Request = MoveTemp(Request)](FRHICommandListImmediate &RHICmdList) {
+					ExecuteRDGRequest(RHICmdList, Request);
+				});
+			return;
+		}
+
+		if (!GFlushRDGRequestsHandle.IsValid())
+		{
+			GFlushRDGRequestsHandle = FCoreDelegates::OnEndFrame.AddStatic(&FlushRDGRequests);
+		}
+
+		// A whole target request hides earlier ones for the same target. A dirty rect request does not, so the earlier ones
+		// are flushed first, which also keeps one set of contents per graph in the target's persistent uniform buffer
+		const int32 Index = GPendingRDGRequests.IndexOfByPredicate([&Request](const FSimpleRDGRequest& Pending)
+		{
+			return Pending.RenderTarget == Request.RenderTarget;
 		});
+		if (Index != INDEX_NONE)
+		{
+			if (Request.DirtyRects.Num() == 0)
+			{
+				GPendingRDGRequests.RemoveAt(Index);
+			}
+			else
+			{
+				FlushRDGRequests();
+			}
+		}
+		GPendingRDGRequests.Add(MoveTemp(Request));
+	}
+
+	static void ToDirtyRects(const TArray<FBox2D>& Boxes, TArray<FIntRect>& OutRects)
+	{
+		for (const FBox2D& Box : Boxes)
+		{
+			OutRects.Add(FIntRect(FMath::FloorToInt(Box.Min.X), FMath::FloorToInt(Box.Min.Y), FMath::CeilToInt(Box.Max.X), FMath::CeilToInt(Box.Max.Y)));
+		}
+	}
+} // namespace SimpleRenderingExample
+
+void USimpleRenderingExampleBlueprintLibrary::UseRDGComput(const UObject *WorldContextObject, UTextureRenderTarget2D *OutputRenderTarget, FSimpleShaderParameter Parameter)
+{
+	UseRDGComputRegions(WorldContextObject, OutputRenderTarget, Parameter, TArray<FBox2D>());
 }
 
 void USimpleRenderingExampleBlueprintLibrary::UseRDGDraw(const UObject *WorldContextObject, UTextureRenderTarget2D *OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D *InTexture)
+{
+	UseRDGDrawRegions(WorldContextObject, OutputRenderTarget, Parameter, InColor, InTexture, TArray<FBox2D>());
+}
+
+void USimpleRenderingExampleBlueprintLibrary::UseRDGComputRegions(const UObject *WorldContextObject, UTextureRenderTarget2D *OutputRenderTarget, FSimpleShaderParameter Parameter, const TArray<FBox2D>& DirtyRects)
 {
 	check(IsInGameThread());
 
-	FTexture2DRHIRef RenderTargetRHI = OutputRenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
-	FTexture2DRHIRef InTextureRHI = InTexture->GetResource()->TextureRHI->GetTexture2D();
+	SimpleRenderingExample::FSimpleRDGRequest Request;
+	Request.RenderTarget = OutputRenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
+	Request.Parameter = Parameter;
+	SimpleRenderingExample::ToDirtyRects(DirtyRects, Request.DirtyRects);
+	SimpleRenderingExample::EnqueueRDGRequest(MoveTemp(Request));
+}
+
+void USimpleRenderingExampleBlueprintLibrary::UseRDGDrawRegions(const UObject *WorldContextObject, UTextureRenderTarget2D *OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D *InTexture, const TArray<FBox2D>& DirtyRects)
+{
+	check(IsInGameThread());
 
-	ENQUEUE_RENDER_COMMAND(CaptureCommand)
-	(
-		[RenderTargetRHI, Parameter, InColor, InTextureRHI](FRHICommandListImmediate &RHICmdList) {
-			SimpleRenderingExample::RDGDraw(RHICmdList, RenderTargetRHI, Parameter, InColor, InTextureRHI);
-		});
-}
\ No newline at end of file
+	SimpleRenderingExample::FSimpleRDGRequest Request;
+	Request.RenderTarget = OutputRenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
+	Request.Parameter = Parameter;
+	Request.bDraw = true;
+	Request.Color = InColor;
+	Request.Texture = InTexture->GetResource()->TextureRHI->GetTexture2D();
+	SimpleRenderingExample::ToDirtyRects(DirtyRects, Request.DirtyRects);
+	SimpleRenderingExample::EnqueueRDGRequest(MoveTemp(Request));
+}
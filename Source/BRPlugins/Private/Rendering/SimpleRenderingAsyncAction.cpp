@@ -0,0 +1,122 @@
+#include "Rendering/SimpleRenderingAsyncAction.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+#include "RenderingThread.h"
+
+USimpleRenderingAsyncAction* USimpleRenderingAsyncAction::UseRDGComputAsync(UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter)
+{
+	return Create(WorldContextObject, EOperation::RDGCompute, OutputRenderTarget, Parameter, FLinearColor(), nullptr);
+}
+
+USimpleRenderingAsyncAction* USimpleRenderingAsyncAction::UseRDGDrawAsync(UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D* InTexture)
+{
+	return Create(WorldContextObject, EOperation::RDGDraw, OutputRenderTarget, Parameter, InColor, InTexture);
+}
+
+USimpleRenderingAsyncAction* USimpleRenderingAsyncAction::UseGlobalShaderComputeAsync(UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter)
+{
+	return Create(WorldContextObject, EOperation::GlobalShaderCompute, OutputRenderTarget, Parameter, FLinearColor(), nullptr);
+}
+
+USimpleRenderingAsyncAction* USimpleRenderingAsyncAction::UseGlobalShaderDrawAsync(UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D* InTexture)
+{
+	return Create(WorldContextObject, EOperation::GlobalShaderDraw, OutputRenderTarget, Parameter, InColor, InTexture);
+}
+
+USimpleRenderingAsyncAction* USimpleRenderingAsyncAction::Create(UObject* WorldContextObject, EOperation Operation, UTextureRenderTarget2D* OutputRenderTarget,
+	const FSimpleShaderParameter& Parameter, const FLinearColor& InColor, UTexture2D* InTexture)
+{
+	USimpleRenderingAsyncAction* Action = NewObject<USimpleRenderingAsyncAction>();
+	Action->Operation = Operation;
+	Action->OutputRenderTarget = OutputRenderTarget;
+	Action->InTexture = InTexture;
+	Action->Parameter = Parameter;
+	Action->InColor = InColor;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void USimpleRenderingAsyncAction::Activate()
+{
+	check(IsInGameThread());
+	StartTime = FPlatformTime::Seconds();
+
+	const bool bNeedsTexture = Operation == EOperation::RDGDraw || Operation == EOperation::GlobalShaderDraw;
+	FTextureRenderTargetResource* RenderTargetResource = OutputRenderTarget ? OutputRenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+	if (!RenderTargetResource || (bNeedsTexture && (!InTexture || !InTexture->GetResource())))
+	{
+		Finish(false);
+		return;
+	}
+
+	FTexture2DRHIRef RenderTargetRHI = RenderTargetResource->GetRenderTargetTexture();
+	FTexture2DRHIRef InTextureRHI = bNeedsTexture ? InTexture->GetResource()->TextureRHI->GetTexture2D() : nullptr;
+
+	// Requests batched earlier this frame are recorded first, so the fence below also covers them and the order is kept
+	SimpleRenderingExample::FlushRDGRequests();
+
+	GPUFence = RHICreateGPUFence(TEXT("SimpleRenderingAsyncAction"));
+
+	ENQUEUE_RENDER_COMMAND(SimpleRenderingAsyncAction)
+	(
+		[Operation = Operation, RenderTargetRHI, Parameter = Parameter, InColor = InColor, InTextureRHI, Fence = GPUFence](FRHICommandListImmediate &RHICmdList) {
+			switch (Operation)
+			{
+			case EOperation::RDGCompute:
+				SimpleRenderingExample::RDGCompute(RHICmdList, RenderTargetRHI, Parameter);
+				break;
+			case EOperation::RDGDraw:
+				SimpleRenderingExample::RDGDraw(RHICmdList, RenderTargetRHI, Parameter, InColor, InTextureRHI);
+				break;
+			case EOperation::GlobalShaderCompute:
+				SimpleRenderingExample::GlobalShaderCompute(RHICmdList, RenderTargetRHI, Parameter);
+				break;
+			case EOperation::GlobalShaderDraw:
+				SimpleRenderingExample::GlobalShaderDraw(RHICmdList, RenderTargetRHI, Parameter, InColor, InTextureRHI);
+				break;
+			}
+			RHICmdList.WriteGPUFence(Fence);
+		});
+	RenderFence.BeginFence();
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USimpleRenderingAsyncAction::Tick));
+}
+
+bool USimpleRenderingAsyncAction::Tick(float DeltaTime)
+{
+	if (!RenderFence.IsFenceComplete() || !GPUFence->Poll())
+	{
+		return true;
+	}
+
+	TickerHandle.Reset();
+	Finish(true);
+	return false;
+}
+
+void USimpleRenderingAsyncAction::Finish(bool bSucceeded)
+{
+	LatencySeconds = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+	if (bSucceeded)
+	{
+		Completed.Broadcast(LatencySeconds);
+	}
+	else
+	{
+		Failed.Broadcast(LatencySeconds);
+	}
+
+	GPUFence.SafeRelease();
+	SetReadyToDestroy();
+}
+
+void USimpleRenderingAsyncAction::BeginDestroy()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	Super::BeginDestroy();
+}
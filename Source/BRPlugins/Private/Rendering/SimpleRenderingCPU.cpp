@@ -0,0 +1,167 @@
+#include "Rendering/SimpleRenderingCPU.h"
+#include "Engine/Texture2D.h"
+
+#include "Async/ParallelFor.h"
+
+namespace SimpleRenderingExample
+{
+	FLinearColor ApplyColorIndex(const FLinearColor& InColor, const FSimpleShaderParameter& InParameter)
+	{
+		switch (InParameter.ColorIndex)
+		{
+		case 0:
+			return InColor * InParameter.Color1;
+		case 1:
+			return InColor * InParameter.Color2;
+		case 2:
+			return InColor * InParameter.Color3;
+		case 3:
+			return InColor * InParameter.Color4;
+		default:
+			return InColor;
+		}
+	}
+
+	/** The 90 x 8 loop of MainCS for 4 pixels, lanes hold one pixel each */
+	static void ComputeFractalLanes(const VectorRegister4Float& U, const VectorRegister4Float& V, float GlobalTime, float* OutV1, float* OutV2, float* OutV3)
+	{
+		const VectorRegister4Float Zero = VectorZeroFloat();
+		const VectorRegister4Float Length = VectorSqrt(VectorMultiplyAdd(U, U, VectorMultiply(V, V)));
+
+		const VectorRegister4Float T = VectorAdd(VectorSetFloat1(GlobalTime * 0.1f),
+			VectorDivide(VectorSetFloat1((0.25f + 0.05f * FMath::Sin(GlobalTime * 0.1f)) * 2.2f), VectorAdd(Length, VectorSetFloat1(0.07f))));
+		VectorRegister4Float Si, Co;
+		VectorSinCos(&Si, &Co, &T);
+
+		// Loop invariant parts of the v1 and v2 weights
+		const VectorRegister4Float Weight1 = VectorMultiply(VectorSetFloat1(0.0015f), VectorAdd(VectorSetFloat1(1.8f), VectorSin(VectorAdd(VectorMultiply(Length, VectorSetFloat1(13.0f)), VectorSetFloat1(0.5f - GlobalTime * 0.2f)))));
+		const VectorRegister4Float Weight2 = VectorMultiply(VectorSetFloat1(0.0013f), VectorAdd(VectorSetFloat1(1.5f), VectorSin(VectorAdd(VectorMultiply(Length, VectorSetFloat1(14.5f)), VectorSetFloat1(1.2f - GlobalTime * 0.3f)))));
+
+		// mul(p.xy, ma) with ma rows (co, si) and (-si, co), p.xy = s * uv so the rotation of uv is shared by all steps
+		const VectorRegister4Float RotatedU = VectorSubtract(VectorMultiply(U, Co), VectorMultiply(V, Si));
+		const VectorRegister4Float RotatedV = VectorMultiplyAdd(U, Si, VectorMultiply(V, Co));
+
+		const VectorRegister4Float OffsetX = VectorSetFloat1(0.22f);
+		const VectorRegister4Float OffsetY = VectorSetFloat1(0.3f);
+		const VectorRegister4Float Fold = VectorSetFloat1(0.659f);
+		const float OffsetZ = -1.5f - FMath::Sin(GlobalTime * 0.13f) * 0.1f;
+
+		VectorRegister4Float V1 = Zero;
+		VectorRegister4Float V2 = Zero;
+		VectorRegister4Float V3 = Zero;
+
+		float S = 0.0f;
+		for (int32 Step = 0; Step < 90; ++Step)
+		{
+			const VectorRegister4Float SVec = VectorSetFloat1(S);
+			VectorRegister4Float PX = VectorMultiplyAdd(RotatedU, SVec, OffsetX);
+			VectorRegister4Float PY = VectorMultiplyAdd(RotatedV, SVec, OffsetY);
+			VectorRegister4Float PZ = VectorSetFloat1(S + OffsetZ);
+
+			for (int32 FoldIndex = 0; FoldIndex < 8; ++FoldIndex)
+			{
+				const VectorRegister4Float InvDot = VectorDivide(VectorOneFloat(), VectorMultiplyAdd(PX, PX, VectorMultiplyAdd(PY, PY, VectorMultiply(PZ, PZ))));
+				PX = VectorSubtract(VectorMultiply(VectorAbs(PX), InvDot), Fold);
+				PY = VectorSubtract(VectorMultiply(VectorAbs(PY), InvDot), Fold);
+				PZ = VectorSubtract(VectorMultiply(VectorAbs(PZ), InvDot), Fold);
+			}
+
+			const VectorRegister4Float DotXY = VectorMultiplyAdd(PX, PX, VectorMultiply(PY, PY));
+			const VectorRegister4Float Dot = VectorMultiplyAdd(PZ, PZ, DotXY);
+			V1 = VectorMultiplyAdd(Dot, Weight1, V1);
+			V2 = VectorMultiplyAdd(Dot, Weight2, V2);
+			// length(p.xy * 10.0) * 0.0003
+			V3 = VectorMultiplyAdd(VectorSqrt(DotXY), VectorSetFloat1(0.003f), V3);
+			S += 0.035f;
+		}
+
+		VectorStore(V1, OutV1);
+		VectorStore(V2, OutV2);
+		VectorStore(V3, OutV3);
+	}
+
+	void ComputeCPU(int32 SizeX, int32 SizeY, const FSimpleShaderParameter& InParameter, TArray<FLinearColor>& OutPixels)
+	{
+		OutPixels.SetNumUninitialized(FMath::Max(SizeX, 0) * FMath::Max(SizeY, 0));
+		if (OutPixels.Num() == 0)
+		{
+			return;
+		}
+
+		const float GlobalTime = InParameter.Color1.R;
+		const float RedScale = 1.5f + FMath::Sin(GlobalTime * 0.2f) * 0.4f;
+
+		ParallelFor(SizeY, [&](int32 Y)
+		{
+			// ThreadId / iResolution - 0.5, no half texel offset
+			const float V = static_cast<float>(Y) / SizeY - 0.5f;
+			const VectorRegister4Float VVec = VectorSetFloat1(V);
+			FLinearColor* Row = OutPixels.GetData() + Y * SizeX;
+
+			for (int32 X = 0; X < SizeX; X += 4)
+			{
+				alignas(16) float U[4];
+				for (int32 Lane = 0; Lane < 4; ++Lane)
+				{
+					U[Lane] = static_cast<float>(X + Lane) / SizeX - 0.5f;
+				}
+
+				alignas(16) float V1[4], V2[4], V3[4];
+				ComputeFractalLanes(VectorLoadAligned(U), VVec, GlobalTime, V1, V2, V3);
+
+				const int32 NumLanes = FMath::Min(4, SizeX - X);
+				for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+				{
+					const float Length = FMath::Sqrt(U[Lane] * U[Lane] + V * V);
+					const float Falloff = 1.0f - Length;
+					const float Value1 = V1[Lane] * 0.7f * Falloff;
+					const float Value2 = V2[Lane] * 0.5f * Falloff;
+					const float Value3 = V3[Lane] * 0.9f * Falloff;
+
+					// lerp(0.2, 0.0, len) * 0.85 + lerp(0.0, 0.6, v3) * 0.3
+					const float Glow = 0.2f * Falloff * 0.85f + 0.6f * Value3 * 0.3f;
+					const FVector3f Color(Value3 * RedScale + Glow, (Value1 + Value3) * 0.3f + Glow, Value2 + Glow);
+
+					const FLinearColor OutputColor(
+						FMath::Min(FMath::Pow(FMath::Abs(Color.X), 1.2f), 1.0f),
+						FMath::Min(FMath::Pow(FMath::Abs(Color.Y), 1.2f), 1.0f),
+						FMath::Min(FMath::Pow(FMath::Abs(Color.Z), 1.2f), 1.0f),
+						1.0f);
+					Row[X + Lane] = ApplyColorIndex(OutputColor, InParameter);
+				}
+			}
+		});
+	}
+} // namespace SimpleRenderingExample
+
+UTexture2D* USimpleRenderingExampleBlueprintLibrary::UseCPUCompute(int32 SizeX, int32 SizeY, FSimpleShaderParameter Parameter, float& OutMegapixelsPerSecond)
+{
+	check(IsInGameThread());
+	OutMegapixelsPerSecond = 0.0f;
+
+	if (SizeX <= 0 || SizeY <= 0)
+	{
+		return nullptr;
+	}
+
+	TArray<FLinearColor> Pixels;
+	const double StartTime = FPlatformTime::Seconds();
+	SimpleRenderingExample::ComputeCPU(SizeX, SizeY, Parameter, Pixels);
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	OutMegapixelsPerSecond = Seconds > 0.0 ? static_cast<float>(Pixels.Num() / Seconds / 1.0e6) : 0.0f;
+
+	// Same float format as the intermediate texture of GlobalShaderCompute
+	UTexture2D* Texture = UTexture2D::CreateTransient(SizeX, SizeY, PF_A32B32G32R32F);
+	if (!Texture)
+	{
+		return nullptr;
+	}
+
+	Texture->SRGB = false;
+	Texture->CompressionSettings = TC_HDR;
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	FMemory::Memcpy(Mip.BulkData.Lock(LOCK_READ_WRITE), Pixels.GetData(), Pixels.Num() * sizeof(FLinearColor));
+	Mip.BulkData.Unlock();
+	Texture->UpdateResource();
+	return Texture;
+}
@@ -0,0 +1,203 @@
+#include "SimpleRenderingCommon.h"
+#include "RenderUtils.h"
+#include "Misc/CoreDelegates.h"
+
+DEFINE_STAT(STAT_SimpleRenderingTextureAllocations);
+DEFINE_STAT(STAT_SimpleRenderingUAVAllocations);
+DEFINE_STAT(STAT_SimpleRenderingVertexDeclarationAllocations);
+DEFINE_STAT(STAT_SimpleRenderingPoolHits);
+DEFINE_STAT(STAT_SimpleRenderingPoolTextures);
+DEFINE_STAT(STAT_SimpleRenderingPoolMemory);
+DEFINE_STAT(STAT_SimpleRenderingUniformBufferUploads);
+DEFINE_STAT(STAT_SimpleRenderingUniformBufferReuses);
+DEFINE_STAT(STAT_SimpleRenderingUniformBuffers);
+DEFINE_STAT(STAT_SimpleRenderingRDGGraphs);
+DEFINE_STAT(STAT_SimpleRenderingBatchedRequests);
+DEFINE_STAT(STAT_SimpleRenderingRDGGraph);
+DEFINE_STAT(STAT_SimpleRenderingReadbackFrames);
+DEFINE_STAT(STAT_SimpleRenderingReadbackDropped);
+DEFINE_STAT(STAT_SimpleRenderingAsyncComputeTime);
+DEFINE_STAT(STAT_SimpleRenderingAsyncComputeGraphicsTime);
+DEFINE_STAT(STAT_SimpleRenderingAsyncComputeTotalTime);
+
+namespace SimpleRenderingExample
+{
+	/** Frames an intermediate texture may stay unused before it is released */
+	static const uint64 IntermediateTextureLifetimeFrames = 30;
+
+	/** Frames a per render target uniform buffer may stay unused before it is released */
+	static const uint64 UniformBufferLifetimeFrames = 60;
+
+	TGlobalResource<FSimpleIntermediateTexturePool> GSimpleIntermediateTexturePool;
+	TGlobalResource<FSimpleUniformBufferCache> GSimpleUniformBufferCache;
+
+	const FSimpleIntermediateTexture& FSimpleIntermediateTexturePool::FindOrCreate(FIntPoint Size, EPixelFormat Format)
+	{
+		check(IsInRenderingThread());
+
+		FSimpleIntermediateTexture* Entry = Textures.FindByPredicate([Size, Format](const FSimpleIntermediateTexture& Texture)
+		{
+			return Texture.Size == Size && Texture.Format == Format;
+		});
+
+		if (Entry)
+		{
+			INC_DWORD_STAT(STAT_SimpleRenderingPoolHits);
+		}
+		else
+		{
+			Entry = &Textures.AddDefaulted_GetRef();
+			Entry->Size = Size;
+			Entry->Format = Format;
+
+			FRHIResourceCreateInfo CreateInfo(TEXT("GlobalShader_ComputeShader_UAV"));
+			Entry->Texture = RHICreateTexture2D(Size.X, Size.Y, Format, 1, 1, TexCreate_ShaderResource | TexCreate_UAV, CreateInfo);
+			Entry->UAV = RHICreateUnorderedAccessView(Entry->Texture);
+			Entry->MemorySize = CalcTextureSize(Size.X, Size.Y, Format, 1);
+			INC_MEMORY_STAT_BY(STAT_SimpleRenderingPoolMemory, Entry->MemorySize);
+			INC_DWORD_STAT(STAT_SimpleRenderingTextureAllocations);
+			INC_DWORD_STAT(STAT_SimpleRenderingUAVAllocations);
+		}
+
+		SET_DWORD_STAT(STAT_SimpleRenderingPoolTextures, Textures.Num());
+		Entry->LastUsedFrame = GFrameCounterRenderThread;
+		return *Entry;
+	}
+
+	void FSimpleIntermediateTexturePool::Flush()
+	{
+		check(IsInRenderingThread());
+		ReleaseTextures();
+	}
+
+	void FSimpleIntermediateTexturePool::RemoveStaleEntries()
+	{
+		check(IsInRenderingThread());
+
+		const uint64 FrameNumber = GFrameCounterRenderThread;
+		Textures.RemoveAllSwap([FrameNumber](const FSimpleIntermediateTexture& Entry)
+		{
+			const bool bExpired = Entry.LastUsedFrame + IntermediateTextureLifetimeFrames < FrameNumber;
+			if (bExpired)
+			{
+				DEC_MEMORY_STAT_BY(STAT_SimpleRenderingPoolMemory, Entry.MemorySize);
+			}
+			return bExpired;
+		});
+		SET_DWORD_STAT(STAT_SimpleRenderingPoolTextures, Textures.Num());
+	}
+
+	void FSimpleIntermediateTexturePool::InitRHI()
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrameRT.AddRaw(this, &FSimpleIntermediateTexturePool::RemoveStaleEntries);
+	}
+
+	void FSimpleIntermediateTexturePool::ReleaseRHI()
+	{
+		FCoreDelegates::OnEndFrameRT.Remove(EndFrameHandle);
+		EndFrameHandle.Reset();
+		ReleaseTextures();
+	}
+
+	void FSimpleIntermediateTexturePool::ReleaseTextures()
+	{
+		Textures.Empty();
+		SET_DWORD_STAT(STAT_SimpleRenderingPoolTextures, 0);
+		SET_MEMORY_STAT(STAT_SimpleRenderingPoolMemory, 0);
+	}
+
+	TUniformBufferRef<FSimpleUniformStructParameters> FSimpleUniformBufferCache::Get(FRHITexture* RenderTarget, const FSimpleShaderParameter& InParameter)
+	{
+		check(IsInRenderingThread());
+
+		// Zeroed so padding never makes equal contents compare different
+		FSimpleUniformStructParameters Contents;
+		FMemory::Memzero(Contents);
+		Contents.Color1 = InParameter.Color1;
+		Contents.Color2 = InParameter.Color2;
+		Contents.Color3 = InParameter.Color3;
+		Contents.Color4 = InParameter.Color4;
+		Contents.ColorIndex = InParameter.ColorIndex;
+
+		FEntry& Entry = Entries.FindOrAdd(RenderTarget);
+		if (Entry.UniformBuffer.IsValid() && Entry.LastUsedFrame == GFrameCounterRenderThread && FMemory::Memcmp(&Entry.Contents, &Contents, sizeof(Contents)) != 0)
+		{
+			// A graph recorded this frame may not have executed yet, updating the shared buffer would change the parameters of its passes
+			INC_DWORD_STAT(STAT_SimpleRenderingUniformBufferUploads);
+			return TUniformBufferRef<FSimpleUniformStructParameters>::CreateUniformBufferImmediate(Contents, UniformBuffer_SingleFrame);
+		}
+		Entry.LastUsedFrame = GFrameCounterRenderThread;
+
+		if (!Entry.UniformBuffer.IsValid())
+		{
+			Entry.RenderTarget = RenderTarget;
+			Entry.Contents = Contents;
+			Entry.UniformBuffer = TUniformBufferRef<FSimpleUniformStructParameters>::CreateUniformBufferImmediate(Contents, UniformBuffer_MultiFrame);
+			INC_DWORD_STAT(STAT_SimpleRenderingUniformBufferUploads);
+			SET_DWORD_STAT(STAT_SimpleRenderingUniformBuffers, Entries.Num());
+		}
+		else if (FMemory::Memcmp(&Entry.Contents, &Contents, sizeof(Contents)) != 0)
+		{
+			Entry.Contents = Contents;
+			Entry.UniformBuffer.UpdateUniformBufferImmediate(Contents);
+			INC_DWORD_STAT(STAT_SimpleRenderingUniformBufferUploads);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_SimpleRenderingUniformBufferReuses);
+		}
+
+		return Entry.UniformBuffer;
+	}
+
+	void FSimpleUniformBufferCache::RemoveStaleEntries()
+	{
+		check(IsInRenderingThread());
+
+		const uint64 FrameNumber = GFrameCounterRenderThread;
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			const FEntry& Entry = It.Value();
+			if (Entry.RenderTarget->GetRefCount() <= 1 || Entry.LastUsedFrame + UniformBufferLifetimeFrames < FrameNumber)
+			{
+				It.RemoveCurrent();
+			}
+		}
+		SET_DWORD_STAT(STAT_SimpleRenderingUniformBuffers, Entries.Num());
+	}
+
+	void FSimpleUniformBufferCache::InitRHI()
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrameRT.AddRaw(this, &FSimpleUniformBufferCache::RemoveStaleEntries);
+	}
+
+	void FSimpleUniformBufferCache::ReleaseRHI()
+	{
+		FCoreDelegates::OnEndFrameRT.Remove(EndFrameHandle);
+		EndFrameHandle.Reset();
+		Entries.Empty();
+		SET_DWORD_STAT(STAT_SimpleRenderingUniformBuffers, 0);
+	}
+
+	EPixelFormat GetIntermediateFormat(ESimpleRenderingPrecision Precision)
+	{
+		EPixelFormat Format = PF_A32B32G32R32F;
+		switch (Precision)
+		{
+		case ESimpleRenderingPrecision::FP16:
+			Format = PF_FloatRGBA;
+			break;
+		case ESimpleRenderingPrecision::R11G11B10:
+			Format = PF_FloatR11G11B10;
+			break;
+		case ESimpleRenderingPrecision::RGBA8:
+			Format = PF_R8G8B8A8;
+			break;
+		default:
+			break;
+		}
+
+		// The legacy path writes the intermediate through a typed UAV
+		return GPixelFormats[Format].Supported && RHIIsTypedUAVStoreSupported(Format) ? Format : PF_FloatRGBA;
+	}
+} // namespace SimpleRenderingExample
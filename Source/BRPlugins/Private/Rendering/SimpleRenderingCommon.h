@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHI.h"
+#include "RenderResource.h"
+#include "ShaderPermutation.h"
+#include "Stats/Stats.h"
+#include "Rendering/SimpleRenderingExample.h"
+
+DECLARE_STATS_GROUP(TEXT("SimpleRendering"), STATGROUP_SimpleRendering, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RHI Texture Allocations"), STAT_SimpleRenderingTextureAllocations, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RHI UAV Allocations"), STAT_SimpleRenderingUAVAllocations, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RHI Vertex Declaration Allocations"), STAT_SimpleRenderingVertexDeclarationAllocations, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Intermediate Pool Hits"), STAT_SimpleRenderingPoolHits, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Intermediate Pool Textures"), STAT_SimpleRenderingPoolTextures, STATGROUP_SimpleRendering, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Intermediate Pool Memory"), STAT_SimpleRenderingPoolMemory, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Uniform Buffer Uploads"), STAT_SimpleRenderingUniformBufferUploads, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Uniform Buffer Reuses"), STAT_SimpleRenderingUniformBufferReuses, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Uniform Buffers"), STAT_SimpleRenderingUniformBuffers, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RDG Graphs"), STAT_SimpleRenderingRDGGraphs, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RDG Batched Requests"), STAT_SimpleRenderingBatchedRequests, STATGROUP_SimpleRendering, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RDG Graph Build And Execute"), STAT_SimpleRenderingRDGGraph, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Readback Frames"), STAT_SimpleRenderingReadbackFrames, STATGROUP_SimpleRendering, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Readback Dropped Frames"), STAT_SimpleRenderingReadbackDropped, STATGROUP_SimpleRendering, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Async Compute GPU Time (ms)"), STAT_SimpleRenderingAsyncComputeTime, STATGROUP_SimpleRendering, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Async Compute Graphics Span (ms)"), STAT_SimpleRenderingAsyncComputeGraphicsTime, STATGROUP_SimpleRendering, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Async Compute Total Span (ms)"), STAT_SimpleRenderingAsyncComputeTotalTime, STATGROUP_SimpleRendering, );
+
+namespace SimpleRenderingExample
+{
+	/** COLOR_INDEX of SimpleColor.ush, 0-3 are compiled in and DynamicColorIndex branches on the uniform buffer */
+	class FSimpleColorIndexDim : SHADER_PERMUTATION_INT("COLOR_INDEX", 5);
+	static const int32 DynamicColorIndex = 4;
+
+	inline int32 GetColorIndexPermutation(const FSimpleShaderParameter& InParameter)
+	{
+		const bool bStatic = !InParameter.bDynamicColorIndex && InParameter.ColorIndex >= 0 && InParameter.ColorIndex < DynamicColorIndex;
+		return bStatic ? InParameter.ColorIndex : DynamicColorIndex;
+	}
+
+	/** THREADGROUP_SIZE_MODE of SimpleComputeShader.usf, ESimpleThreadGroupSize without Auto */
+	class FSimpleThreadGroupSizeDim : SHADER_PERMUTATION_INT("THREADGROUP_SIZE_MODE", 4);
+
+	inline FIntPoint GetThreadGroupSize(int32 ThreadGroupSizeMode)
+	{
+		static const FIntPoint GroupSizes[] = { FIntPoint(8, 8), FIntPoint(16, 16), FIntPoint(32, 32), FIntPoint(64, 1) };
+		return GroupSizes[FMath::Clamp(ThreadGroupSizeMode, 0, 3)];
+	}
+
+	/**
+	 * Permutation for the requested size. Auto times every size on a test dispatch the first time it is needed on a GPU,
+	 * the winner is kept for the process and written to the engine config per adapter and driver from the game thread. Render thread only
+	 */
+	int32 GetThreadGroupSizePermutation(FRHICommandListImmediate& RHIImmCmdList, ESimpleThreadGroupSize ThreadGroupSize);
+
+	struct FSimpleIntermediateTexture
+	{
+		FTexture2DRHIRef Texture;
+		FUnorderedAccessViewRHIRef UAV;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		EPixelFormat Format = PF_Unknown;
+		uint64 LastUsedFrame = 0;
+		SIZE_T MemorySize = 0;
+	};
+
+	/**
+	 * UAV textures for the legacy compute path, keyed by size and format. Entries unused for a few frames are released,
+	 * swept at the end of every render thread frame so they go away even when nothing renders anymore. Render thread only
+	 */
+	class FSimpleIntermediateTexturePool : public FRenderResource
+	{
+	public:
+		/** Returns a texture of exactly this size and format, creating it on a miss */
+		const FSimpleIntermediateTexture& FindOrCreate(FIntPoint Size, EPixelFormat Format);
+
+		/** Releases every texture now instead of after the unused frames, for callers that render many sizes without advancing frames */
+		void Flush();
+
+		virtual void InitRHI() override;
+		virtual void ReleaseRHI() override;
+
+	private:
+		void RemoveStaleEntries();
+		void ReleaseTextures();
+
+		TArray<FSimpleIntermediateTexture> Textures;
+		FDelegateHandle EndFrameHandle;
+	};
+
+	extern TGlobalResource<FSimpleIntermediateTexturePool> GSimpleIntermediateTexturePool;
+
+	/**
+	 * One multi frame uniform buffer per render target, uploaded again only when its contents change.
+	 * Entries go away with their render target or after a few unused frames, swept at the end of every render thread frame
+	 * so a target is not kept alive by the cache once nothing renders into it. A target rendered again with other contents in
+	 * the same frame gets a single frame buffer of its own, several passes of one graph may write it. Render thread only
+	 */
+	class FSimpleUniformBufferCache : public FRenderResource
+	{
+	public:
+		TUniformBufferRef<FSimpleUniformStructParameters> Get(FRHITexture* RenderTarget, const FSimpleShaderParameter& InParameter);
+
+		virtual void InitRHI() override;
+		virtual void ReleaseRHI() override;
+
+	private:
+		struct FEntry
+		{
+			/** Keeps the key alive, so a new texture can not reuse the address of a released one */
+			FTextureRHIRef RenderTarget;
+			FSimpleUniformStructParameters Contents;
+			TUniformBufferRef<FSimpleUniformStructParameters> UniformBuffer;
+			uint64 LastUsedFrame = 0;
+		};
+
+		void RemoveStaleEntries();
+
+		TMap<FRHITexture*, FEntry> Entries;
+		FDelegateHandle EndFrameHandle;
+	};
+
+	extern TGlobalResource<FSimpleUniformBufferCache> GSimpleUniformBufferCache;
+
+	/** Pixel format of a precision, falls back to FP16 where the RHI does not support the format or typed UAV stores to it */
+	EPixelFormat GetIntermediateFormat(ESimpleRenderingPrecision Precision);
+} // namespace SimpleRenderingExample
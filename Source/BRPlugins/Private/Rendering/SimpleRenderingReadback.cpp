@@ -0,0 +1,226 @@
+#include "Rendering/SimpleRenderingReadback.h"
+#include "Rendering/SimpleRenderingExample.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+#include "RenderingThread.h"
+#include "RHIGPUReadback.h"
+
+#include "SimpleRenderingCommon.h"
+
+namespace SimpleRenderingExample
+{
+	TSharedRef<FSimpleRenderTargetReadback, ESPMode::ThreadSafe> FSimpleRenderTargetReadback::Create(int32 NumSlots, FOnFrame OnFrame)
+	{
+		check(IsInGameThread());
+
+		TSharedRef<FSimpleRenderTargetReadback, ESPMode::ThreadSafe> Readback = MakeShareable(new FSimpleRenderTargetReadback(NumSlots, MoveTemp(OnFrame)));
+
+		TWeakPtr<FSimpleRenderTargetReadback, ESPMode::ThreadSafe> WeakReadback = Readback;
+		Readback->TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakReadback](float DeltaTime)
+		{
+			if (TSharedPtr<FSimpleRenderTargetReadback, ESPMode::ThreadSafe> Pinned = WeakReadback.Pin())
+			{
+				ENQUEUE_RENDER_COMMAND(SimpleRenderingReadbackPoll)
+				(
+					[Pinned](FRHICommandListImmediate &RHICmdList) {
+						Pinned->Poll_RenderThread(RHICmdList);
+					});
+			}
+			return true;
+		}));
+		return Readback;
+	}
+
+	FSimpleRenderTargetReadback::FSimpleRenderTargetReadback(int32 NumSlots, FOnFrame&& InOnFrame)
+		: OnFrame(MoveTemp(InOnFrame))
+	{
+		for (int32 SlotIndex = 0; SlotIndex < FMath::Max(NumSlots, 1); ++SlotIndex)
+		{
+			TUniquePtr<FSlot>& Slot = Slots.Add_GetRef(MakeUnique<FSlot>());
+			Slot->Readback = MakeUnique<FRHIGPUTextureReadback>(*FString::Printf(TEXT("SimpleRenderingReadback%d"), SlotIndex));
+		}
+	}
+
+	FSimpleRenderTargetReadback::~FSimpleRenderTargetReadback()
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+		// Deliveries hold a reference while running, so no callback can still read a mapped slot here.
+		// The staging textures are unlocked and released on the render thread, whichever thread drops the last reference
+		ENQUEUE_RENDER_COMMAND(SimpleRenderingReadbackRelease)
+		(
+			[Slots = MoveTemp(Slots)](FRHICommandListImmediate &RHICmdList) {
+				for (const TUniquePtr<FSlot>& Slot : Slots)
+				{
+					if (Slot->State == ESlotState::Mapped)
+					{
+						Slot->Readback->Unlock();
+					}
+				}
+			});
+	}
+
+	void FSimpleRenderTargetReadback::Capture(UTextureRenderTarget2D* RenderTarget)
+	{
+		check(IsInGameThread());
+
+		FTextureRenderTargetResource* RenderTargetResource = RenderTarget ? RenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+		if (!RenderTargetResource)
+		{
+			return;
+		}
+
+		// The latency includes the wait for the render thread
+		const uint64 FrameNumber = GFrameCounter;
+		const double CaptureTime = FPlatformTime::Seconds();
+
+		// Batched requests would otherwise be recorded after the copy
+		FlushRDGRequests();
+
+		FTexture2DRHIRef RenderTargetRHI = RenderTargetResource->GetRenderTargetTexture();
+		ENQUEUE_RENDER_COMMAND(SimpleRenderingReadbackCapture)
+		(
+			[This = AsShared(), RenderTargetRHI, FrameNumber, CaptureTime](FRHICommandListImmediate &RHICmdList) {
+				This->Capture_RenderThread(RHICmdList, RenderTargetRHI, FrameNumber, CaptureTime);
+			});
+	}
+
+	void FSimpleRenderTargetReadback::Capture_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture* Texture, uint64 FrameNumber, double CaptureTime)
+	{
+		check(IsInRenderingThread());
+
+		// Async compute requests waiting for the scene graph were made before the capture
+		FlushDeferredRDGRequests(RHICmdList, Texture);
+
+		// Recycle what the workers finished with before deciding the ring is full
+		Poll_RenderThread(RHICmdList);
+
+		{
+			FScopeLock Lock(&StatsLock);
+			if (FirstCaptureTime == 0.0)
+			{
+				FirstCaptureTime = CaptureTime;
+			}
+		}
+
+		if (NumInUse == Slots.Num())
+		{
+			INC_DWORD_STAT(STAT_SimpleRenderingReadbackDropped);
+			FScopeLock Lock(&StatsLock);
+			++Stats.NumDropped;
+			return;
+		}
+
+		FSlot& Slot = *Slots[(Head + NumInUse) % Slots.Num()];
+		++NumInUse;
+
+		Slot.State = ESlotState::Copying;
+		Slot.bCallbackDone = false;
+		Slot.Size = Texture->GetSizeXY();
+		Slot.Format = Texture->GetFormat();
+		Slot.FrameNumber = FrameNumber;
+		Slot.CaptureTime = CaptureTime;
+
+		RHICmdList.Transition(FRHITransitionInfo(Texture, ERHIAccess::Unknown, ERHIAccess::CopySrc));
+		Slot.Readback->EnqueueCopy(RHICmdList, Texture);
+		RHICmdList.Transition(FRHITransitionInfo(Texture, ERHIAccess::CopySrc, ERHIAccess::SRVMask));
+	}
+
+	void FSimpleRenderTargetReadback::Poll_RenderThread(FRHICommandListImmediate& RHICmdList)
+	{
+		check(IsInRenderingThread());
+
+		// Map in capture order, a copy still in flight holds back the ones after it
+		for (int32 Offset = 0; Offset < NumInUse; ++Offset)
+		{
+			FSlot& Slot = *Slots[(Head + Offset) % Slots.Num()];
+			if (Slot.State == ESlotState::Mapped)
+			{
+				continue;
+			}
+			if (!Slot.Readback->IsReady())
+			{
+				break;
+			}
+
+			int32 RowPitchInPixels = 0;
+			const uint8* Data = static_cast<const uint8*>(Slot.Readback->Lock(RowPitchInPixels));
+			Slot.State = ESlotState::Mapped;
+
+			// A failed map is a lost frame, the slot goes back to the ring in order below without a callback
+			if (!Data)
+			{
+				INC_DWORD_STAT(STAT_SimpleRenderingReadbackDropped);
+				{
+					FScopeLock Lock(&StatsLock);
+					++Stats.NumDropped;
+				}
+				Slot.bCallbackDone = true;
+				continue;
+			}
+
+			FSimpleReadbackFrame Frame;
+			Frame.Data = Data;
+			Frame.RowPitchInPixels = RowPitchInPixels;
+			Frame.Size = Slot.Size;
+			Frame.Format = Slot.Format;
+			Frame.FrameNumber = Slot.FrameNumber;
+
+			// Slots are mapped in capture order, chaining each delivery after the previous one keeps that order for OnFrame
+			TArray<UE::Tasks::FTask, TInlineAllocator<1>> Prerequisites;
+			if (LastDelivery.IsValid())
+			{
+				Prerequisites.Add(LastDelivery);
+			}
+
+			FSlot* SlotPtr = &Slot;
+			const double CaptureTime = Slot.CaptureTime;
+			LastDelivery = UE::Tasks::Launch(TEXT("SimpleRenderingReadbackFrame"), [This = AsShared(), SlotPtr, Frame, CaptureTime]() mutable
+			{
+				Frame.LatencySeconds = FPlatformTime::Seconds() - CaptureTime;
+				This->OnFrame(Frame);
+				This->RecordDelivery(Frame);
+				SlotPtr->bCallbackDone = true;
+			}, Prerequisites);
+		}
+
+		// Unlock and free from the head once the callbacks returned
+		while (NumInUse > 0)
+		{
+			FSlot& Slot = *Slots[Head];
+			if (Slot.State != ESlotState::Mapped || !Slot.bCallbackDone)
+			{
+				break;
+			}
+
+			Slot.Readback->Unlock();
+			Slot.State = ESlotState::Free;
+			Head = (Head + 1) % Slots.Num();
+			--NumInUse;
+		}
+	}
+
+	void FSimpleRenderTargetReadback::RecordDelivery(const FSimpleReadbackFrame& Frame)
+	{
+		INC_DWORD_STAT(STAT_SimpleRenderingReadbackFrames);
+
+		FScopeLock Lock(&StatsLock);
+		++Stats.NumDelivered;
+		TotalLatencySeconds += Frame.LatencySeconds;
+		TotalBytes += static_cast<int64>(Frame.Size.X) * Frame.Size.Y * GPixelFormats[Frame.Format].BlockBytes;
+		Stats.MaxLatencySeconds = FMath::Max(Stats.MaxLatencySeconds, Frame.LatencySeconds);
+	}
+
+	FSimpleReadbackStats FSimpleRenderTargetReadback::GetStats() const
+	{
+		FScopeLock Lock(&StatsLock);
+		FSimpleReadbackStats Result = Stats;
+		if (Stats.NumDelivered > 0)
+		{
+			Result.AverageLatencySeconds = TotalLatencySeconds / Stats.NumDelivered;
+		}
+		const double Elapsed = FirstCaptureTime > 0.0 ? FPlatformTime::Seconds() - FirstCaptureTime : 0.0;
+		Result.BytesPerSecond = Elapsed > 0.0 ? TotalBytes / Elapsed : 0.0;
+		return Result;
+	}
+} // namespace SimpleRenderingExample
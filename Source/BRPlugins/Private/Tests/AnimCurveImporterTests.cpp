@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+#include "Tests/AnimTestSequence.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveImporterCsvTest, "BRPlugins.AnimModifier.CurveImporter.Csv", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimCurveImporterCsvTest::RunTest(const FString& Parameters)
+{
+	// Unsorted rows, an empty field, a zero with a huge exponent and a value out of float range
+	const FString FilePath = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("AnimCurveImporterTest"), TEXT(".csv"));
+	FFileHelper::SaveStringToFile(TEXT("Time,A,B\r\n0.2,2,0e999\r\n0.0,0,1e400\r\n0.1,1.5e0,\r\n"), *FilePath);
+
+	USkeleton* Skeleton = AnimTestSequence::CreateSkeleton({});
+	UAnimSequence* AnimationSequence = AnimTestSequence::CreateSequence(Skeleton, 31, FFrameRate(30, 1), [](FName, int32) { return FTransform::Identity; });
+
+	FAnimCurveImportSource Source;
+	Source.AnimationSequence = AnimationSequence;
+	Source.FilePath = FilePath;
+
+	FAnimCurveImportReport Report;
+	UAnimBlueprintLibrary::ImportCurveKeysFromFiles({ Source }, Report);
+	IFileManager::Get().Delete(*FilePath);
+
+	TestEqual(TEXT("Files imported"), Report.NumFilesImported, 1);
+	TestEqual(TEXT("Rows"), Report.NumRows, static_cast<int64>(3));
+
+	TArray<float> Times, Values;
+	AnimTestSequence::GetFloatKeys(AnimationSequence, TEXT("A"), Times, Values);
+	TestTrue(TEXT("A is sorted by time"), Times == TArray<float>({ 0.0f, 0.1f, 0.2f }));
+	TestTrue(TEXT("A values"), Values == TArray<float>({ 0.0f, 1.5f, 2.0f }));
+
+	AnimTestSequence::GetFloatKeys(AnimationSequence, TEXT("B"), Times, Values);
+	TestTrue(TEXT("B keeps only the finite value"), Times == TArray<float>({ 0.2f }) && Values == TArray<float>({ 0.0f }));
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+namespace AnimCurveImporterTests
+{
+	static const int32 NumCurves = 16;
+
+	/** Rows are a quarter second apart, every time stays exact in float up to the 1 GB files written here */
+	static float GetRowTime(int64 Row)
+	{
+		return static_cast<float>(Row) * 0.25f;
+	}
+
+	static float GetRowValue(int64 Row, int32 CurveIndex)
+	{
+		return FMath::Sin(static_cast<float>(Row) * 0.001f * (CurveIndex + 1));
+	}
+
+	/** Appends a non negative value with two decimals, time values are quarters so this is exact */
+	static void AppendTime(TArray<ANSICHAR>& Buffer, int64 Row)
+	{
+		ANSICHAR Digits[24];
+		int32 NumDigits = 0;
+		for (int64 Whole = Row / 4; NumDigits == 0 || Whole > 0; Whole /= 10)
+		{
+			Digits[NumDigits++] = static_cast<ANSICHAR>('0' + Whole % 10);
+		}
+		while (NumDigits > 0)
+		{
+			Buffer.Add(Digits[--NumDigits]);
+		}
+
+		static const ANSICHAR* Fractions[] = { ".00", ".25", ".50", ".75" };
+		Buffer.Append(Fractions[Row % 4], 3);
+	}
+
+	/** Appends a value in [-1, 1] with five decimals */
+	static void AppendValue(TArray<ANSICHAR>& Buffer, float Value)
+	{
+		int32 Fixed = FMath::RoundToInt(Value * 100000.0f);
+		if (Fixed < 0)
+		{
+			Buffer.Add('-');
+			Fixed = -Fixed;
+		}
+		Buffer.Add(static_cast<ANSICHAR>('0' + Fixed / 100000));
+		Buffer.Add('.');
+		for (int32 Divisor = 10000; Divisor > 0; Divisor /= 10)
+		{
+			Buffer.Add(static_cast<ANSICHAR>('0' + (Fixed / Divisor) % 10));
+		}
+	}
+
+	/** Writes rows until the file reaches TargetBytes, returns the number of rows */
+	static int64 WriteFile(const FString& FilePath, EAnimCurveImportFormat Format, int64 TargetBytes)
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+		if (!Writer)
+		{
+			return 0;
+		}
+
+		TArray<ANSICHAR> Buffer;
+		Buffer.Reserve(4 * 1024 * 1024 + 1024);
+
+		int64 Row = 0;
+		while (Writer->Tell() + Buffer.Num() < TargetBytes)
+		{
+			if (Format == EAnimCurveImportFormat::RawFloat32)
+			{
+				float Values[NumCurves + 1];
+				Values[0] = GetRowTime(Row);
+				for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+				{
+					Values[CurveIndex + 1] = GetRowValue(Row, CurveIndex);
+				}
+				Buffer.Append(reinterpret_cast<const ANSICHAR*>(Values), sizeof(Values));
+			}
+			else
+			{
+				AppendTime(Buffer, Row);
+				for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+				{
+					Buffer.Add(',');
+					AppendValue(Buffer, GetRowValue(Row, CurveIndex));
+				}
+				Buffer.Add('\n');
+			}
+			++Row;
+
+			if (Buffer.Num() >= 4 * 1024 * 1024)
+			{
+				Writer->Serialize(Buffer.GetData(), Buffer.Num());
+				Buffer.Reset();
+			}
+		}
+
+		Writer->Serialize(Buffer.GetData(), Buffer.Num());
+		Writer->Close();
+		return Row;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveImporterThroughputTest, "BRPlugins.AnimModifier.CurveImporter.Throughput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FAnimCurveImporterThroughputTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimCurveImporterTests;
+
+	const int64 TargetBytes = 1024ll * 1024 * 1024;
+
+	TArray<FName> CurveNames;
+	for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+	{
+		CurveNames.Add(FName(*FString::Printf(TEXT("Curve%d"), CurveIndex)));
+	}
+
+	for (const EAnimCurveImportFormat Format : { EAnimCurveImportFormat::RawFloat32, EAnimCurveImportFormat::Csv })
+	{
+		const bool bRaw = Format == EAnimCurveImportFormat::RawFloat32;
+		const FString FilePath = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("AnimCurveImporterThroughput"), bRaw ? TEXT(".raw") : TEXT(".csv"));
+		const int64 NumRows = WriteFile(FilePath, Format, TargetBytes);
+		if (!TestTrue(TEXT("Temp file written"), NumRows > 0))
+		{
+			IFileManager::Get().Delete(*FilePath);
+			continue;
+		}
+
+		USkeleton* Skeleton = AnimTestSequence::CreateSkeleton({});
+		UAnimSequence* AnimationSequence = AnimTestSequence::CreateSequence(Skeleton, 31, FFrameRate(30, 1), [](FName, int32) { return FTransform::Identity; });
+
+		// Reduced, so the curves stay small while a window worth of keys goes through the replace range write
+		FAnimCurveImportSource Source;
+		Source.AnimationSequence = AnimationSequence;
+		Source.FilePath = FilePath;
+		Source.Format = Format;
+		Source.CurveNames = CurveNames;
+		Source.KeyReduction.bEnabled = true;
+		Source.KeyReduction.MaxError = 0.001f;
+
+		FAnimCurveImportReport Report;
+		UAnimBlueprintLibrary::ImportCurveKeysFromFiles({ Source }, Report);
+		IFileManager::Get().Delete(*FilePath);
+
+		TestEqual(TEXT("Files imported"), Report.NumFilesImported, 1);
+		TestEqual(TEXT("Rows"), Report.NumRows, NumRows);
+
+		const int64 NumKeys = Report.NumRows * NumCurves;
+		const double TotalSeconds = FMath::Max(static_cast<double>(Report.ParseSeconds + Report.ApplySeconds), 1e-9);
+		AddInfo(FString::Printf(TEXT("%s, %.1f MB, %lld rows: parse %.1f MB/s, %.2f s applying, %.1f M keys/s overall, %d keys reduced to %d (max error %f)"),
+			bRaw ? TEXT("Raw float32") : TEXT("Csv"), Report.NumBytes / (1024.0 * 1024.0), Report.NumRows, Report.ParseMegaBytesPerSecond, Report.ApplySeconds,
+			NumKeys / TotalSeconds / 1000000.0, Report.KeyReduction.OriginalKeyCount, Report.KeyReduction.ReducedKeyCount, Report.KeyReduction.MaxError));
+
+		AnimTestSequence::Destroy(AnimationSequence);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,460 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+#include "Editor/AnimModifier/AnimCurveReduction.h"
+#include "Tests/AnimTestSequence.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+
+namespace AnimCurveKeyTests
+{
+	static const FName CurveName(TEXT("TestCurve"));
+
+	/** The per key loop AddCurveKeysInternal ran before keys were merged in one pass */
+	static void AddKeysPerKey(FRichCurve& Curve, const TArray<float>& Times, const TArray<float>& Values, EInterpCurveMode InterpMode)
+	{
+		ERichCurveInterpMode KeyInterpMode;
+		ERichCurveTangentMode KeyTangentMode;
+		UAnimBlueprintLibrary::ConvertInterpMode(InterpMode, KeyInterpMode, KeyTangentMode);
+
+		for (int32 KeyIndex = 0; KeyIndex < Times.Num(); ++KeyIndex)
+		{
+			FRichCurveKey& Key = Curve.GetKey(Curve.UpdateOrAddKey(Times[KeyIndex], Values[KeyIndex]));
+			Key.InterpMode = KeyInterpMode;
+			Key.TangentMode = KeyTangentMode;
+			Key.TangentWeightMode = RCTWM_WeightedNone;
+		}
+	}
+
+	static void GetComponentCurves(FVectorCurve& Curve, TArray<FRichCurve*>& OutCurves)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			OutCurves.Add(&Curve.FloatCurves[Axis]);
+		}
+	}
+
+	/** Translation, rotation as roll, pitch, yaw, then scale */
+	static void GetComponentCurves(FTransformCurve& Curve, TArray<FRichCurve*>& OutCurves)
+	{
+		GetComponentCurves(Curve.TranslationCurve, OutCurves);
+		GetComponentCurves(Curve.RotationCurve, OutCurves);
+		GetComponentCurves(Curve.ScaleCurve, OutCurves);
+	}
+
+	/** The per key loop for vector and transform curves, the curve's own UpdateOrAddKey followed by the key modes on every channel */
+	template <typename CurveClass, typename DataType>
+	static void AddRawCurveKeysPerKey(CurveClass& Curve, const TArray<float>& Times, const TArray<DataType>& KeyData, EInterpCurveMode InterpMode)
+	{
+		ERichCurveInterpMode KeyInterpMode;
+		ERichCurveTangentMode KeyTangentMode;
+		UAnimBlueprintLibrary::ConvertInterpMode(InterpMode, KeyInterpMode, KeyTangentMode);
+
+		TArray<FRichCurve*> ComponentCurves;
+		GetComponentCurves(Curve, ComponentCurves);
+
+		for (int32 KeyIndex = 0; KeyIndex < Times.Num(); ++KeyIndex)
+		{
+			Curve.UpdateOrAddKey(KeyData[KeyIndex], Times[KeyIndex]);
+			for (FRichCurve* ComponentCurve : ComponentCurves)
+			{
+				FRichCurveKey& Key = ComponentCurve->GetKey(ComponentCurve->FindKey(Times[KeyIndex]));
+				Key.InterpMode = KeyInterpMode;
+				Key.TangentMode = KeyTangentMode;
+				Key.TangentWeightMode = RCTWM_WeightedNone;
+			}
+		}
+	}
+
+	/** Gives every channel key user tangents, the merge has to keep them like UpdateOrAddKey did */
+	template <typename CurveClass>
+	static void SetUserTangents(CurveClass& Curve)
+	{
+		TArray<FRichCurve*> ComponentCurves;
+		GetComponentCurves(Curve, ComponentCurves);
+		for (int32 ComponentIndex = 0; ComponentIndex < ComponentCurves.Num(); ++ComponentIndex)
+		{
+			for (auto It = ComponentCurves[ComponentIndex]->GetKeyHandleIterator(); It; ++It)
+			{
+				FRichCurveKey& Key = ComponentCurves[ComponentIndex]->GetKey(*It);
+				Key.InterpMode = RCIM_Cubic;
+				Key.TangentMode = RCTM_User;
+				Key.ArriveTangent = 2.0f + ComponentIndex;
+				Key.LeaveTangent = -3.0f - ComponentIndex;
+			}
+		}
+	}
+
+	template <typename CurveClass>
+	static CurveClass* FindRawCurve(UAnimSequence* AnimationSequence, FName Name, ERawCurveTrackTypes CurveType)
+	{
+		// Transform curves are named in the track curve container
+		const FName ContainerName = CurveType == ERawCurveTrackTypes::RCT_Transform ? USkeleton::AnimTrackCurveMappingName : USkeleton::AnimCurveMappingName;
+		FSmartName SmartName;
+		if (!AnimationSequence->GetSkeleton()->GetSmartNameByName(ContainerName, Name, SmartName))
+		{
+			return nullptr;
+		}
+		return static_cast<CurveClass*>(AnimationSequence->RawCurveData.GetCurveData(SmartName.UID, CurveType));
+	}
+
+	/** Compares every channel of the merged curve with the per key result */
+	template <typename CurveClass>
+	static void TestChannelsMatch(FAutomationTestBase& Test, const TCHAR* What, CurveClass& Merged, CurveClass& Expected)
+	{
+		TArray<FRichCurve*> MergedCurves;
+		TArray<FRichCurve*> ExpectedCurves;
+		GetComponentCurves(Merged, MergedCurves);
+		GetComponentCurves(Expected, ExpectedCurves);
+
+		for (int32 ComponentIndex = 0; ComponentIndex < ExpectedCurves.Num(); ++ComponentIndex)
+		{
+			const TArray<FRichCurveKey>& ExpectedKeys = ExpectedCurves[ComponentIndex]->GetConstRefOfKeys();
+			const TArray<FRichCurveKey>& MergedKeys = MergedCurves[ComponentIndex]->GetConstRefOfKeys();
+			if (!Test.TestEqual(FString::Printf(TEXT("%s channel %d key count"), What, ComponentIndex), MergedKeys.Num(), ExpectedKeys.Num()))
+			{
+				continue;
+			}
+
+			for (int32 KeyIndex = 0; KeyIndex < ExpectedKeys.Num(); ++KeyIndex)
+			{
+				const FRichCurveKey& ExpectedKey = ExpectedKeys[KeyIndex];
+				const FRichCurveKey& MergedKey = MergedKeys[KeyIndex];
+				const FString Key = FString::Printf(TEXT("%s channel %d key %d"), What, ComponentIndex, KeyIndex);
+				Test.TestEqual(Key + TEXT(" time"), MergedKey.Time, ExpectedKey.Time);
+				Test.TestEqual(Key + TEXT(" value"), MergedKey.Value, ExpectedKey.Value);
+				Test.TestEqual(Key + TEXT(" arrive tangent"), MergedKey.ArriveTangent, ExpectedKey.ArriveTangent);
+				Test.TestEqual(Key + TEXT(" leave tangent"), MergedKey.LeaveTangent, ExpectedKey.LeaveTangent);
+				Test.TestTrue(Key + TEXT(" modes"), MergedKey.InterpMode == ExpectedKey.InterpMode && MergedKey.TangentMode == ExpectedKey.TangentMode);
+			}
+		}
+	}
+
+	static FFloatCurve* FindFloatCurve(UAnimSequence* AnimationSequence)
+	{
+		FSmartName SmartName;
+		AnimationSequence->GetSkeleton()->GetSmartNameByName(USkeleton::AnimCurveMappingName, CurveName, SmartName);
+		return static_cast<FFloatCurve*>(AnimationSequence->RawCurveData.GetCurveData(SmartName.UID, ERawCurveTrackTypes::RCT_Float));
+	}
+
+	static UAnimSequence* CreateSequence(int32 NumKeys)
+	{
+		USkeleton* Skeleton = AnimTestSequence::CreateSkeleton({});
+		UAnimSequence* AnimationSequence = AnimTestSequence::CreateSequence(Skeleton, NumKeys, FFrameRate(30, 1), [](FName, int32) { return FTransform::Identity; });
+		UAnimBlueprintLibrary::AddCurve(AnimationSequence, CurveName, ERawCurveTrackTypes::RCT_Float, false);
+		return AnimationSequence;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveKeyMergeTest, "BRPlugins.AnimModifier.CurveKeys.MergeMatchesPerKey", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimCurveKeyMergeTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimCurveKeyTests;
+
+	UAnimSequence* AnimationSequence = CreateSequence(31);
+	FFloatCurve* Curve = FindFloatCurve(AnimationSequence);
+	if (!TestNotNull(TEXT("Float curve"), Curve))
+	{
+		AnimTestSequence::Destroy(AnimationSequence);
+		return false;
+	}
+
+	// Existing user tangent keys, the merge has to keep their tangents like UpdateOrAddKey did
+	for (int32 KeyIndex = 0; KeyIndex < 10; ++KeyIndex)
+	{
+		FRichCurveKey& Key = Curve->FloatCurve.GetKey(Curve->FloatCurve.AddKey(KeyIndex * 0.1f, 1.0f));
+		Key.InterpMode = RCIM_Cubic;
+		Key.TangentMode = RCTM_User;
+		Key.ArriveTangent = 2.0f + KeyIndex;
+		Key.LeaveTangent = -3.0f - KeyIndex;
+	}
+
+	FRichCurve Expected = Curve->FloatCurve;
+
+	// Unsorted, with keys on existing times, between them, past the end and a repeated time where the last one wins
+	const TArray<float> Times = { 0.5f, 0.05f, 0.2f + KINDA_SMALL_NUMBER * 0.5f, 1.5f, 0.05f, 0.0f, 0.95f };
+	const TArray<float> Values = { 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f };
+
+	AddKeysPerKey(Expected, Times, Values, CIM_CurveUser);
+	UAnimBlueprintLibrary::AddFloatCurveKeysWithType(AnimationSequence, CurveName, Times, Values, CIM_CurveUser);
+
+	const TArray<FRichCurveKey>& ExpectedKeys = Expected.GetConstRefOfKeys();
+	const TArray<FRichCurveKey>& MergedKeys = FindFloatCurve(AnimationSequence)->FloatCurve.GetConstRefOfKeys();
+	if (TestEqual(TEXT("Key count"), MergedKeys.Num(), ExpectedKeys.Num()))
+	{
+		for (int32 KeyIndex = 0; KeyIndex < ExpectedKeys.Num(); ++KeyIndex)
+		{
+			const FRichCurveKey& ExpectedKey = ExpectedKeys[KeyIndex];
+			const FRichCurveKey& MergedKey = MergedKeys[KeyIndex];
+			TestEqual(FString::Printf(TEXT("Key %d time"), KeyIndex), MergedKey.Time, ExpectedKey.Time);
+			TestEqual(FString::Printf(TEXT("Key %d value"), KeyIndex), MergedKey.Value, ExpectedKey.Value);
+			TestEqual(FString::Printf(TEXT("Key %d arrive tangent"), KeyIndex), MergedKey.ArriveTangent, ExpectedKey.ArriveTangent);
+			TestEqual(FString::Printf(TEXT("Key %d leave tangent"), KeyIndex), MergedKey.LeaveTangent, ExpectedKey.LeaveTangent);
+			TestTrue(FString::Printf(TEXT("Key %d modes"), KeyIndex), MergedKey.InterpMode == ExpectedKey.InterpMode && MergedKey.TangentMode == ExpectedKey.TangentMode);
+		}
+	}
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveKeyVectorMergeTest, "BRPlugins.AnimModifier.CurveKeys.VectorAndTransformMatchPerKey", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimCurveKeyVectorMergeTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimCurveKeyTests;
+
+	// Unsorted, with keys on existing times, between them, past the end and a repeated time where the last one wins
+	const TArray<float> Times = { 0.5f, 0.1f, 0.3f, 1.5f, 0.1f, 0.0f };
+	const TArray<float> ExistingTimes = { 0.0f, 0.3f, 0.6f };
+
+	TArray<FVector> Vectors;
+	TArray<FTransform> Transforms;
+	for (int32 KeyIndex = 0; KeyIndex < Times.Num(); ++KeyIndex)
+	{
+		Vectors.Add(FVector(KeyIndex + 1.0f, -2.0f * KeyIndex, 0.5f * KeyIndex + 3.0f));
+
+		// Pitch, yaw and roll all differ, so a swapped rotation channel shows
+		const FRotator Rotator(10.0f + KeyIndex, 40.0f + 2.0f * KeyIndex, -70.0f + 3.0f * KeyIndex);
+		Transforms.Add(FTransform(Rotator, FVector(KeyIndex, KeyIndex * 2.0f, -KeyIndex), FVector(1.0f + 0.1f * KeyIndex, 1.0f + 0.2f * KeyIndex, 1.0f + 0.3f * KeyIndex)));
+	}
+
+	const FName VectorCurveName(TEXT("TestVectorCurve"));
+	const FName TransformCurveName(TEXT("TestTransformCurve"));
+	UAnimSequence* AnimationSequence = CreateSequence(31);
+
+	UAnimBlueprintLibrary::AddCurve(AnimationSequence, VectorCurveName, ERawCurveTrackTypes::RCT_Vector, false);
+	FVectorCurve* VectorCurve = FindRawCurve<FVectorCurve>(AnimationSequence, VectorCurveName, ERawCurveTrackTypes::RCT_Vector);
+	if (TestNotNull(TEXT("Vector curve"), VectorCurve))
+	{
+		for (const float Time : ExistingTimes)
+		{
+			VectorCurve->UpdateOrAddKey(FVector(Time, 1.0f, -1.0f), Time);
+		}
+		SetUserTangents(*VectorCurve);
+
+		FVectorCurve Expected = *VectorCurve;
+		AddRawCurveKeysPerKey(Expected, Times, Vectors, CIM_CurveUser);
+		UAnimBlueprintLibrary::AddVectorCurveKeysWithType(AnimationSequence, VectorCurveName, Times, Vectors, CIM_CurveUser);
+		TestChannelsMatch(*this, TEXT("Vector"), *FindRawCurve<FVectorCurve>(AnimationSequence, VectorCurveName, ERawCurveTrackTypes::RCT_Vector), Expected);
+	}
+
+	UAnimBlueprintLibrary::AddCurve(AnimationSequence, TransformCurveName, ERawCurveTrackTypes::RCT_Transform, false);
+	FTransformCurve* TransformCurve = FindRawCurve<FTransformCurve>(AnimationSequence, TransformCurveName, ERawCurveTrackTypes::RCT_Transform);
+	if (TestNotNull(TEXT("Transform curve"), TransformCurve))
+	{
+		for (const float Time : ExistingTimes)
+		{
+			TransformCurve->UpdateOrAddKey(FTransform(FRotator(5.0f, -5.0f, 15.0f), FVector(Time, 0.0f, 0.0f)), Time);
+		}
+		SetUserTangents(*TransformCurve);
+
+		FTransformCurve Expected = *TransformCurve;
+		AddRawCurveKeysPerKey(Expected, Times, Transforms, CIM_CurveUser);
+		UAnimBlueprintLibrary::AddTransformationCurveKeysWithType(AnimationSequence, TransformCurveName, Times, Transforms, CIM_CurveUser);
+
+		FTransformCurve& Merged = *FindRawCurve<FTransformCurve>(AnimationSequence, TransformCurveName, ERawCurveTrackTypes::RCT_Transform);
+		TestChannelsMatch(*this, TEXT("Transform"), Merged, Expected);
+
+		// The rotation channels hold roll, pitch and yaw in that order
+		const FRotator Rotator = Transforms[0].GetRotation().Rotator();
+		TestEqual(TEXT("Rotation X is roll"), Merged.RotationCurve.FloatCurves[0].Eval(Times[0]), static_cast<float>(Rotator.Roll), 1e-3f);
+		TestEqual(TEXT("Rotation Y is pitch"), Merged.RotationCurve.FloatCurves[1].Eval(Times[0]), static_cast<float>(Rotator.Pitch), 1e-3f);
+		TestEqual(TEXT("Rotation Z is yaw"), Merged.RotationCurve.FloatCurves[2].Eval(Times[0]), static_cast<float>(Rotator.Yaw), 1e-3f);
+	}
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveKeyReductionTest, "BRPlugins.AnimModifier.CurveKeys.ReducedWithinMaxError", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimCurveKeyReductionTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimCurveKeyTests;
+
+	UAnimSequence* AnimationSequence = CreateSequence(301);
+	FFloatCurve* Curve = FindFloatCurve(AnimationSequence);
+	if (!TestNotNull(TEXT("Float curve"), Curve))
+	{
+		AnimTestSequence::Destroy(AnimationSequence);
+		return false;
+	}
+
+	// Pre-existing cubic keys with steep user tangents inside and outside the range the reduced keys cover
+	const float OutsideTime = 11.0f;
+	for (float Time = 0.05f; Time < 12.0f; Time += 0.37f)
+	{
+		FRichCurveKey& Key = Curve->FloatCurve.GetKey(Curve->FloatCurve.AddKey(Time, 3.0f));
+		Key.InterpMode = RCIM_Cubic;
+		Key.TangentMode = RCTM_User;
+		Key.ArriveTangent = 40.0f;
+		Key.LeaveTangent = -40.0f;
+	}
+	Curve->FloatCurve.UpdateOrAddKey(OutsideTime, 3.0f);
+
+	// Dense per frame signal over the first ten seconds
+	TArray<float> Times, Values;
+	for (int32 Frame = 0; Frame <= 300; ++Frame)
+	{
+		Times.Add(Frame / 30.0f);
+		Values.Add(FMath::Sin(Frame * 0.07f) + 0.25f * FMath::Sin(Frame * 0.31f));
+	}
+
+	FAnimCurveReductionSettings Reduction;
+	Reduction.bEnabled = true;
+	Reduction.MaxError = 0.01f;
+
+	FAnimCurveReductionReport Report;
+	UAnimBlueprintLibrary::AddFloatCurveKeysWithReduction(AnimationSequence, CurveName, Times, Values, CIM_Linear, Reduction, Report);
+	TestTrue(TEXT("Keys were reduced"), Report.ReducedKeyCount < Report.OriginalKeyCount);
+
+	const FRichCurve& Result = FindFloatCurve(AnimationSequence)->FloatCurve;
+	float MaxError = 0.0f;
+	for (int32 Frame = 0; Frame < Times.Num(); ++Frame)
+	{
+		MaxError = FMath::Max(MaxError, FMath::Abs(Result.Eval(Times[Frame]) - Values[Frame]));
+	}
+	AddInfo(FString::Printf(TEXT("%d keys reduced to %d, max error %f"), Report.OriginalKeyCount, Report.ReducedKeyCount, MaxError));
+	TestTrue(FString::Printf(TEXT("Max error %f within %f"), MaxError, Reduction.MaxError), MaxError <= Reduction.MaxError + KINDA_SMALL_NUMBER);
+
+	TestEqual(TEXT("Key outside the written range is kept"), Result.Eval(OutsideTime), 3.0f, KINDA_SMALL_NUMBER);
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveKeyReductionModeTest, "BRPlugins.AnimModifier.CurveKeys.ReductionKeepsInterpMode", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimCurveKeyReductionModeTest::RunTest(const FString& Parameters)
+{
+	FAnimCurveReductionSettings Reduction;
+	Reduction.bEnabled = true;
+	Reduction.MaxError = 0.01f;
+
+	for (const EInterpCurveMode InterpMode : { CIM_Constant, CIM_Linear, CIM_CurveAuto, CIM_CurveUser, CIM_CurveBreak })
+	{
+		ERichCurveInterpMode KeyInterpMode;
+		ERichCurveTangentMode KeyTangentMode;
+		UAnimBlueprintLibrary::ConvertInterpMode(InterpMode, KeyInterpMode, KeyTangentMode);
+
+		TArray<FRichCurveKey> Keys;
+		for (int32 Frame = 0; Frame <= 300; ++Frame)
+		{
+			FRichCurveKey& Key = Keys.Emplace_GetRef(Frame / 30.0f, FMath::Sin(Frame * 0.07f) + 0.25f * FMath::Sin(Frame * 0.31f));
+			Key.InterpMode = KeyInterpMode;
+			Key.TangentMode = KeyTangentMode;
+		}
+		const TArray<FRichCurveKey> InputKeys = Keys;
+
+		FAnimCurveReductionReport Report;
+		AnimCurveReduction::ReduceKeys(Keys, Reduction, Report);
+
+		bool bModesKept = true;
+		for (const FRichCurveKey& Key : Keys)
+		{
+			bModesKept &= Key.InterpMode <= KeyInterpMode && Key.TangentMode == KeyTangentMode;
+		}
+		TestTrue(FString::Printf(TEXT("Mode %d keys are no richer than %d and keep tangent mode %d"), int32(InterpMode), int32(KeyInterpMode), int32(KeyTangentMode)), bModesKept);
+
+		// Measured on the curve as it is set, with its tangents recomputed
+		FRichCurve Curve;
+		Curve.SetKeys(Keys);
+		float MaxError = 0.0f;
+		for (const FRichCurveKey& InputKey : InputKeys)
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(Curve.Eval(InputKey.Time) - InputKey.Value));
+		}
+		AddInfo(FString::Printf(TEXT("Mode %d: %d keys reduced to %d, max error %f"), int32(InterpMode), Report.OriginalKeyCount, Report.ReducedKeyCount, MaxError));
+		TestTrue(FString::Printf(TEXT("Mode %d reduced"), int32(InterpMode)), Report.ReducedKeyCount < Report.OriginalKeyCount);
+		TestTrue(FString::Printf(TEXT("Mode %d max error %f within %f"), int32(InterpMode), MaxError, Reduction.MaxError), MaxError <= Reduction.MaxError);
+		TestEqual(FString::Printf(TEXT("Mode %d reported max error"), int32(InterpMode)), Report.MaxError, MaxError);
+	}
+
+	// Two keys left after collapsing the duplicate times are reported as two
+	TArray<FRichCurveKey> ShortKeys = { FRichCurveKey(0.0f, 1.0f), FRichCurveKey(0.0f, 2.0f), FRichCurveKey(1.0f, 3.0f) };
+	FAnimCurveReductionReport ShortReport;
+	AnimCurveReduction::ReduceKeys(ShortKeys, Reduction, ShortReport);
+	TestEqual(TEXT("Collapsed original key count"), ShortReport.OriginalKeyCount, 3);
+	TestEqual(TEXT("Collapsed reduced key count"), ShortReport.ReducedKeyCount, 2);
+	if (TestEqual(TEXT("Collapsed keys"), ShortKeys.Num(), 2))
+	{
+		TestEqual(TEXT("Last duplicate wins"), ShortKeys[0].Value, 2.0f);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveBatchStaleTest, "BRPlugins.AnimModifier.CurveKeys.StaleBatchIsClosed", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimCurveBatchStaleTest::RunTest(const FString& Parameters)
+{
+	// A modifier script that returns between its BeginCurveBatch and EndCurveBatch
+	AddExpectedError(TEXT("BeginCurveBatch without a matching EndCurveBatch"), EAutomationExpectedErrorFlags::Contains, 1);
+	{
+		FAnimCurveBatchScope BatchScope;
+		UAnimBlueprintLibrary::BeginCurveBatch();
+	}
+
+	// Nothing is left open, so curve edits bake right away again
+	AddExpectedError(TEXT("EndCurveBatch called without a matching BeginCurveBatch"), EAutomationExpectedErrorFlags::Contains, 1);
+	UAnimBlueprintLibrary::EndCurveBatch();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveKeyScalingTest, "BRPlugins.AnimModifier.CurveKeys.Scaling", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FAnimCurveKeyScalingTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimCurveKeyTests;
+
+	for (const int32 NumKeys : { 100, 1000, 10000, 100000 })
+	{
+		TArray<float> Times, Values;
+		Times.SetNumUninitialized(NumKeys);
+		Values.SetNumUninitialized(NumKeys);
+		for (int32 KeyIndex = 0; KeyIndex < NumKeys; ++KeyIndex)
+		{
+			Times[KeyIndex] = KeyIndex / 30.0f;
+			Values[KeyIndex] = FMath::Sin(KeyIndex * 0.1f);
+		}
+
+		FRichCurve PerKeyCurve;
+		const double PerKeyStart = FPlatformTime::Seconds();
+		AddKeysPerKey(PerKeyCurve, Times, Values, CIM_Linear);
+		const double PerKeySeconds = FPlatformTime::Seconds() - PerKeyStart;
+
+		UAnimSequence* AnimationSequence = CreateSequence(NumKeys);
+		double MergedSeconds;
+		{
+			// Bake is timed out, it is the same for both paths
+			FAnimCurveBatchScope BatchScope;
+			const double MergedStart = FPlatformTime::Seconds();
+			UAnimBlueprintLibrary::AddFloatCurveKeysWithType(AnimationSequence, CurveName, Times, Values, CIM_Linear);
+			MergedSeconds = FPlatformTime::Seconds() - MergedStart;
+		}
+
+		const FFloatCurve* Curve = FindFloatCurve(AnimationSequence);
+		TestEqual(FString::Printf(TEXT("%d keys written"), NumKeys), Curve ? Curve->FloatCurve.GetNumKeys() : 0, PerKeyCurve.GetNumKeys());
+		AnimTestSequence::Destroy(AnimationSequence);
+
+		AddInfo(FString::Printf(TEXT("%6d keys: per key %8.2f ms, merged %8.2f ms (%.1fx)"), NumKeys, PerKeySeconds * 1000.0, MergedSeconds * 1000.0, PerKeySeconds / FMath::Max(MergedSeconds, 1e-9)));
+
+		// The per key loop is quadratic, at this size the merge has to win by a wide margin on any machine
+		if (NumKeys == 100000)
+		{
+			TestTrue(TEXT("Merged path is faster at 100k keys"), MergedSeconds < PerKeySeconds);
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+#include "Tests/AnimTestSequence.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+
+namespace AnimCurveLUTTests
+{
+	static const FFloatCurve* FindFloatCurve(const UAnimSequence* AnimationSequence, FName CurveName)
+	{
+		FSmartName SmartName;
+		if (!AnimationSequence->GetSkeleton()->GetSmartNameByName(USkeleton::AnimCurveMappingName, CurveName, SmartName))
+		{
+			return nullptr;
+		}
+		return static_cast<const FFloatCurve*>(AnimationSequence->RawCurveData.GetCurveData(SmartName.UID, ERawCurveTrackTypes::RCT_Float));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveLUTInvalidTest, "BRPlugins.AnimModifier.CurveLUT.InvalidIsZero", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimCurveLUTInvalidTest::RunTest(const FString& Parameters)
+{
+	// Curve count set but nothing baked, as a LUT property edited by hand would be
+	FAnimCurveLUT LUT;
+	LUT.NumCurves = 3;
+	LUT.Stride = 4;
+
+	TArray<float> Values = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+	UAnimBlueprintLibrary::EvaluateCurveLUT(LUT, 0.5f, Values);
+	TestTrue(TEXT("Invalid table evaluates to zeros"), Values == TArray<float>({ 0.0f, 0.0f, 0.0f }));
+
+	float RawValues[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+	LUT.Evaluate(0.5f, RawValues);
+	TestTrue(TEXT("Invalid table writes zeros"), RawValues[0] == 0.0f && RawValues[1] == 0.0f && RawValues[2] == 0.0f && RawValues[3] == 0.0f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimCurveLUTBenchmark, "BRPlugins.AnimModifier.CurveLUT.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FAnimCurveLUTBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace AnimCurveLUTTests;
+
+	const int32 NumCurves = 24;
+	const int32 NumKeys = 301;
+	const int32 NumEvaluations = 100000;
+	const int32 NumErrorSamples = 10000;
+
+	USkeleton* Skeleton = AnimTestSequence::CreateSkeleton({});
+	UAnimSequence* AnimationSequence = AnimTestSequence::CreateSequence(Skeleton, NumKeys, FFrameRate(30, 1), [](FName, int32) { return FTransform::Identity; });
+
+	// Cubic curves of different frequencies and ranges, like a face or cloth rig would export
+	TArray<FName> CurveNames;
+	{
+		FAnimCurveBatchScope BatchScope;
+		TArray<float> Times, Values;
+		Times.SetNumUninitialized(NumKeys);
+		Values.SetNumUninitialized(NumKeys);
+		for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+		{
+			const FName CurveName(*FString::Printf(TEXT("LUTCurve%02d"), CurveIndex));
+			const float Frequency = 0.5f + CurveIndex * 0.25f;
+			const float Amplitude = 1.0f + CurveIndex * 0.5f;
+			for (int32 KeyIndex = 0; KeyIndex < NumKeys; ++KeyIndex)
+			{
+				Times[KeyIndex] = KeyIndex / 30.0f;
+				Values[KeyIndex] = Amplitude * FMath::Sin(Times[KeyIndex] * Frequency * 2.0f * PI);
+			}
+
+			UAnimBlueprintLibrary::AddCurve(AnimationSequence, CurveName, ERawCurveTrackTypes::RCT_Float, false);
+			UAnimBlueprintLibrary::AddFloatCurveKeysWithType(AnimationSequence, CurveName, Times, Values, CIM_CurveAuto);
+			CurveNames.Add(CurveName);
+		}
+	}
+
+	TArray<const FRichCurve*> Curves;
+	for (const FName CurveName : CurveNames)
+	{
+		const FFloatCurve* Curve = FindFloatCurve(AnimationSequence, CurveName);
+		Curves.Add(Curve ? &Curve->FloatCurve : nullptr);
+	}
+
+	for (const bool bAllowQuantization : { false, true })
+	{
+		FAnimCurveLUTSettings Settings;
+		Settings.bAllowQuantization = bAllowQuantization;
+
+		FAnimCurveLUT LUT;
+		FAnimCurveLUTReport Report;
+		UAnimBlueprintLibrary::BakeFloatCurvesToLUT(AnimationSequence, CurveNames, Settings, LUT, Report);
+		if (!TestTrue(TEXT("Table was baked"), LUT.IsValid() && LUT.NumCurves == NumCurves))
+		{
+			break;
+		}
+
+		const FAnimCurveLUTTiming Timing = UAnimBlueprintLibrary::MeasureCurveLUTEvaluation(AnimationSequence, CurveNames, LUT, NumEvaluations);
+
+		// Independent of the midpoints the builder checks
+		FRandomStream RandomStream(0x4C5554);
+		const float EndTime = (NumKeys - 1) / 30.0f;
+		TArray<float> Values;
+		float MaxError = 0.0f;
+		for (int32 Sample = 0; Sample < NumErrorSamples; ++Sample)
+		{
+			const float Time = RandomStream.FRandRange(0.0f, EndTime);
+			UAnimBlueprintLibrary::EvaluateCurveLUT(LUT, Time, Values);
+			for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+			{
+				if (Curves[CurveIndex])
+				{
+					MaxError = FMath::Max(MaxError, FMath::Abs(Values[CurveIndex] - Curves[CurveIndex]->Eval(Time)));
+				}
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("%d curves, %d samples at %.0f Hz%s, %.1f KB: LUT %.2f ns, FRichCurve::Eval %.2f ns per curve (%.1fx), max error %.6f at midpoints, %.6f at random times"),
+			NumCurves, Report.NumSamples, Report.SampleRate, Report.bQuantized ? TEXT(" quantized") : TEXT(""), Report.NumBytes / 1024.0f,
+			Timing.LUTNanosecondsPerCurve, Timing.RichCurveNanosecondsPerCurve, Timing.Speedup, Report.MaxError, MaxError));
+		TestTrue(TEXT("Evaluation was timed"), Timing.LUTNanosecondsPerCurve > 0.0f && Timing.RichCurveNanosecondsPerCurve > 0.0f);
+		// The 6.25 Hz curves need well above the default 120 Hz to stay within the budget, Build raises the rate until they do
+		TestTrue(FString::Printf(TEXT("Sample rate %.0f raised above %.0f"), Report.SampleRate, Settings.SampleRate), Report.SampleRate > Settings.SampleRate);
+		TestTrue(FString::Printf(TEXT("Reported max error %f within %f"), Report.MaxError, Settings.MaxError), Report.MaxError <= Settings.MaxError);
+	}
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+#endif
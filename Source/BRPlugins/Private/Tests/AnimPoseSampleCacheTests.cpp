@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+#include "Editor/AnimModifier/AnimPoseSampleCache.h"
+#include "Editor/AnimModifier/AnimPoseSampling.h"
+#include "Tests/AnimTestSequence.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimData/IAnimationDataController.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimPoseSampleCacheEditTest, "BRPlugins.AnimModifier.PoseSampleCache.DropsEditedTracks", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimPoseSampleCacheEditTest::RunTest(const FString& Parameters)
+{
+	static const FName FootBone(TEXT("foot_l"));
+	const int32 NumKeys = 11;
+
+	USkeleton* Skeleton = AnimTestSequence::CreateSkeleton(MakeArrayView(&FootBone, 1));
+	UAnimSequence* AnimationSequence = AnimTestSequence::CreateSequence(Skeleton, NumKeys, FFrameRate(30, 1), [](FName, int32 Key)
+	{
+		return FTransform(FVector(0.0f, 0.0f, Key));
+	});
+
+	{
+		FAnimPoseSampleCacheScope CacheScope;
+
+		const FAnimPoseSamplesPtr Before = FAnimPoseSampleCache::Get().FindOrSample(AnimationSequence, MakeArrayView(&FootBone, 1));
+		TestTrue(TEXT("Second lookup is served by the cache"), FAnimPoseSampleCache::Get().FindOrSample(AnimationSequence, MakeArrayView(&FootBone, 1)) == Before);
+
+		// Raise the foot by 100 inside the open scope, like a serial modifier of a batch run would
+		TArray<FVector3f> PositionKeys, ScaleKeys;
+		TArray<FQuat4f> RotationKeys;
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			PositionKeys.Add(FVector3f(0.0f, 0.0f, Key + 100.0f));
+			RotationKeys.Add(FQuat4f::Identity);
+			ScaleKeys.Add(FVector3f::OneVector);
+		}
+		AnimationSequence->GetController().SetBoneTrackKeys(FootBone, PositionKeys, RotationKeys, ScaleKeys, false);
+
+		const FAnimPoseSamplesPtr After = FAnimPoseSampleCache::Get().FindOrSample(AnimationSequence, MakeArrayView(&FootBone, 1));
+		if (TestTrue(TEXT("Edited sequence is sampled again"), After.IsValid() && After != Before))
+		{
+			TestEqual(TEXT("Sampled height after the edit"), After->GetPositionZ(After->FindBone(FootBone))[NumKeys - 1], NumKeys - 1 + 100.0f);
+		}
+	}
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimPoseSampleCacheBudgetTest, "BRPlugins.AnimModifier.PoseSampleCache.EvictsToBudget", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimPoseSampleCacheBudgetTest::RunTest(const FString& Parameters)
+{
+	static const FName FootBone(TEXT("foot_l"));
+	const int32 BudgetMegaBytes = 1;
+	const int64 BudgetBytes = BudgetMegaBytes * 1024 * 1024;
+
+	// Around 110 KB of samples per sequence, so 16 of them need twice the budget
+	const int32 NumKeys = 4000;
+	const int32 NumSequences = 16;
+
+	USkeleton* Skeleton = AnimTestSequence::CreateSkeleton(MakeArrayView(&FootBone, 1));
+	TArray<UAnimSequence*> AnimationSequences;
+	for (int32 SequenceIndex = 0; SequenceIndex < NumSequences; ++SequenceIndex)
+	{
+		AnimationSequences.Add(AnimTestSequence::CreateSequence(Skeleton, NumKeys, FFrameRate(30, 1), [SequenceIndex](FName, int32 Key)
+		{
+			return FTransform(FVector(SequenceIndex, 0.0f, Key));
+		}));
+	}
+
+	const int64 PreviousBudgetBytes = FAnimPoseSampleCache::Get().GetBudgetBytes();
+	UAnimBlueprintLibrary::SetPoseSampleCacheBudget(BudgetMegaBytes);
+	UAnimBlueprintLibrary::ResetPoseSampleCacheStats();
+
+	{
+		FAnimPoseSampleCacheScope CacheScope;
+
+		for (UAnimSequence* AnimationSequence : AnimationSequences)
+		{
+			TestTrue(TEXT("Sampled"), FAnimPoseSampleCache::Get().FindOrSample(AnimationSequence, MakeArrayView(&FootBone, 1)).IsValid());
+
+			const FAnimPoseSampleCacheStats Stats = UAnimBlueprintLibrary::GetPoseSampleCacheStats();
+			TestTrue(FString::Printf(TEXT("%lld bytes cached within the budget of %lld"), Stats.AllocatedBytes, BudgetBytes), Stats.AllocatedBytes <= BudgetBytes);
+		}
+
+		FAnimPoseSampleCacheStats Stats = UAnimBlueprintLibrary::GetPoseSampleCacheStats();
+		TestEqual(TEXT("Every first lookup misses"), Stats.Misses, NumSequences);
+		TestTrue(TEXT("Sequences past the budget evict older ones"), Stats.Evictions > 0);
+		TestTrue(TEXT("Cache is filled close to the budget"), Stats.AllocatedBytes > BudgetBytes / 2);
+
+		// The most recent sequence is still cached, the least recently used one was evicted first
+		FAnimPoseSampleCache::Get().FindOrSample(AnimationSequences.Last(), MakeArrayView(&FootBone, 1));
+		TestEqual(TEXT("Most recently used sequence is a hit"), UAnimBlueprintLibrary::GetPoseSampleCacheStats().Hits, 1);
+
+		FAnimPoseSampleCache::Get().FindOrSample(AnimationSequences[0], MakeArrayView(&FootBone, 1));
+		Stats = UAnimBlueprintLibrary::GetPoseSampleCacheStats();
+		TestEqual(TEXT("Least recently used sequence was evicted"), Stats.Misses, NumSequences + 1);
+		TestTrue(TEXT("Still within the budget"), Stats.AllocatedBytes <= BudgetBytes);
+		TestEqual(TEXT("Hit rate"), Stats.HitRate, 1.0f / (NumSequences + 2));
+	}
+
+	TestEqual(TEXT("Closing the scope frees every entry"), UAnimBlueprintLibrary::GetPoseSampleCacheStats().AllocatedBytes, int64(0));
+
+	FAnimPoseSampleCache::Get().SetBudgetBytes(PreviousBudgetBytes);
+	for (UAnimSequence* AnimationSequence : AnimationSequences)
+	{
+		AnimTestSequence::Destroy(AnimationSequence);
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Editor/AnimModifier/AnimBlueprintLibrary.h"
+#include "Tests/AnimTestSequence.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimData/AnimDataModel.h"
+
+namespace AnimRootMotionAnalysisTests
+{
+	static const FFrameRate FrameRate(30, 1);
+
+	/** Required speedup over the per frame path the Blueprint version takes */
+	static const double RequiredSpeedup = 10.0;
+
+	/** Circles the origin once every two seconds while the facing sways, the heading crosses -180/180 every lap */
+	static UAnimSequence* CreateCircleSequence(int32 NumKeys)
+	{
+		USkeleton* Skeleton = AnimTestSequence::CreateSkeleton({});
+		return AnimTestSequence::CreateSequence(Skeleton, NumKeys, FrameRate, [](FName, int32 Key)
+		{
+			const float Angle = 2.0f * PI * Key / 60.0f;
+			const FRotator Facing(0.0f, 40.0f * FMath::Sin(Angle * 0.5f), 0.0f);
+			return FTransform(Facing, FVector(200.0f * FMath::Cos(Angle), 200.0f * FMath::Sin(Angle), 0.0f));
+		});
+	}
+
+	/**
+	 * The curves computed the way the Blueprint version does, one root pose per frame through the animation blueprint library.
+	 * RootMotionDirections.uasset only holds that Blueprint's axis enum, so this is the reference for correctness and timing
+	 */
+	static void ComputePerFrame(UAnimSequence* AnimationSequence, const FRootMotionDirectionSettings& Settings, TArray<float>& OutHeading, TArray<float>& OutSpeed, TArray<float>& OutTurnRate)
+	{
+		const int32 NumKeys = AnimationSequence->GetDataModel()->GetNumberOfKeys();
+		const float InvDeltaTime = static_cast<float>(FrameRate.AsDecimal());
+
+		TArray<FTransform> Poses;
+		Poses.SetNum(NumKeys);
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			UAnimationBlueprintLibrary::GetBonePoseForFrame(AnimationSequence, TEXT("root"), Key, false, Poses[Key]);
+		}
+
+		TArray<float> FacingYaw;
+		FacingYaw.SetNum(NumKeys);
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			const float Yaw = static_cast<float>(Poses[Key].Rotator().Yaw);
+			FacingYaw[Key] = Key > 0 ? FacingYaw[Key - 1] + FMath::UnwindDegrees(Yaw - FacingYaw[Key - 1]) : Yaw;
+		}
+
+		OutHeading.SetNum(NumKeys);
+		OutSpeed.SetNum(NumKeys);
+		OutTurnRate.SetNum(NumKeys);
+
+		float HeldHeading = 0.0f;
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			const int32 Previous = FMath::Max(Key - 1, 0);
+			const int32 Next = FMath::Min(Key + 1, NumKeys - 1);
+			const float Scale = InvDeltaTime / (Next - Previous);
+
+			const FVector Velocity = (Poses[Next].GetTranslation() - Poses[Previous].GetTranslation()) * Scale;
+			OutSpeed[Key] = static_cast<float>(Velocity.Size2D());
+			OutTurnRate[Key] = (FacingYaw[Next] - FacingYaw[Previous]) * Scale;
+
+			if (OutSpeed[Key] >= Settings.MinSpeed)
+			{
+				const float MoveYaw = FMath::RadiansToDegrees(FMath::Atan2(static_cast<float>(Velocity.Y), static_cast<float>(Velocity.X)));
+				HeldHeading = FMath::UnwindDegrees(Settings.bHeadingRelativeToFacing ? MoveYaw - FacingYaw[Key] : MoveYaw);
+			}
+			OutHeading[Key] = Key > 0 ? OutHeading[Key - 1] + FMath::UnwindDegrees(HeldHeading - OutHeading[Key - 1]) : HeldHeading;
+		}
+	}
+
+	/** ComputePerFrame plus the per curve writes of the Blueprint version */
+	static void WritePerFrame(UAnimSequence* AnimationSequence, const FRootMotionDirectionSettings& Settings)
+	{
+		TArray<float> Heading, Speed, TurnRate;
+		ComputePerFrame(AnimationSequence, Settings, Heading, Speed, TurnRate);
+
+		TArray<float> Times;
+		for (int32 Key = 0; Key < Heading.Num(); ++Key)
+		{
+			Times.Add(static_cast<float>(FrameRate.AsSeconds(Key)));
+		}
+
+		const TPair<FName, const TArray<float>*> Curves[] = { { Settings.HeadingCurveName, &Heading }, { Settings.SpeedCurveName, &Speed }, { Settings.TurnRateCurveName, &TurnRate } };
+		for (const TPair<FName, const TArray<float>*>& Curve : Curves)
+		{
+			UAnimationBlueprintLibrary::AddCurve(AnimationSequence, Curve.Key, ERawCurveTrackTypes::RCT_Float, false);
+			UAnimationBlueprintLibrary::AddFloatCurveKeys(AnimationSequence, Curve.Key, Times, *Curve.Value);
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimRootMotionAnalysisToleranceTest, "BRPlugins.AnimModifier.RootMotion.MatchesPerFrame", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimRootMotionAnalysisToleranceTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimRootMotionAnalysisTests;
+
+	const FRootMotionDirectionSettings Settings;
+	UAnimSequence* AnimationSequence = CreateCircleSequence(121);
+
+	TArray<float> ExpectedHeading, ExpectedSpeed, ExpectedTurnRate;
+	ComputePerFrame(AnimationSequence, Settings, ExpectedHeading, ExpectedSpeed, ExpectedTurnRate);
+	if (!TestEqual(TEXT("Per frame reference key count"), ExpectedHeading.Num(), 121))
+	{
+		AnimTestSequence::Destroy(AnimationSequence);
+		return false;
+	}
+
+	UAnimBlueprintLibrary::AddRootMotionDirectionCurves(AnimationSequence, Settings);
+
+	const TPair<FName, const TArray<float>*> Curves[] = { { Settings.HeadingCurveName, &ExpectedHeading }, { Settings.SpeedCurveName, &ExpectedSpeed }, { Settings.TurnRateCurveName, &ExpectedTurnRate } };
+	for (const TPair<FName, const TArray<float>*>& Curve : Curves)
+	{
+		TArray<float> Times, Values;
+		AnimTestSequence::GetFloatKeys(AnimationSequence, Curve.Key, Times, Values);
+		if (!TestEqual(FString::Printf(TEXT("%s key count"), *Curve.Key.ToString()), Values.Num(), Curve.Value->Num()))
+		{
+			continue;
+		}
+
+		float MaxError = 0.0f;
+		for (int32 Key = 0; Key < Values.Num(); ++Key)
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(Values[Key] - (*Curve.Value)[Key]));
+		}
+		TestTrue(FString::Printf(TEXT("%s within %.3f of the per frame result (max error %.4f)"), *Curve.Key.ToString(), Settings.Tolerance, MaxError), MaxError <= Settings.Tolerance);
+	}
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimRootMotionAnalysisSeamTest, "BRPlugins.AnimModifier.RootMotion.HeadingContinuous", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAnimRootMotionAnalysisSeamTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimRootMotionAnalysisTests;
+
+	const FRootMotionDirectionSettings Settings;
+	UAnimSequence* AnimationSequence = CreateCircleSequence(121);
+	UAnimBlueprintLibrary::AddRootMotionDirectionCurves(AnimationSequence, Settings);
+
+	// Linear keys across the seam would sweep the wrong way round
+	TArray<float> Times, Heading;
+	AnimTestSequence::GetFloatKeys(AnimationSequence, Settings.HeadingCurveName, Times, Heading);
+	TestEqual(TEXT("Heading key count"), Heading.Num(), 121);
+	for (int32 Key = 1; Key < Heading.Num(); ++Key)
+	{
+		TestTrue(FString::Printf(TEXT("Heading continuous at key %d"), Key), FMath::Abs(Heading[Key] - Heading[Key - 1]) < 180.0f);
+	}
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimRootMotionAnalysisSpeedupTest, "BRPlugins.AnimModifier.RootMotion.Speedup", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FAnimRootMotionAnalysisSpeedupTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimRootMotionAnalysisTests;
+
+	const FRootMotionDirectionSettings Settings;
+	const int32 NumKeys = 3001;
+
+	UAnimSequence* PerFrameSequence = CreateCircleSequence(NumKeys);
+	const double PerFrameStart = FPlatformTime::Seconds();
+	WritePerFrame(PerFrameSequence, Settings);
+	const double PerFrameSeconds = FPlatformTime::Seconds() - PerFrameStart;
+
+	TArray<float> Times, Heading;
+	AnimTestSequence::GetFloatKeys(PerFrameSequence, Settings.HeadingCurveName, Times, Heading);
+	AnimTestSequence::Destroy(PerFrameSequence);
+	if (!TestEqual(TEXT("Per frame reference wrote every key"), Heading.Num(), NumKeys))
+	{
+		return false;
+	}
+
+	UAnimSequence* NativeSequence = CreateCircleSequence(NumKeys);
+	const double NativeStart = FPlatformTime::Seconds();
+	UAnimBlueprintLibrary::AddRootMotionDirectionCurves(NativeSequence, Settings);
+	const double NativeSeconds = FPlatformTime::Seconds() - NativeStart;
+	AnimTestSequence::Destroy(NativeSequence);
+
+	const double Speedup = PerFrameSeconds / FMath::Max(NativeSeconds, 1e-9);
+	AddInfo(FString::Printf(TEXT("%d keys: per frame %.2f ms, native %.2f ms (%.1fx)"), NumKeys, PerFrameSeconds * 1000.0, NativeSeconds * 1000.0, Speedup));
+
+	// The per frame path is the Blueprint's work without its VM overhead, so the bound is conservative
+	TestTrue(FString::Printf(TEXT("At least %.0fx faster than per frame sampling"), RequiredSpeedup), Speedup >= RequiredSpeedup);
+	return true;
+}
+
+#endif
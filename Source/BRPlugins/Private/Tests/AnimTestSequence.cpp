@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Tests/AnimTestSequence.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimData/AnimDataModel.h"
+#include "Animation/AnimData/IAnimationDataController.h"
+#include "Animation/Skeleton.h"
+
+USkeleton* AnimTestSequence::CreateSkeleton(TArrayView<const FName> ChildBones)
+{
+	USkeleton* Skeleton = NewObject<USkeleton>(GetTransientPackage(), NAME_None, RF_Transient);
+	{
+		FReferenceSkeletonModifier Modifier(Skeleton);
+		Modifier.Add(FMeshBoneInfo(TEXT("root"), TEXT("root"), INDEX_NONE), FTransform::Identity);
+		for (const FName BoneName : ChildBones)
+		{
+			Modifier.Add(FMeshBoneInfo(BoneName, BoneName.ToString(), 0), FTransform::Identity);
+		}
+	}
+	return Skeleton;
+}
+
+UAnimSequence* AnimTestSequence::CreateSequence(USkeleton* Skeleton, int32 NumKeys, FFrameRate FrameRate, TFunctionRef<FTransform(FName BoneName, int32 Key)> GetLocalTransform)
+{
+	check(NumKeys > 1);
+
+	UAnimSequence* AnimationSequence = NewObject<UAnimSequence>(GetTransientPackage(), NAME_None, RF_Transient);
+	AnimationSequence->AddToRoot();
+	AnimationSequence->SetSkeleton(Skeleton);
+
+	IAnimationDataController& Controller = AnimationSequence->GetController();
+	Controller.OpenBracket(FText::FromString(TEXT("Generate test sequence")), false);
+	Controller.SetFrameRate(FrameRate, false);
+	Controller.SetPlayLength(static_cast<float>(FrameRate.AsSeconds(NumKeys - 1)), false);
+
+	const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+	TArray<FVector3f> PositionKeys, ScaleKeys;
+	TArray<FQuat4f> RotationKeys;
+	for (int32 BoneIndex = 0; BoneIndex < RefSkeleton.GetNum(); ++BoneIndex)
+	{
+		const FName BoneName = RefSkeleton.GetBoneName(BoneIndex);
+
+		PositionKeys.Reset(NumKeys);
+		RotationKeys.Reset(NumKeys);
+		ScaleKeys.Reset(NumKeys);
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			const FTransform Transform = GetLocalTransform(BoneName, Key);
+			PositionKeys.Add(FVector3f(Transform.GetTranslation()));
+			RotationKeys.Add(FQuat4f(Transform.GetRotation()));
+			ScaleKeys.Add(FVector3f(Transform.GetScale3D()));
+		}
+
+		Controller.AddBoneTrack(BoneName, false);
+		Controller.SetBoneTrackKeys(BoneName, PositionKeys, RotationKeys, ScaleKeys, false);
+	}
+
+	Controller.CloseBracket(false);
+	return AnimationSequence;
+}
+
+void AnimTestSequence::Destroy(UAnimSequence* AnimationSequence)
+{
+	if (AnimationSequence)
+	{
+		AnimationSequence->RemoveFromRoot();
+		AnimationSequence->MarkAsGarbage();
+	}
+}
+
+void AnimTestSequence::GetFloatKeys(const UAnimSequence* AnimationSequence, FName CurveName, TArray<float>& OutTimes, TArray<float>& OutValues)
+{
+	OutTimes.Reset();
+	OutValues.Reset();
+
+	FSmartName SmartName;
+	const USkeleton* Skeleton = AnimationSequence->GetSkeleton();
+	if (!Skeleton || !Skeleton->GetSmartNameByName(USkeleton::AnimCurveMappingName, CurveName, SmartName))
+	{
+		return;
+	}
+
+	if (const FFloatCurve* Curve = static_cast<const FFloatCurve*>(AnimationSequence->RawCurveData.GetCurveData(SmartName.UID, ERawCurveTrackTypes::RCT_Float)))
+	{
+		for (const FRichCurveKey& Key : Curve->FloatCurve.GetConstRefOfKeys())
+		{
+			OutTimes.Add(Key.Time);
+			OutValues.Add(Key.Value);
+		}
+	}
+}
+
+#endif
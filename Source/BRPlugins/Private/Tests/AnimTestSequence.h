@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/FrameRate.h"
+
+class UAnimSequence;
+class USkeleton;
+
+/** Transient skeletons and sequences generated for the animation modifier automation tests */
+namespace AnimTestSequence
+{
+	/** Skeleton with a "root" bone at index 0 and the given bones as its children, all with identity reference poses */
+	USkeleton* CreateSkeleton(TArrayView<const FName> ChildBones);
+
+	/**
+	 * Sequence of NumKeys keys on the skeleton with a track for every bone, keyed from GetLocalTransform(BoneName, Key).
+	 * Rooted until the test drops it with Destroy.
+	 */
+	UAnimSequence* CreateSequence(USkeleton* Skeleton, int32 NumKeys, FFrameRate FrameRate, TFunctionRef<FTransform(FName BoneName, int32 Key)> GetLocalTransform);
+
+	void Destroy(UAnimSequence* AnimationSequence);
+
+	/** Keys of a float curve of the sequence, empty when it does not exist */
+	void GetFloatKeys(const UAnimSequence* AnimationSequence, FName CurveName, TArray<float>& OutTimes, TArray<float>& OutValues);
+}
+
+#endif
@@ -0,0 +1,352 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Editor/AnimModifier/FeetAnimationModifier.h"
+#include "Tests/AnimTestSequence.h"
+
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+#include "UObject/EnumProperty.h"
+
+namespace FeetAnimationModifierTests
+{
+	static const TCHAR* BlueprintModifierPath = TEXT("/BRPlugins/Blueprints/AnimModifiers/FeetAnimationModifierBP.FeetAnimationModifierBP_C");
+
+	static const int32 NumKeys = 61;
+	static const FFrameRate FrameRate(30, 1);
+
+	/** Step cycle of a second along +Y, each foot is planted for half of it and swings forward and back for the other half */
+	static FVector GetFootLocation(FName BoneName, int32 Key)
+	{
+		const bool bRightFoot = BoneName == TEXT("foot_r");
+		const int32 CycleKey = (Key + (bRightFoot ? 15 : 0)) % 30;
+		const float Lift = CycleKey < 15 ? 0.0f : FMath::Sin(PI * (CycleKey - 14) / 16.0f);
+		return FVector(bRightFoot ? 15.0f : -15.0f, 20.0f * Lift, 10.0f * Lift);
+	}
+
+	static UAnimSequence* CreateWalkSequence()
+	{
+		static const FName FootBones[] = { TEXT("foot_l"), TEXT("foot_r") };
+		USkeleton* Skeleton = AnimTestSequence::CreateSkeleton(FootBones);
+		return AnimTestSequence::CreateSequence(Skeleton, NumKeys, FrameRate, [](FName BoneName, int32 Key)
+		{
+			return BoneName == TEXT("root") ? FTransform::Identity : FTransform(GetFootLocation(BoneName, Key));
+		});
+	}
+
+	/** Float curves of the sequence by name */
+	static TMap<FName, TArray<float>> GetFloatCurves(UAnimSequence* AnimationSequence)
+	{
+		TMap<FName, TArray<float>> Curves;
+		for (const FFloatCurve& Curve : AnimationSequence->RawCurveData.FloatCurves)
+		{
+			TArray<float> Times;
+			AnimTestSequence::GetFloatKeys(AnimationSequence, Curve.Name.DisplayName, Times, Curves.Add(Curve.Name.DisplayName));
+		}
+		return Curves;
+	}
+
+	static TArray<FAnimSyncMarker> GetSortedSyncMarkers(const UAnimSequence* AnimationSequence)
+	{
+		TArray<FAnimSyncMarker> SyncMarkers = AnimationSequence->AuthoredSyncMarkers;
+		SyncMarkers.Sort([](const FAnimSyncMarker& A, const FAnimSyncMarker& B) { return A.Time < B.Time; });
+		return SyncMarkers;
+	}
+
+	static TArray<float> GetSortedNotifyTimes(const UAnimSequence* AnimationSequence)
+	{
+		TArray<float> Times;
+		for (const FAnimNotifyEvent& Notify : AnimationSequence->Notifies)
+		{
+			Times.Add(Notify.GetTime());
+		}
+		Times.Sort();
+		return Times;
+	}
+
+	/** Copies a Blueprint variable to the native property of the same meaning, numbers are converted between float and double */
+	static void CopyBlueprintProperty(const UObject* Blueprint, const TCHAR* BlueprintName, UObject* Native, const TCHAR* NativeName)
+	{
+		const FProperty* Source = Blueprint->GetClass()->FindPropertyByName(BlueprintName);
+		const FProperty* Target = Native->GetClass()->FindPropertyByName(NativeName);
+		if (!Source || !Target)
+		{
+			return;
+		}
+
+		const void* SourceValue = Source->ContainerPtrToValuePtr<void>(Blueprint);
+		void* TargetValue = Target->ContainerPtrToValuePtr<void>(Native);
+
+		const FNumericProperty* SourceNumber = CastField<FNumericProperty>(Source);
+		const FNumericProperty* TargetNumber = CastField<FNumericProperty>(Target);
+		if (SourceNumber && TargetNumber)
+		{
+			TargetNumber->SetFloatingPointPropertyValue(TargetValue, SourceNumber->GetFloatingPointPropertyValue(SourceValue));
+		}
+		else if (Source->SameType(Target))
+		{
+			Target->CopyCompleteValue(TargetValue, SourceValue);
+		}
+	}
+
+	/**
+	 * Copies the bones of the Blueprint's FeetBones. The native modifier has no per bone Offset,
+	 * so a Blueprint that sets one is rejected instead of compared against different settings
+	 */
+	static bool CopyBlueprintFootBones(FAutomationTestBase& Test, const UObject* Blueprint, UFeetAnimationModifier* Native)
+	{
+		const FArrayProperty* FeetBones = CastField<FArrayProperty>(Blueprint->GetClass()->FindPropertyByName(TEXT("FeetBones")));
+		const FStructProperty* Element = FeetBones ? CastField<FStructProperty>(FeetBones->Inner) : nullptr;
+		if (!Test.TestNotNull(TEXT("FeetAnimationModifierBP FeetBones"), Element))
+		{
+			return false;
+		}
+
+		// User defined struct members carry a GUID suffix, their authored names do not
+		const FNameProperty* BoneProperty = nullptr;
+		const FNumericProperty* OffsetProperty = nullptr;
+		for (TFieldIterator<FProperty> It(Element->Struct); It; ++It)
+		{
+			if (It->GetAuthoredName() == TEXT("Bone"))
+			{
+				BoneProperty = CastField<FNameProperty>(*It);
+			}
+			else if (It->GetAuthoredName() == TEXT("Offset"))
+			{
+				OffsetProperty = CastField<FNumericProperty>(*It);
+			}
+		}
+		if (!Test.TestNotNull(TEXT("BoneModifierST Bone"), BoneProperty))
+		{
+			return false;
+		}
+
+		bool bSupported = true;
+		Native->FootBones.Reset();
+		FScriptArrayHelper Bones(FeetBones, FeetBones->ContainerPtrToValuePtr<void>(Blueprint));
+		for (int32 Index = 0; Index < Bones.Num(); ++Index)
+		{
+			const uint8* Bone = Bones.GetRawPtr(Index);
+			Native->FootBones.Add(BoneProperty->GetPropertyValue_InContainer(Bone));
+
+			const double Offset = OffsetProperty ? OffsetProperty->GetFloatingPointPropertyValue(OffsetProperty->ContainerPtrToValuePtr<void>(Bone)) : 0.0;
+			if (Offset != 0.0)
+			{
+				Test.AddError(FString::Printf(TEXT("FeetBones[%d] has an Offset of %f, the native modifier does not port per bone offsets"), Index, Offset));
+				bSupported = false;
+			}
+		}
+		return bSupported;
+	}
+
+	/** Turns the Blueprint's MotionCheckDirection, an X-Pos to Z-Neg axis enum, into the native direction vector */
+	static bool CopyBlueprintMotionDirection(FAutomationTestBase& Test, const UObject* Blueprint, UFeetAnimationModifier* Native)
+	{
+		const FProperty* Property = Blueprint->GetClass()->FindPropertyByName(TEXT("MotionCheckDirection"));
+		const void* Value = Property ? Property->ContainerPtrToValuePtr<void>(Blueprint) : nullptr;
+
+		const UEnum* Enum = nullptr;
+		int64 EnumValue = 0;
+		if (const FByteProperty* ByteProperty = CastField<FByteProperty>(Property))
+		{
+			Enum = ByteProperty->Enum;
+			EnumValue = ByteProperty->GetPropertyValue(Value);
+		}
+		else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		{
+			Enum = EnumProperty->GetEnum();
+			EnumValue = EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Value);
+		}
+		if (!Test.TestNotNull(TEXT("FeetAnimationModifierBP MotionCheckDirection"), Enum))
+		{
+			return false;
+		}
+
+		const FString Axis = Enum->GetDisplayNameTextByValue(EnumValue).ToString();
+		const FVector Axes[] = { FVector::XAxisVector, FVector::YAxisVector, FVector::ZAxisVector };
+		const int32 AxisIndex = Axis.Len() > 0 ? Axis[0] - TEXT('X') : INDEX_NONE;
+		if (AxisIndex < 0 || AxisIndex > 2)
+		{
+			Test.AddError(FString::Printf(TEXT("Unknown MotionCheckDirection %s"), *Axis));
+			return false;
+		}
+		Native->MotionDirection = Axes[AxisIndex] * (Axis.EndsWith(TEXT("Neg")) ? -1.0 : 1.0);
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFeetAnimationModifierTest, "BRPlugins.AnimModifier.FeetModifier.MatchesReference", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFeetAnimationModifierTest::RunTest(const FString& Parameters)
+{
+	using namespace FeetAnimationModifierTests;
+
+	UAnimSequence* AnimationSequence = CreateWalkSequence();
+	UFeetAnimationModifier* Modifier = NewObject<UFeetAnimationModifier>(GetTransientPackage());
+	Modifier->bCreateAnimNotify = true;
+	Modifier->ApplyToAnimationSequence(AnimationSequence);
+
+	// Scalar reference of the vectorized kernels and the step search
+	TArray<float> ReferencePositions;
+	float MinOffset = TNumericLimits<float>::Max();
+	float MaxOffset = TNumericLimits<float>::Lowest();
+	for (int32 Key = 0; Key < NumKeys; ++Key)
+	{
+		const float Offset = static_cast<float>(FVector::DotProduct(GetFootLocation(TEXT("foot_l"), Key) - GetFootLocation(TEXT("foot_r"), Key), Modifier->MotionDirection.GetSafeNormal()));
+		ReferencePositions.Add(Offset);
+		MinOffset = FMath::Min(MinOffset, Offset);
+		MaxOffset = FMath::Max(MaxOffset, Offset);
+	}
+	for (float& Position : ReferencePositions)
+	{
+		Position = (Position - MinOffset) / (MaxOffset - MinOffset);
+	}
+
+	TArray<float> Times, Positions;
+	AnimTestSequence::GetFloatKeys(AnimationSequence, Modifier->CurveName, Times, Positions);
+	if (TestEqual(TEXT("Feet position key count"), Positions.Num(), NumKeys))
+	{
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			TestEqual(FString::Printf(TEXT("Feet position at key %d"), Key), Positions[Key], ReferencePositions[Key], 1e-4f);
+		}
+	}
+
+	TArray<FAnimSyncMarker> ReferenceMarkers;
+	FName LastMarker = ReferencePositions[0] >= Modifier->StepOnValue ? Modifier->StepOnMarkerName : (ReferencePositions[0] <= Modifier->StepNextValue ? Modifier->StepNextMarkerName : NAME_None);
+	for (int32 Key = 1; Key < NumKeys; ++Key)
+	{
+		const float Previous = ReferencePositions[Key - 1];
+		const float Current = ReferencePositions[Key];
+		for (const TPair<FName, float>& Step : { TPair<FName, float>(Modifier->StepOnMarkerName, Modifier->StepOnValue), TPair<FName, float>(Modifier->StepNextMarkerName, Modifier->StepNextValue) })
+		{
+			const bool bRising = Step.Key == Modifier->StepOnMarkerName;
+			const bool bCrossed = bRising ? (Previous < Step.Value && Current >= Step.Value) : (Previous > Step.Value && Current <= Step.Value);
+			if (bCrossed && LastMarker != Step.Key)
+			{
+				FAnimSyncMarker& Marker = ReferenceMarkers.AddDefaulted_GetRef();
+				Marker.MarkerName = Step.Key;
+				Marker.Time = FMath::Lerp(static_cast<float>(FrameRate.AsSeconds(Key - 1)), static_cast<float>(FrameRate.AsSeconds(Key)), (Step.Value - Previous) / (Current - Previous));
+				LastMarker = Step.Key;
+				break;
+			}
+		}
+	}
+
+	const TArray<FAnimSyncMarker> SyncMarkers = GetSortedSyncMarkers(AnimationSequence);
+	const TArray<float> NotifyTimes = GetSortedNotifyTimes(AnimationSequence);
+	TestTrue(TEXT("Steps were found"), ReferenceMarkers.Num() > 0);
+	if (TestEqual(TEXT("Sync marker count"), SyncMarkers.Num(), ReferenceMarkers.Num()) && TestEqual(TEXT("Notify count"), NotifyTimes.Num(), ReferenceMarkers.Num()))
+	{
+		for (int32 MarkerIndex = 0; MarkerIndex < SyncMarkers.Num(); ++MarkerIndex)
+		{
+			TestEqual(FString::Printf(TEXT("Sync marker %d name"), MarkerIndex), SyncMarkers[MarkerIndex].MarkerName, ReferenceMarkers[MarkerIndex].MarkerName);
+			TestEqual(FString::Printf(TEXT("Sync marker %d time"), MarkerIndex), SyncMarkers[MarkerIndex].Time, ReferenceMarkers[MarkerIndex].Time, 1e-4f);
+			TestEqual(FString::Printf(TEXT("Notify %d time"), MarkerIndex), NotifyTimes[MarkerIndex], ReferenceMarkers[MarkerIndex].Time, 1e-4f);
+		}
+	}
+
+	// Applying again replaces the tracks instead of adding a second set of steps
+	Modifier->ApplyToAnimationSequence(AnimationSequence);
+	TestEqual(TEXT("Sync marker count after a second apply"), AnimationSequence->AuthoredSyncMarkers.Num(), ReferenceMarkers.Num());
+
+	Modifier->RevertFromAnimationSequence(AnimationSequence);
+	TestEqual(TEXT("Sync markers after revert"), AnimationSequence->AuthoredSyncMarkers.Num(), 0);
+	TestEqual(TEXT("Notifies after revert"), AnimationSequence->Notifies.Num(), 0);
+
+	AnimTestSequence::Destroy(AnimationSequence);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFeetAnimationModifierBlueprintTest, "BRPlugins.AnimModifier.FeetModifier.MatchesBlueprint", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFeetAnimationModifierBlueprintTest::RunTest(const FString& Parameters)
+{
+	using namespace FeetAnimationModifierTests;
+
+	UClass* BlueprintModifierClass = LoadClass<UAnimationModifier>(nullptr, BlueprintModifierPath);
+	if (!TestNotNull(TEXT("FeetAnimationModifierBP"), BlueprintModifierClass))
+	{
+		return false;
+	}
+
+	// Both sides run with the Blueprint's defaults for the values that are not derived from the animation
+	const UObject* BlueprintDefaults = BlueprintModifierClass->GetDefaultObject();
+	UFeetAnimationModifier* NativeModifier = NewObject<UFeetAnimationModifier>(GetTransientPackage());
+	if (!CopyBlueprintFootBones(*this, BlueprintDefaults, NativeModifier) || !CopyBlueprintMotionDirection(*this, BlueprintDefaults, NativeModifier))
+	{
+		return false;
+	}
+	CopyBlueprintProperty(BlueprintDefaults, TEXT("StepOnValue"), NativeModifier, TEXT("StepOnValue"));
+	CopyBlueprintProperty(BlueprintDefaults, TEXT("StepNextValue"), NativeModifier, TEXT("StepNextValue"));
+	CopyBlueprintProperty(BlueprintDefaults, TEXT("SyncTrackName"), NativeModifier, TEXT("SyncTrackName"));
+	CopyBlueprintProperty(BlueprintDefaults, TEXT("CreateFootPositionCurve"), NativeModifier, TEXT("bCreateFootPositionCurve"));
+	CopyBlueprintProperty(BlueprintDefaults, TEXT("CreateBonePositionCurve"), NativeModifier, TEXT("bCreateBonePositionCurves"));
+	CopyBlueprintProperty(BlueprintDefaults, TEXT("CreateAnimNotify"), NativeModifier, TEXT("bCreateAnimNotify"));
+	CopyBlueprintProperty(BlueprintDefaults, TEXT("AnimnotifyClass"), NativeModifier, TEXT("NotifyClass"));
+	CopyBlueprintProperty(BlueprintDefaults, TEXT("AnimNotifyTrackName"), NativeModifier, TEXT("NotifyTrackName"));
+
+	UAnimSequence* NativeSequence = CreateWalkSequence();
+	NativeModifier->ApplyToAnimationSequence(NativeSequence);
+	const TMap<FName, TArray<float>> NativeCurves = GetFloatCurves(NativeSequence);
+
+	UAnimSequence* BlueprintSequence = CreateWalkSequence();
+	NewObject<UAnimationModifier>(GetTransientPackage(), BlueprintModifierClass)->ApplyToAnimationSequence(BlueprintSequence);
+	const TMap<FName, TArray<float>> BlueprintCurves = GetFloatCurves(BlueprintSequence);
+
+	// Every curve either side writes has to exist on the other with the same keys
+	TestTrue(TEXT("Blueprint wrote curves"), BlueprintCurves.Num() > 0);
+	TestEqual(TEXT("Curve count"), NativeCurves.Num(), BlueprintCurves.Num());
+	for (const TPair<FName, TArray<float>>& BlueprintCurve : BlueprintCurves)
+	{
+		const TArray<float>* NativeValues = NativeCurves.Find(BlueprintCurve.Key);
+		if (!TestNotNull(FString::Printf(TEXT("Native %s"), *BlueprintCurve.Key.ToString()), NativeValues)
+			|| !TestEqual(FString::Printf(TEXT("%s key count"), *BlueprintCurve.Key.ToString()), NativeValues->Num(), BlueprintCurve.Value.Num()))
+		{
+			continue;
+		}
+
+		for (int32 Key = 0; Key < NativeValues->Num(); ++Key)
+		{
+			TestEqual(FString::Printf(TEXT("%s at key %d"), *BlueprintCurve.Key.ToString(), Key), (*NativeValues)[Key], BlueprintCurve.Value[Key], 1e-4f);
+		}
+	}
+	TestTrue(FString::Printf(TEXT("Blueprint wrote %s"), *NativeModifier->CurveName.ToString()), !NativeModifier->bCreateFootPositionCurve || BlueprintCurves.Contains(NativeModifier->CurveName));
+	AddInfo(FString::Printf(TEXT("%d native curves, %d Blueprint curves"), NativeCurves.Num(), BlueprintCurves.Num()));
+
+	// The Blueprint searches the steps on whole frames, so marker times agree within a frame
+	const float FrameTolerance = static_cast<float>(FrameRate.AsInterval());
+
+	const TArray<FAnimSyncMarker> NativeMarkers = GetSortedSyncMarkers(NativeSequence);
+	const TArray<FAnimSyncMarker> BlueprintMarkers = GetSortedSyncMarkers(BlueprintSequence);
+	TestTrue(TEXT("Blueprint placed sync markers"), BlueprintMarkers.Num() > 0);
+	if (TestEqual(TEXT("Sync marker count"), NativeMarkers.Num(), BlueprintMarkers.Num()))
+	{
+		for (int32 MarkerIndex = 0; MarkerIndex < NativeMarkers.Num(); ++MarkerIndex)
+		{
+			TestEqual(FString::Printf(TEXT("Sync marker %d name"), MarkerIndex), NativeMarkers[MarkerIndex].MarkerName, BlueprintMarkers[MarkerIndex].MarkerName);
+			TestEqual(FString::Printf(TEXT("Sync marker %d time"), MarkerIndex), NativeMarkers[MarkerIndex].Time, BlueprintMarkers[MarkerIndex].Time, FrameTolerance);
+		}
+	}
+
+	const TArray<float> NativeNotifyTimes = GetSortedNotifyTimes(NativeSequence);
+	const TArray<float> BlueprintNotifyTimes = GetSortedNotifyTimes(BlueprintSequence);
+	if (TestEqual(TEXT("Notify count"), NativeNotifyTimes.Num(), BlueprintNotifyTimes.Num()))
+	{
+		for (int32 NotifyIndex = 0; NotifyIndex < NativeNotifyTimes.Num(); ++NotifyIndex)
+		{
+			TestEqual(FString::Printf(TEXT("Notify %d time"), NotifyIndex), NativeNotifyTimes[NotifyIndex], BlueprintNotifyTimes[NotifyIndex], FrameTolerance);
+		}
+	}
+
+	AnimTestSequence::Destroy(NativeSequence);
+	AnimTestSequence::Destroy(BlueprintSequence);
+	return true;
+}
+
+#endif
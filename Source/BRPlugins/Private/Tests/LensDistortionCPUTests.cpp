@@ -0,0 +1,105 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Rendering/LensDistortion.h"
+
+namespace LensDistortionCPUTests
+{
+	static const int32 SizeX = 256;
+	static const int32 SizeY = 144;
+
+	/** Residual the Newton solve is expected to reach, the default TolerancePixels of GenerateLensDistortionMapCPU */
+	static const float TolerancePixels = 0.01f;
+
+	/** Barrel, pincushion and decentered lenses within the range a calibration produces */
+	static TArray<FLensDistortionCameraModel> GetCameraModels()
+	{
+		TArray<FLensDistortionCameraModel> CameraModels;
+
+		FLensDistortionCameraModel& Barrel = CameraModels.AddDefaulted_GetRef();
+		Barrel.K1 = -0.2f;
+		Barrel.K2 = 0.05f;
+		Barrel.Overscan = 1.1f;
+
+		FLensDistortionCameraModel& Pincushion = CameraModels.AddDefaulted_GetRef();
+		Pincushion.K1 = 0.15f;
+		Pincushion.K2 = -0.02f;
+		Pincushion.K3 = 0.005f;
+
+		FLensDistortionCameraModel& Decentered = CameraModels.AddDefaulted_GetRef();
+		Decentered.K1 = -0.1f;
+		Decentered.P1 = 0.002f;
+		Decentered.P2 = -0.001f;
+		Decentered.F = FVector2D(1.05f, 1.8f);
+		Decentered.C = FVector2D(0.52f, 0.48f);
+
+		return CameraModels;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLensDistortionCPUTest, "BRPlugins.Rendering.LensDistortionCPU.MatchesScalarModel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FLensDistortionCPUTest::RunTest(const FString& Parameters)
+{
+	using namespace LensDistortionCPUTests;
+
+	const TArray<FLensDistortionCameraModel> CameraModels = GetCameraModels();
+	for (int32 ModelIndex = 0; ModelIndex < CameraModels.Num(); ++ModelIndex)
+	{
+		const FLensDistortionCameraModel& CameraModel = CameraModels[ModelIndex];
+
+		TArray<FVector4f> Displacement;
+		FLensDistortionMapReport Report;
+		SimpleRenderingExample::GenerateLensDistortionMapCPU(CameraModel, SizeX, SizeY, Displacement, Report);
+		if (!TestEqual(FString::Printf(TEXT("Model %d texel count"), ModelIndex), Displacement.Num(), SizeX * SizeY))
+		{
+			continue;
+		}
+
+		// The scalar UndistortViewportUV is the reference for both halves, independently of the vector kernel the solve runs on
+		float MaxForwardError = 0.0f;
+		float MaxResidualPixels = 0.0f;
+		int32 NumUnconverged = 0;
+		for (int32 Y = 0; Y < SizeY; ++Y)
+		{
+			for (int32 X = 0; X < SizeX; ++X)
+			{
+				const FVector2f ViewportUV(static_cast<float>(X) / SizeX, static_cast<float>(Y) / SizeY);
+				const FVector4f& Texel = Displacement[Y * SizeX + X];
+
+				const FVector2f ForwardDisplacement = CameraModel.UndistortViewportUV(ViewportUV) - ViewportUV;
+				MaxForwardError = FMath::Max(MaxForwardError, FMath::Max(FMath::Abs(Texel.X - ForwardDisplacement.X), FMath::Abs(Texel.Y - ForwardDisplacement.Y)));
+
+				// The inverse displacement leads to the distorted UV that undistorts back onto this pixel
+				const FVector2f RoundTrip = CameraModel.UndistortViewportUV(ViewportUV + FVector2f(Texel.Z, Texel.W));
+				const float ResidualPixels = FVector2f((RoundTrip.X - ViewportUV.X) * SizeX, (RoundTrip.Y - ViewportUV.Y) * SizeY).Size();
+				if (!(ResidualPixels <= TolerancePixels))
+				{
+					++NumUnconverged;
+				}
+				if (FMath::IsFinite(ResidualPixels))
+				{
+					MaxResidualPixels = FMath::Max(MaxResidualPixels, ResidualPixels);
+				}
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("Model %d: scalar round trip %.5f px max, %d unconverged, report %.5f px max, %d unconverged"),
+			ModelIndex, MaxResidualPixels, NumUnconverged, Report.MaxResidualPixels, Report.NumUnconverged));
+
+		TestTrue(FString::Printf(TEXT("Model %d forward displacement matches UndistortViewportUV (max error %g)"), ModelIndex, MaxForwardError), MaxForwardError <= 1e-5f);
+		TestTrue(FString::Printf(TEXT("Model %d round trip within %.2f px"), ModelIndex, TolerancePixels), MaxResidualPixels <= TolerancePixels);
+		TestEqual(FString::Printf(TEXT("Model %d unconverged pixels"), ModelIndex), NumUnconverged, 0);
+
+		// The report is computed from normalized view positions, the round trip adds one rounding of the UV sum
+		TestTrue(FString::Printf(TEXT("Model %d reported max residual within %.2f px"), ModelIndex, TolerancePixels), Report.MaxResidualPixels <= TolerancePixels);
+		TestEqual(FString::Printf(TEXT("Model %d reported unconverged pixels"), ModelIndex), Report.NumUnconverged, 0);
+		TestEqual(FString::Printf(TEXT("Model %d reported max residual agrees with the scalar round trip"), ModelIndex), Report.MaxResidualPixels, MaxResidualPixels, 1e-3f);
+	}
+
+	return true;
+}
+
+#endif
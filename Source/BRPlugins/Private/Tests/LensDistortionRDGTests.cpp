@@ -0,0 +1,163 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Rendering/LensDistortion.h"
+#include "Rendering/SimpleRenderingExample.h"
+#include "Tests/SimpleRenderingTestTarget.h"
+
+#include "RenderingThread.h"
+
+namespace LensDistortionRDGTests
+{
+	static void ReadPixels(UTextureRenderTarget2D* RenderTarget, TArray<FLinearColor>& OutPixels)
+	{
+		FlushRenderingCommands();
+		RenderTarget->GameThread_GetRenderTargetResource()->ReadLinearColorPixels(OutPixels);
+	}
+
+	/** Both paths store the displacement in UV, the target is RGBA16f which keeps about 3e-5 UV of the largest values */
+	static const float ForwardToleranceUV = 1e-4f;
+
+	/**
+	 * The shader rasterizes a 16x16 grid at this size, only its vertices are undistorted exactly and the inverse between
+	 * them is linearly interpolated. The interpolation error is bounded by CellSize^2 / 8 times the curvature of the
+	 * distortion, which for this camera model stays near 0.11 px at the corners; half that again is left for FP16
+	 */
+	static const float InverseTolerancePixels = 0.25f;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLensDistortionRDGCacheTest, "BRPlugins.Rendering.LensDistortionRDG.CachedMapRewritesTarget", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FLensDistortionRDGCacheTest::RunTest(const FString& Parameters)
+{
+	using namespace LensDistortionRDGTests;
+
+	UTextureRenderTarget2D* RenderTarget = SimpleRenderingTestTarget::Create(FIntPoint(256, 144));
+
+	FLensDistortionCameraModel CameraModel;
+	CameraModel.K1 = -0.2f;
+	CameraModel.K2 = 0.05f;
+	CameraModel.Overscan = 1.1f;
+
+	USimpleRenderingExampleBlueprintLibrary::UseRDGLensDistortion(nullptr, RenderTarget, CameraModel);
+	TArray<FLinearColor> Generated;
+	ReadPixels(RenderTarget, Generated);
+	const SimpleRenderingExample::FLensDistortionMapCacheStats Before = SimpleRenderingExample::GetLensDistortionMapCacheStats();
+
+	// Another path writes the target in between, the cached map has to be copied again
+	FSimpleShaderParameter Parameter;
+	Parameter.Color1 = FLinearColor(2.5f, 0.0f, 0.0f, 1.0f);
+	Parameter.ColorIndex = -1;
+	USimpleRenderingExampleBlueprintLibrary::UseRDGComput(nullptr, RenderTarget, Parameter);
+	SimpleRenderingExample::FlushRDGRequests();
+
+	TArray<FLinearColor> Overwritten;
+	ReadPixels(RenderTarget, Overwritten);
+	TestNotEqual(TEXT("The compute pass overwrote the displacement map"), Overwritten[0], Generated[0]);
+
+	USimpleRenderingExampleBlueprintLibrary::UseRDGLensDistortion(nullptr, RenderTarget, CameraModel);
+	TArray<FLinearColor> Cached;
+	ReadPixels(RenderTarget, Cached);
+	const SimpleRenderingExample::FLensDistortionMapCacheStats After = SimpleRenderingExample::GetLensDistortionMapCacheStats();
+
+	TestEqual(TEXT("Second call is served by the cache"), After.NumHits - Before.NumHits, 1);
+	TestEqual(TEXT("Second call generates no map"), After.NumMisses, Before.NumMisses);
+
+	int32 NumMismatches = 0;
+	for (int32 Index = 0; Index < Generated.Num() && Index < Cached.Num(); ++Index)
+	{
+		NumMismatches += Cached[Index].Equals(Generated[Index], 0.0f) ? 0 : 1;
+	}
+	TestEqual(TEXT("Pixel count"), Cached.Num(), Generated.Num());
+	TestEqual(TEXT("Pixels differing from the generated map after the cache hit"), NumMismatches, 0);
+
+	SimpleRenderingTestTarget::Destroy(RenderTarget);
+	FlushRenderingCommands();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLensDistortionRDGMatchesCPUTest, "BRPlugins.Rendering.LensDistortionRDG.MatchesCPUMap", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FLensDistortionRDGMatchesCPUTest::RunTest(const FString& Parameters)
+{
+	using namespace LensDistortionRDGTests;
+
+	const FIntPoint Size(256, 144);
+	UTextureRenderTarget2D* RenderTarget = SimpleRenderingTestTarget::Create(Size);
+
+	FLensDistortionCameraModel CameraModel;
+	CameraModel.K1 = -0.2f;
+	CameraModel.K2 = 0.05f;
+	CameraModel.Overscan = 1.1f;
+
+	USimpleRenderingExampleBlueprintLibrary::UseRDGLensDistortion(nullptr, RenderTarget, CameraModel);
+	TArray<FLinearColor> Generated;
+	ReadPixels(RenderTarget, Generated);
+
+	TArray<FVector4f> Expected;
+	FLensDistortionMapReport Report;
+	SimpleRenderingExample::GenerateLensDistortionMapCPU(CameraModel, Size.X, Size.Y, Expected, Report);
+
+	if (!TestEqual(TEXT("Pixel count"), Generated.Num(), Expected.Num()) || !TestEqual(TEXT("CPU texel count"), Expected.Num(), Size.X * Size.Y))
+	{
+		SimpleRenderingTestTarget::Destroy(RenderTarget);
+		FlushRenderingCommands();
+		return false;
+	}
+
+	// Both paths apply OutputMultiplyAndAdd, the tolerances are in displacement units
+	const FVector2f PixelUVSize(1.0f / Size.X, 1.0f / Size.Y);
+	const float OutputScale = FMath::Max(FMath::Abs(CameraModel.OutputMultiply), SMALL_NUMBER);
+
+	float MaxForwardError = 0.0f;
+	float MaxInversePixels = 0.0f;
+	int32 NumForwardMismatches = 0;
+	int32 NumInverseMismatches = 0;
+	int32 NumCovered = 0;
+
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+	{
+		for (int32 X = 0; X < Size.X; ++X)
+		{
+			const int32 Index = Y * Size.X + X;
+			const FLinearColor& Pixel = Generated[Index];
+			const FVector4f& Texel = Expected[Index];
+
+			// The grid only covers the undistorted image of the viewport, the remaining pixels keep the clear color. Pixels
+			// whose distorted UV falls within a pixel of the grid border are skipped as well, their coverage is up to the rasterizer
+			const FVector2f ViewportUV(X * PixelUVSize.X, Y * PixelUVSize.Y);
+			const FVector2f DistortedUV = ViewportUV + FVector2f(Texel.Z - CameraModel.OutputAdd, Texel.W - CameraModel.OutputAdd) / OutputScale;
+			const FVector2f GridMin = PixelUVSize * 0.5f;
+			const FVector2f GridMax = FVector2f(1.0f, 1.0f) - PixelUVSize * 1.5f;
+			if (DistortedUV.X < GridMin.X || DistortedUV.Y < GridMin.Y || DistortedUV.X > GridMax.X || DistortedUV.Y > GridMax.Y)
+			{
+				continue;
+			}
+			++NumCovered;
+
+			const float ForwardError = FMath::Max(FMath::Abs(Pixel.R - Texel.X), FMath::Abs(Pixel.G - Texel.Y)) / OutputScale;
+			MaxForwardError = FMath::Max(MaxForwardError, ForwardError);
+			NumForwardMismatches += ForwardError <= ForwardToleranceUV ? 0 : 1;
+
+			const float InversePixels = FMath::Max(FMath::Abs(Pixel.B - Texel.Z) / PixelUVSize.X, FMath::Abs(Pixel.A - Texel.W) / PixelUVSize.Y) / OutputScale;
+			MaxInversePixels = FMath::Max(MaxInversePixels, InversePixels);
+			NumInverseMismatches += InversePixels <= InverseTolerancePixels ? 0 : 1;
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("%d of %d pixels covered by the grid, max forward error %g UV, max inverse error %.3f px"),
+		NumCovered, Expected.Num(), MaxForwardError, MaxInversePixels));
+
+	// Barrel distortion pulls the grid in from the corners, yet most of the target is covered
+	TestTrue(TEXT("Most pixels are covered by the grid"), NumCovered > Expected.Num() / 2);
+	TestEqual(FString::Printf(TEXT("Pixels whose forward displacement differs from the CPU map by more than %g UV"), ForwardToleranceUV), NumForwardMismatches, 0);
+	TestEqual(FString::Printf(TEXT("Pixels whose inverse displacement differs from the CPU map by more than %.2f px"), InverseTolerancePixels), NumInverseMismatches, 0);
+
+	SimpleRenderingTestTarget::Destroy(RenderTarget);
+	FlushRenderingCommands();
+	return true;
+}
+
+#endif
@@ -0,0 +1,150 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Rendering/SimpleRenderingExample.h"
+#include "Rendering/SimpleRenderingCommon.h"
+#include "Tests/SimpleRenderingTestTarget.h"
+#include "Tests/SimpleRenderingCPUGolden.h"
+
+#include "HAL/IConsoleManager.h"
+#include "RenderingThread.h"
+#include "RenderUtils.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleGlobalShaderIntermediateTest, "BRPlugins.Rendering.GlobalShaderCompute.IntermediateMatchesGolden", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSimpleGlobalShaderIntermediateTest::RunTest(const FString& Parameters)
+{
+	const FIntPoint Size(SimpleRenderingCPUGolden::SizeX, SimpleRenderingCPUGolden::SizeY);
+	const ESimpleRenderingPrecision Precisions[] = { ESimpleRenderingPrecision::FP32, ESimpleRenderingPrecision::FP16, ESimpleRenderingPrecision::R11G11B10, ESimpleRenderingPrecision::RGBA8 };
+
+	// The intermediate is only reachable through the pool
+	IConsoleVariable* PoolVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("r.SimpleRendering.PoolIntermediates"));
+	if (!TestNotNull(TEXT("r.SimpleRendering.PoolIntermediates"), PoolVariable))
+	{
+		return false;
+	}
+	const int32 PreviousPool = PoolVariable->GetInt();
+	PoolVariable->Set(1, ECVF_SetByCode);
+
+	UTextureRenderTarget2D* RenderTarget = SimpleRenderingTestTarget::Create(Size);
+	FTexture2DRHIRef RenderTargetRHI = RenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
+
+	for (const ESimpleRenderingPrecision Precision : Precisions)
+	{
+		// ColorIndex 1 is compiled in, so the channels only match when the requested permutation ran
+		FSimpleShaderParameter Parameter;
+		Parameter.Color1 = SimpleRenderingCPUGolden::Color1;
+		Parameter.Color2 = SimpleRenderingCPUGolden::Color2;
+		Parameter.ColorIndex = SimpleRenderingCPUGolden::ColorIndex;
+		Parameter.Precision = Precision;
+
+		const EPixelFormat Format = SimpleRenderingExample::GetIntermediateFormat(Precision);
+		TArray<FLinearColor> Pixels;
+		ENQUEUE_RENDER_COMMAND(SimpleGlobalShaderIntermediateRead)
+		(
+			[RenderTargetRHI, Parameter, Size, Format, &Pixels](FRHICommandListImmediate &RHICmdList) {
+				SimpleRenderingExample::GlobalShaderCompute(RHICmdList, RenderTargetRHI, Parameter);
+				// Exactly this size and format, so the pool hands back the texture the dispatch wrote
+				FRHITexture* Intermediate = SimpleRenderingExample::GSimpleIntermediateTexturePool.FindOrCreate(Size, Format).Texture;
+				RHICmdList.ReadSurfaceData(Intermediate, FIntRect(FIntPoint::ZeroValue, Size), Pixels, FReadSurfaceDataFlags(RCM_MinMax));
+				SimpleRenderingExample::GSimpleIntermediateTexturePool.Flush();
+			});
+		FlushRenderingCommands();
+
+		if (!TestEqual(FString::Printf(TEXT("%s pixel count"), GPixelFormats[Format].Name), Pixels.Num(), Size.X * Size.Y))
+		{
+			continue;
+		}
+
+		// The golden tolerance of the CPU port, plus one step of the format's quantization at the brightest golden values
+		const int32 Tolerance = 3 + (Format == PF_FloatR11G11B10 ? 3 : (Format == PF_A32B32G32R32F ? 0 : 1));
+		int32 NumMismatches = 0;
+		int32 MaxError = 0;
+		for (int32 PixelIndex = 0; PixelIndex < Pixels.Num(); ++PixelIndex)
+		{
+			const float Channels[3] = { Pixels[PixelIndex].R, Pixels[PixelIndex].G, Pixels[PixelIndex].B };
+			for (int32 Channel = 0; Channel < 3; ++Channel)
+			{
+				const int32 Expected = SimpleRenderingCPUGolden::Pixels[PixelIndex * 3 + Channel];
+				const int32 Error = FMath::Abs(FMath::RoundToInt(Channels[Channel] * 255.0f) - Expected);
+				MaxError = FMath::Max(MaxError, Error);
+				if (Error > Tolerance && NumMismatches++ < 8)
+				{
+					AddError(FString::Printf(TEXT("%s pixel (%d, %d) channel %d is %d, expected %d"),
+						GPixelFormats[Format].Name, PixelIndex % Size.X, PixelIndex / Size.X, Channel, FMath::RoundToInt(Channels[Channel] * 255.0f), Expected));
+				}
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: largest channel difference %d/255, %d over the tolerance of %d"), GPixelFormats[Format].Name, MaxError, NumMismatches, Tolerance));
+	}
+
+	PoolVariable->Set(PreviousPool, ECVF_SetByCode);
+	SimpleRenderingTestTarget::Destroy(RenderTarget);
+	FlushRenderingCommands();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleGlobalShaderPrecisionBenchmark, "BRPlugins.Rendering.GlobalShaderCompute.PrecisionBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FSimpleGlobalShaderPrecisionBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 NumRepeats = 8;
+	const FIntPoint Sizes[] = { FIntPoint(1920, 1080), FIntPoint(3840, 2160), FIntPoint(7680, 4320) };
+	const ESimpleRenderingPrecision Precisions[] = { ESimpleRenderingPrecision::FP32, ESimpleRenderingPrecision::FP16, ESimpleRenderingPrecision::R11G11B10, ESimpleRenderingPrecision::RGBA8 };
+
+	for (const FIntPoint Size : Sizes)
+	{
+		UTextureRenderTarget2D* RenderTarget = SimpleRenderingTestTarget::Create(Size);
+		FTexture2DRHIRef RenderTargetRHI = RenderTarget->GameThread_GetRenderTargetResource()->GetRenderTargetTexture();
+
+		for (const ESimpleRenderingPrecision Precision : Precisions)
+		{
+			FSimpleShaderParameter Parameter;
+			Parameter.Color1 = FLinearColor(2.5f, 0.0f, 0.0f, 1.0f);
+			Parameter.ColorIndex = -1;
+			Parameter.Precision = Precision;
+
+			const EPixelFormat Format = SimpleRenderingExample::GetIntermediateFormat(Precision);
+			const SIZE_T IntermediateBytes = CalcTextureSize(Size.X, Size.Y, Format, 1);
+
+			// Pipeline creation and the allocation of the pooled intermediate stay out of the timed range
+			ENQUEUE_RENDER_COMMAND(SimpleGlobalShaderBenchmarkWarmUp)
+			(
+				[RenderTargetRHI, Parameter](FRHICommandListImmediate &RHICmdList) {
+					SimpleRenderingExample::GlobalShaderCompute(RHICmdList, RenderTargetRHI, Parameter);
+				});
+
+			SimpleRenderingTestTarget::FRenderTimer Timer;
+			Timer.Begin();
+			ENQUEUE_RENDER_COMMAND(SimpleGlobalShaderBenchmark)
+			(
+				[RenderTargetRHI, Parameter, NumRepeats](FRHICommandListImmediate &RHICmdList) {
+					for (int32 Repeat = 0; Repeat < NumRepeats; ++Repeat)
+					{
+						SimpleRenderingExample::GlobalShaderCompute(RHICmdList, RenderTargetRHI, Parameter);
+					}
+				});
+			Timer.End();
+
+			AddInfo(FString::Printf(TEXT("%dx%d %s: intermediate %.1f MB, GPU %.3f ms, render thread %.3f ms per call"),
+				Size.X, Size.Y, GPixelFormats[Format].Name, IntermediateBytes / (1024.0 * 1024.0), Timer.GPUMilliseconds / NumRepeats, Timer.RenderThreadMilliseconds / NumRepeats));
+
+			// Frames do not advance during the test, so the pool would keep every 8K intermediate resident at once
+			ENQUEUE_RENDER_COMMAND(SimpleGlobalShaderBenchmarkTrim)
+			(
+				[](FRHICommandListImmediate &RHICmdList) {
+					SimpleRenderingExample::GSimpleIntermediateTexturePool.Flush();
+				});
+		}
+
+		SimpleRenderingTestTarget::Destroy(RenderTarget);
+	}
+
+	FlushRenderingCommands();
+	return true;
+}
+
+#endif
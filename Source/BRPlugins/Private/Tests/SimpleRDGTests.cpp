@@ -0,0 +1,317 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Rendering/SimpleRenderingExample.h"
+#include "Tests/SimpleRenderingTestTarget.h"
+
+#include "HAL/IConsoleManager.h"
+#include "RenderingThread.h"
+
+namespace SimpleRDGTests
+{
+	/** Sets a console variable for the lifetime of the scope */
+	class FScopedConsoleVariable
+	{
+	public:
+		FScopedConsoleVariable(const TCHAR* Name, int32 Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			check(Variable);
+			PreviousValue = Variable->GetInt();
+			Variable->Set(Value, ECVF_SetByCode);
+		}
+
+		~FScopedConsoleVariable()
+		{
+			Variable->Set(PreviousValue, ECVF_SetByCode);
+		}
+
+	private:
+		IConsoleVariable* Variable;
+		int32 PreviousValue = 0;
+	};
+
+	static void ReadPixels(UTextureRenderTarget2D* RenderTarget, TArray<FLinearColor>& OutPixels)
+	{
+		FlushRenderingCommands();
+		RenderTarget->GameThread_GetRenderTargetResource()->ReadLinearColorPixels(OutPixels);
+	}
+
+	/** Renders the whole target, or only DirtyRects of it, and waits for the pixels */
+	static void Render(UTextureRenderTarget2D* RenderTarget, bool bDraw, const FSimpleShaderParameter& Parameter, UTexture2D* Texture, const TArray<FBox2D>& DirtyRects, TArray<FLinearColor>& OutPixels)
+	{
+		if (bDraw)
+		{
+			USimpleRenderingExampleBlueprintLibrary::UseRDGDrawRegions(nullptr, RenderTarget, Parameter, FLinearColor::White, Texture, DirtyRects);
+		}
+		else
+		{
+			USimpleRenderingExampleBlueprintLibrary::UseRDGComputRegions(nullptr, RenderTarget, Parameter, DirtyRects);
+		}
+		SimpleRenderingExample::FlushRDGRequests();
+		ReadPixels(RenderTarget, OutPixels);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleRDGBatchBenchmark, "BRPlugins.Rendering.RDG.BatchBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FSimpleRDGBatchBenchmark::RunTest(const FString& Parameters)
+{
+	// Many small targets driven from Blueprint in one frame
+	const int32 NumTargets = 200;
+	const int32 NumRepeats = 4;
+	const FIntPoint TargetSize(64, 64);
+
+	IConsoleVariable* BatchVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("r.SimpleRendering.Batch"));
+	if (!TestNotNull(TEXT("r.SimpleRendering.Batch"), BatchVariable))
+	{
+		return false;
+	}
+	const int32 PreviousBatch = BatchVariable->GetInt();
+
+	TArray<UTextureRenderTarget2D*> RenderTargets;
+	for (int32 TargetIndex = 0; TargetIndex < NumTargets; ++TargetIndex)
+	{
+		RenderTargets.Add(SimpleRenderingTestTarget::Create(TargetSize));
+	}
+
+	FSimpleShaderParameter Parameter;
+	Parameter.Color1 = FLinearColor(2.5f, 0.0f, 0.0f, 1.0f);
+	Parameter.ColorIndex = -1;
+
+	for (const int32 Batch : { 0, 1 })
+	{
+		BatchVariable->Set(Batch, ECVF_SetByCode);
+
+		double RenderThreadMilliseconds = 0.0;
+		double GPUMilliseconds = 0.0;
+		for (int32 Repeat = 0; Repeat <= NumRepeats; ++Repeat)
+		{
+			SimpleRenderingTestTarget::FRenderTimer Timer;
+			Timer.Begin();
+			for (UTextureRenderTarget2D* RenderTarget : RenderTargets)
+			{
+				USimpleRenderingExampleBlueprintLibrary::UseRDGComput(nullptr, RenderTarget, Parameter);
+			}
+			// Stands in for the end of the game thread frame
+			SimpleRenderingExample::FlushRDGRequests();
+			Timer.End();
+
+			// The first round creates the pipelines and uniform buffers
+			if (Repeat > 0)
+			{
+				RenderThreadMilliseconds += Timer.RenderThreadMilliseconds;
+				GPUMilliseconds += Timer.GPUMilliseconds;
+			}
+		}
+
+		AddInfo(FString::Printf(TEXT("%s, %d targets of %dx%d: render thread %.3f ms, GPU %.3f ms per frame"),
+			Batch ? TEXT("One graph per frame") : TEXT("One graph per call"), NumTargets, TargetSize.X, TargetSize.Y, RenderThreadMilliseconds / NumRepeats, GPUMilliseconds / NumRepeats));
+	}
+
+	BatchVariable->Set(PreviousBatch, ECVF_SetByCode);
+	for (UTextureRenderTarget2D* RenderTarget : RenderTargets)
+	{
+		SimpleRenderingTestTarget::Destroy(RenderTarget);
+	}
+	FlushRenderingCommands();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleRDGAsyncComputeBenchmark, "BRPlugins.Rendering.RDG.AsyncComputeBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FSimpleRDGAsyncComputeBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 NumFrames = 60;
+	const double TimeoutSeconds = 30.0;
+
+	IConsoleVariable* AsyncComputeVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("r.SimpleRendering.AsyncCompute"));
+	if (!TestNotNull(TEXT("r.SimpleRendering.AsyncCompute"), AsyncComputeVariable))
+	{
+		return false;
+	}
+	if (!GSupportsEfficientAsyncCompute)
+	{
+		AddInfo(TEXT("The RHI has no efficient async compute, r.SimpleRendering.AsyncCompute falls back to the graphics queue"));
+		return true;
+	}
+
+	const int32 PreviousAsyncCompute = AsyncComputeVariable->GetInt();
+	AsyncComputeVariable->Set(1, ECVF_SetByCode);
+
+	UTextureRenderTarget2D* RenderTarget = SimpleRenderingTestTarget::Create(FIntPoint(3840, 2160));
+
+	FSimpleShaderParameter Parameter;
+	Parameter.Color1 = FLinearColor(2.5f, 0.0f, 0.0f, 1.0f);
+	Parameter.ColorIndex = -1;
+
+	// One call per editor frame, so the requests are picked up by the scene graph where a viewport renders
+	int32 NumIssued = 0;
+	double LastIssueTime = 0.0;
+	uint64 LastSampledFrame = 0;
+	double ComputeMilliseconds = 0.0;
+	double GraphicsMilliseconds = 0.0;
+	double TotalMilliseconds = 0.0;
+	int32 NumSamples = 0;
+	int32 NumSceneSamples = 0;
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, AsyncComputeVariable, PreviousAsyncCompute, RenderTarget, Parameter, NumIssued, LastIssueTime, LastSampledFrame,
+		ComputeMilliseconds, GraphicsMilliseconds, TotalMilliseconds, NumSamples, NumSceneSamples, NumFrames, TimeoutSeconds]() mutable
+	{
+		// The first frames create the pipelines, every read back frame is sampled once.
+		// Requests no viewport picked up ran in a graph of their own, there is no graphics work to overlap and they are not averaged
+		const SimpleRenderingExample::FSimpleAsyncComputeTimings Timings = SimpleRenderingExample::GetAsyncComputeTimings();
+		if (NumIssued > 4 && Timings.Frame > LastSampledFrame && Timings.ComputeMilliseconds > 0.0f)
+		{
+			LastSampledFrame = Timings.Frame;
+			++NumSamples;
+			if (Timings.bSceneGraph)
+			{
+				ComputeMilliseconds += Timings.ComputeMilliseconds;
+				GraphicsMilliseconds += Timings.GraphicsMilliseconds;
+				TotalMilliseconds += Timings.TotalMilliseconds;
+				++NumSceneSamples;
+			}
+		}
+
+		if (NumIssued < NumFrames)
+		{
+			USimpleRenderingExampleBlueprintLibrary::UseRDGComput(nullptr, RenderTarget, Parameter);
+			LastIssueTime = FPlatformTime::Seconds();
+			++NumIssued;
+			return false;
+		}
+
+		if (NumSamples == 0 && FPlatformTime::Seconds() - LastIssueTime < TimeoutSeconds)
+		{
+			return false;
+		}
+
+		if (NumSceneSamples > 0)
+		{
+			ComputeMilliseconds /= NumSceneSamples;
+			GraphicsMilliseconds /= NumSceneSamples;
+			TotalMilliseconds /= NumSceneSamples;
+			AddInfo(FString::Printf(TEXT("Async compute pass on 3840x2160 over %d scene frames: %.3f ms compute pipe, %.3f ms graphics pipe, %.3f ms total against %.3f ms serial"),
+				NumSceneSamples, ComputeMilliseconds, GraphicsMilliseconds, TotalMilliseconds, ComputeMilliseconds + GraphicsMilliseconds));
+
+			// Serially the graphics pipe would wait for the compute pass, overlapping them has to beat the sum
+			TestTrue(TEXT("Total time with async compute is below the serial sum of both pipes"), TotalMilliseconds < ComputeMilliseconds + GraphicsMilliseconds);
+		}
+		else if (NumSamples > 0)
+		{
+			AddInfo(FString::Printf(TEXT("No viewport rendered a scene during the %d sampled frames, the overlap with the graphics pipe is not checked"), NumSamples));
+		}
+		else
+		{
+			AddError(FString::Printf(TEXT("No async compute timestamps were read back within %.0f seconds"), TimeoutSeconds));
+		}
+
+		AsyncComputeVariable->Set(PreviousAsyncCompute, ECVF_SetByCode);
+		SimpleRenderingTestTarget::Destroy(RenderTarget);
+		return true;
+	}));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleRDGRegionsTest, "BRPlugins.Rendering.RDG.DirtyRectsAndTiles", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSimpleRDGRegionsTest::RunTest(const FString& Parameters)
+{
+	using namespace SimpleRDGTests;
+
+	const FIntPoint TargetSize(256, 144);
+
+	// Both cross tile borders, the second one also the edge of the target
+	const TArray<FBox2D> DirtyRects = { FBox2D(FVector2D(10.0, 10.0), FVector2D(70.0, 50.0)), FBox2D(FVector2D(100.0, 60.0), FVector2D(300.0, 144.0)) };
+
+	// Requests run in a graph of their own right away, not in the scene graph
+	FScopedConsoleVariable AsyncCompute(TEXT("r.SimpleRendering.AsyncCompute"), 0);
+
+	UTextureRenderTarget2D* RenderTarget = SimpleRenderingTestTarget::Create(TargetSize);
+	UTexture2D* Texture = SimpleRenderingTestTarget::CreateGradientTexture(TargetSize);
+
+	FSimpleShaderParameter Background;
+	Background.Color1 = FLinearColor(0.5f, 0.0f, 0.0f, 1.0f);
+	Background.ColorIndex = -1;
+
+	FSimpleShaderParameter Foreground;
+	Foreground.Color1 = FLinearColor(2.5f, 0.5f, 0.25f, 1.0f);
+	Foreground.ColorIndex = 0;
+
+	auto IsInside = [&DirtyRects, TargetSize](int32 Index)
+	{
+		const FVector2D Pixel(Index % TargetSize.X + 0.5, Index / TargetSize.X + 0.5);
+		return DirtyRects.ContainsByPredicate([&Pixel](const FBox2D& Rect) { return Rect.IsInside(Pixel); });
+	};
+
+	for (const int32 DirectOutput : { 0, 1 })
+	{
+		FScopedConsoleVariable DirectOutputVariable(TEXT("r.SimpleRendering.DirectOutput"), DirectOutput);
+
+		for (const bool bDraw : { false, true })
+		{
+			// Compute threads write at their integer pixel position, so every path matches exactly. The draw paths move the viewport
+			// so a region lands at the origin of its transient texture, which may change the interpolated UVs in the last bits and
+			// round the result to the neighbouring FP16 value, 2^-9 at the brightest pixels of 2.5
+			const float Tolerance = bDraw ? 4e-3f : 0.0f;
+			const FString Path = FString::Printf(TEXT("%s, DirectOutput %d"), bDraw ? TEXT("Draw") : TEXT("Compute"), DirectOutput);
+
+			TArray<FLinearColor> Reference;
+			TArray<FLinearColor> BackgroundPixels;
+			Render(RenderTarget, bDraw, Foreground, Texture, {}, Reference);
+			Render(RenderTarget, false, Background, Texture, {}, BackgroundPixels);
+			if (!TestEqual(FString::Printf(TEXT("%s: pixel count"), *Path), Reference.Num(), TargetSize.X * TargetSize.Y))
+			{
+				continue;
+			}
+
+			for (const bool bTiled : { false, true })
+			{
+				// Tiles of 64 pixels, the smallest r.SimpleRendering.TileSize allows
+				FScopedConsoleVariable TiledThreshold(TEXT("r.SimpleRendering.TiledThreshold"), bTiled ? 1 : 0);
+				FScopedConsoleVariable TileSize(TEXT("r.SimpleRendering.TileSize"), 64);
+
+				for (const bool bRects : { false, true })
+				{
+					if (!bTiled && !bRects)
+					{
+						continue;
+					}
+
+					TArray<FLinearColor> Pixels;
+					Render(RenderTarget, false, Background, Texture, {}, Pixels);
+					Render(RenderTarget, bDraw, Foreground, Texture, bRects ? DirtyRects : TArray<FBox2D>(), Pixels);
+
+					int32 NumInsideMismatches = 0;
+					int32 NumOutsideMismatches = 0;
+					for (int32 Index = 0; Index < Pixels.Num() && Index < Reference.Num(); ++Index)
+					{
+						if (!bRects || IsInside(Index))
+						{
+							NumInsideMismatches += Pixels[Index].Equals(Reference[Index], Tolerance) ? 0 : 1;
+						}
+						else
+						{
+							NumOutsideMismatches += Pixels[Index].Equals(BackgroundPixels[Index], 0.0f) ? 0 : 1;
+						}
+					}
+
+					const FString Case = FString::Printf(TEXT("%s, %s%s"), *Path, bTiled ? TEXT("tiled") : TEXT("untiled"), bRects ? TEXT(" dirty rects") : TEXT(""));
+					TestEqual(FString::Printf(TEXT("%s: pixel count"), *Case), Pixels.Num(), Reference.Num());
+					TestEqual(FString::Printf(TEXT("%s: rendered pixels differing from the full render"), *Case), NumInsideMismatches, 0);
+					TestEqual(FString::Printf(TEXT("%s: pixels outside the rects that changed"), *Case), NumOutsideMismatches, 0);
+				}
+			}
+		}
+	}
+
+	SimpleRenderingTestTarget::Destroy(RenderTarget);
+	SimpleRenderingTestTarget::Destroy(Texture);
+	FlushRenderingCommands();
+	return true;
+}
+
+#endif
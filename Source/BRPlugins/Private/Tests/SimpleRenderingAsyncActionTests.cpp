@@ -0,0 +1,89 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Rendering/SimpleRenderingAsyncAction.h"
+#include "Tests/SimpleRenderingTestTarget.h"
+
+#include "RenderingThread.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleRenderingAsyncActionStallBenchmark, "BRPlugins.Rendering.AsyncAction.StallBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FSimpleRenderingAsyncActionStallBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 NumCalls = 16;
+	const double TimeoutSeconds = 30.0;
+
+	UTextureRenderTarget2D* RenderTarget = SimpleRenderingTestTarget::Create(FIntPoint(1920, 1080));
+
+	FSimpleShaderParameter Parameter;
+	Parameter.Color1 = FLinearColor(2.5f, 0.0f, 0.0f, 1.0f);
+	Parameter.ColorIndex = -1;
+
+	// Pipeline creation stays out of both measurements
+	USimpleRenderingExampleBlueprintLibrary::UseRDGComput(nullptr, RenderTarget, Parameter);
+	SimpleRenderingExample::FlushRDGRequests();
+	FlushRenderingCommands();
+
+	// The fire and forget call followed by the flush scripts used to know the target was ready
+	double BlockingSeconds = 0.0;
+	for (int32 Call = 0; Call < NumCalls; ++Call)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		USimpleRenderingExampleBlueprintLibrary::UseRDGComput(nullptr, RenderTarget, Parameter);
+		SimpleRenderingExample::FlushRDGRequests();
+		FlushRenderingCommands();
+		BlockingSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	// The latent node only costs the game thread its activation, completion is polled by the core ticker
+	TArray<USimpleRenderingAsyncAction*> Actions;
+	double AsyncSeconds = 0.0;
+	for (int32 Call = 0; Call < NumCalls; ++Call)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		USimpleRenderingAsyncAction* Action = USimpleRenderingAsyncAction::UseRDGComputAsync(nullptr, RenderTarget, Parameter);
+		Action->AddToRoot();
+		Action->Activate();
+		AsyncSeconds += FPlatformTime::Seconds() - StartTime;
+		Actions.Add(Action);
+	}
+
+	const double IssueTime = FPlatformTime::Seconds();
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Actions, RenderTarget, IssueTime, TimeoutSeconds, BlockingSeconds, AsyncSeconds, NumCalls]()
+	{
+		const bool bFinished = Actions.FindByPredicate([](const USimpleRenderingAsyncAction* Action) { return Action->GetLatencySeconds() < 0.0f; }) == nullptr;
+		const bool bTimedOut = FPlatformTime::Seconds() - IssueTime > TimeoutSeconds;
+		if (!bFinished && !bTimedOut)
+		{
+			return false;
+		}
+
+		if (bFinished)
+		{
+			double TotalLatencySeconds = 0.0;
+			for (const USimpleRenderingAsyncAction* Action : Actions)
+			{
+				TotalLatencySeconds += Action->GetLatencySeconds();
+			}
+			AddInfo(FString::Printf(TEXT("Game thread blocked per call: flush %.3f ms, async action %.3f ms. Average async completion latency %.3f ms"),
+				BlockingSeconds * 1000.0 / NumCalls, AsyncSeconds * 1000.0 / NumCalls, TotalLatencySeconds * 1000.0 / NumCalls));
+		}
+		else
+		{
+			AddError(FString::Printf(TEXT("Async actions did not complete within %.0f seconds"), TimeoutSeconds));
+		}
+
+		for (USimpleRenderingAsyncAction* Action : Actions)
+		{
+			Action->RemoveFromRoot();
+		}
+		SimpleRenderingTestTarget::Destroy(RenderTarget);
+		return true;
+	}));
+
+	return true;
+}
+
+#endif
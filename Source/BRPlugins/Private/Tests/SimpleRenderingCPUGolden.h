@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace SimpleRenderingCPUGolden
+{
+	/** Size of the reference image */
+	static const int32 SizeX = 30;
+	static const int32 SizeY = 30;
+
+	/** Parameters it was rendered with, GlobalTime 2.5 in Color1.R and ColorIndex 1 so the colour multiply is covered */
+	static const FLinearColor Color1(2.5f, 0.0f, 0.0f, 1.0f);
+	static const FLinearColor Color2(1.0f, 0.5f, 0.25f, 1.0f);
+	static const int32 ColorIndex = 1;
+
+	/**
+	 * RGB8 pixels of MainCS in SimpleComputeShader.usf, row major. Generated by a scalar single precision port of the shader
+	 * that follows its operation order, independently of the vectorized ComputeCPU
+	 */
+	static const uint8 Pixels[SizeX * SizeY * 3] =
+	{
+		29, 18, 5, 34, 38, 11, 38, 37, 13, 47, 19, 7, 38, 14, 6, 39, 16, 8, 47, 21, 12, 68, 49, 36, 45, 16, 10, 44, 14, 8,
+		49, 19, 13, 44, 14, 9, 46, 17, 12, 55, 20, 15, 55, 18, 13, 66, 36, 36, 46, 16, 12, 44, 13, 8, 50, 16, 10, 46, 14, 8,
+		47, 16, 10, 39, 12, 6, 47, 18, 11, 43, 14, 8, 45, 16, 9, 40, 14, 6, 29, 9, 4, 27, 9, 4, 28, 9, 3, 32, 13, 4,
+		28, 11, 4, 31, 12, 5, 38, 12, 5, 41, 16, 7, 42, 14, 7, 37, 12, 6, 40, 13, 7, 55, 27, 20, 45, 15, 10, 40, 12, 7,
+		58, 22, 18, 43, 14, 9, 51, 17, 13, 54, 16, 11, 52, 16, 12, 47, 14, 8, 62, 23, 21, 46, 14, 8, 47, 16, 11, 46, 13, 7,
+		50, 14, 8, 45, 13, 7, 46, 14, 8, 45, 13, 7, 41, 14, 8, 36, 12, 6, 32, 10, 4, 35, 12, 6, 28, 8, 3, 29, 9, 4,
+		31, 10, 4, 36, 11, 5, 37, 13, 6, 36, 12, 6, 42, 14, 7, 37, 13, 7, 43, 14, 8, 48, 14, 8, 55, 18, 13, 54, 20, 17,
+		62, 22, 18, 55, 16, 11, 62, 18, 14, 56, 15, 9, 49, 14, 9, 47, 14, 8, 58, 16, 11, 50, 14, 8, 52, 14, 8, 58, 16, 10,
+		55, 15, 9, 54, 15, 10, 66, 28, 25, 57, 22, 18, 53, 19, 12, 45, 15, 8, 40, 13, 6, 39, 14, 7, 35, 13, 6, 30, 10, 4,
+		31, 12, 5, 34, 11, 5, 42, 18, 10, 41, 16, 9, 39, 19, 14, 49, 17, 11, 48, 15, 10, 52, 17, 13, 63, 25, 24, 65, 21, 18,
+		73, 22, 18, 62, 18, 12, 54, 14, 8, 58, 15, 9, 60, 25, 26, 61, 16, 9, 61, 16, 9, 60, 15, 8, 69, 17, 11, 73, 20, 14,
+		76, 23, 19, 76, 22, 17, 72, 21, 16, 71, 21, 16, 62, 20, 14, 58, 19, 12, 58, 21, 14, 52, 18, 10, 40, 14, 7, 36, 13, 6,
+		34, 11, 4, 37, 13, 6, 40, 12, 6, 48, 20, 13, 48, 19, 14, 63, 21, 16, 54, 16, 11, 63, 21, 18, 70, 21, 17, 87, 29, 28,
+		75, 31, 34, 67, 18, 11, 63, 23, 20, 55, 15, 7, 71, 18, 9, 69, 17, 8, 85, 21, 11, 100, 26, 17, 90, 24, 17, 94, 27, 22,
+		80, 20, 13, 78, 22, 18, 88, 31, 33, 71, 23, 19, 65, 21, 17, 68, 26, 23, 64, 32, 28, 67, 30, 22, 57, 25, 15, 45, 18, 9,
+		45, 18, 9, 45, 23, 15, 54, 19, 12, 53, 21, 16, 59, 22, 17, 94, 42, 46, 52, 14, 9, 67, 19, 14, 79, 22, 17, 71, 21, 15,
+		74, 19, 10, 62, 17, 9, 69, 18, 9, 87, 22, 10, 79, 21, 10, 105, 33, 17, 105, 28, 13, 103, 27, 13, 109, 27, 14, 124, 32, 19,
+		109, 30, 22, 95, 28, 24, 87, 26, 23, 70, 21, 17, 81, 29, 28, 70, 23, 19, 65, 26, 23, 63, 28, 22, 55, 31, 24, 52, 25, 15,
+		43, 17, 9, 47, 19, 12, 69, 28, 21, 70, 68, 64, 60, 23, 21, 93, 31, 31, 61, 17, 11, 71, 19, 13, 73, 21, 15, 73, 19, 10,
+		81, 22, 11, 76, 20, 8, 72, 19, 7, 83, 24, 10, 107, 33, 13, 127, 51, 20, 115, 45, 18, 103, 31, 12, 120, 50, 23, 118, 38, 18,
+		128, 52, 35, 102, 35, 27, 91, 30, 25, 102, 44, 52, 94, 42, 52, 87, 42, 52, 63, 26, 25, 62, 33, 32, 70, 36, 31, 57, 27, 19,
+		44, 15, 9, 63, 46, 42, 61, 22, 17, 67, 26, 24, 72, 25, 24, 92, 30, 30, 73, 19, 12, 85, 27, 21, 99, 49, 41, 72, 20, 9,
+		77, 20, 8, 89, 29, 11, 72, 20, 8, 137, 44, 15, 96, 32, 12, 137, 53, 19, 122, 48, 17, 126, 51, 18, 136, 52, 19, 152, 67, 26,
+		243, 128, 64, 123, 40, 21, 125, 48, 37, 97, 31, 26, 77, 23, 18, 79, 26, 24, 70, 25, 23, 61, 23, 20, 58, 30, 28, 53, 29, 23,
+		53, 23, 16, 67, 28, 22, 80, 37, 37, 80, 27, 24, 109, 42, 49, 93, 24, 17, 60, 16, 8, 68, 18, 9, 71, 20, 9, 80, 26, 11,
+		82, 23, 9, 72, 21, 8, 85, 33, 13, 107, 50, 20, 127, 55, 22, 105, 54, 22, 93, 38, 15, 131, 62, 24, 133, 84, 32, 108, 39, 14,
+		101, 28, 10, 106, 27, 10, 97, 24, 10, 118, 45, 34, 88, 23, 15, 79, 21, 15, 67, 19, 14, 62, 20, 16, 72, 33, 32, 53, 24, 19,
+		51, 20, 14, 56, 20, 14, 73, 26, 23, 69, 20, 15, 115, 37, 37, 87, 22, 14, 62, 16, 7, 73, 20, 9, 79, 23, 9, 64, 18, 7,
+		66, 18, 7, 94, 32, 12, 103, 35, 14, 119, 45, 20, 143, 99, 49, 154, 76, 36, 131, 49, 22, 114, 42, 18, 111, 43, 18, 90, 36, 14,
+		96, 31, 11, 119, 38, 14, 101, 28, 11, 103, 27, 13, 88, 22, 11, 77, 19, 11, 73, 20, 14, 71, 21, 16, 59, 20, 17, 81, 43, 42,
+		43, 14, 8, 54, 18, 13, 75, 24, 20, 73, 19, 13, 136, 54, 64, 88, 21, 12, 61, 16, 7, 73, 19, 8, 74, 20, 8, 84, 24, 9,
+		73, 21, 8, 87, 34, 15, 120, 43, 19, 157, 128, 64, 135, 52, 27, 111, 45, 23, 91, 31, 15, 82, 27, 13, 93, 31, 14, 100, 37, 16,
+		128, 88, 36, 96, 32, 12, 106, 30, 11, 105, 28, 11, 100, 27, 13, 89, 22, 13, 77, 20, 14, 69, 20, 15, 83, 27, 24, 76, 48, 54,
+		40, 12, 7, 48, 14, 9, 54, 16, 10, 68, 17, 11, 85, 24, 19, 86, 21, 11, 69, 18, 8, 85, 24, 9, 87, 24, 9, 93, 33, 13,
+		105, 64, 30, 103, 36, 17, 155, 98, 58, 136, 68, 41, 94, 32, 17, 105, 40, 22, 107, 42, 24, 111, 41, 22, 94, 40, 21, 110, 46, 22,
+		98, 42, 19, 106, 43, 17, 110, 36, 13, 112, 37, 14, 89, 24, 10, 83, 24, 15, 80, 22, 15, 77, 24, 20, 64, 17, 12, 71, 26, 22,
+		46, 16, 11, 51, 18, 15, 55, 18, 15, 60, 17, 11, 85, 23, 16, 90, 28, 16, 67, 18, 7, 100, 31, 11, 106, 38, 14, 96, 46, 20,
+		96, 31, 14, 119, 41, 20, 114, 70, 46, 103, 46, 29, 98, 33, 19, 95, 34, 20, 79, 36, 22, 87, 27, 14, 96, 33, 17, 151, 96, 57,
+		96, 38, 18, 104, 36, 15, 87, 26, 10, 93, 29, 11, 121, 65, 32, 86, 24, 13, 76, 19, 11, 76, 20, 14, 66, 19, 14, 61, 20, 15,
+		48, 16, 10, 44, 13, 7, 53, 15, 9, 54, 15, 10, 81, 25, 18, 87, 25, 13, 76, 22, 9, 70, 20, 8, 87, 26, 10, 120, 56, 25,
+		90, 28, 13, 123, 48, 27, 121, 64, 44, 106, 40, 24, 106, 36, 21, 118, 44, 29, 91, 30, 16, 116, 45, 29, 87, 30, 16, 83, 30, 15,
+		124, 64, 34, 100, 41, 18, 105, 36, 14, 102, 29, 10, 101, 29, 11, 77, 19, 9, 69, 17, 9, 62, 16, 8, 63, 16, 10, 63, 20, 16,
+		43, 13, 7, 56, 27, 28, 48, 14, 8, 58, 16, 10, 60, 17, 9, 65, 17, 7, 87, 28, 11, 86, 24, 9, 76, 24, 10, 105, 39, 17,
+		114, 45, 23, 117, 45, 26, 106, 45, 28, 123, 62, 47, 101, 35, 21, 116, 34, 19, 99, 34, 20, 89, 29, 16, 92, 29, 15, 93, 34, 18,
+		79, 27, 13, 122, 58, 27, 95, 61, 26, 120, 74, 27, 88, 25, 10, 64, 17, 7, 66, 16, 8, 52, 14, 8, 51, 13, 7, 56, 17, 12,
+		46, 15, 10, 43, 13, 8, 58, 17, 12, 60, 16, 10, 64, 16, 8, 58, 16, 7, 67, 22, 9, 83, 25, 9, 84, 30, 12, 82, 29, 13,
+		114, 43, 22, 80, 31, 17, 97, 44, 29, 121, 73, 59, 133, 69, 56, 99, 31, 18, 121, 53, 40, 89, 32, 19, 94, 32, 18, 94, 36, 20,
+		104, 43, 23, 80, 27, 12, 94, 30, 12, 80, 27, 10, 76, 21, 8, 72, 19, 8, 65, 18, 10, 55, 14, 7, 53, 14, 8, 50, 14, 9,
+		44, 14, 9, 51, 15, 10, 50, 14, 8, 67, 19, 13, 62, 17, 9, 67, 18, 8, 65, 18, 7, 83, 25, 9, 110, 38, 15, 87, 29, 13,
+		88, 30, 15, 104, 40, 22, 116, 43, 26, 109, 36, 21, 137, 50, 34, 111, 36, 22, 94, 32, 19, 95, 28, 15, 92, 35, 21, 88, 31, 16,
+		110, 48, 25, 97, 38, 17, 78, 25, 10, 86, 26, 10, 80, 22, 8, 67, 18, 8, 55, 15, 7, 62, 18, 12, 53, 14, 8, 45, 13, 7,
+		60, 27, 24, 45, 14, 8, 47, 14, 9, 53, 15, 8, 64, 20, 13, 80, 22, 11, 103, 33, 13, 71, 21, 8, 83, 26, 10, 118, 45, 20,
+		104, 39, 19, 85, 27, 13, 148, 113, 64, 103, 37, 22, 104, 39, 25, 114, 44, 29, 112, 40, 24, 101, 33, 19, 86, 29, 16, 99, 36, 19,
+		84, 27, 12, 73, 22, 9, 86, 35, 14, 82, 24, 9, 67, 20, 8, 72, 20, 10, 52, 14, 7, 55, 16, 10, 50, 15, 10, 55, 17, 12,
+		46, 14, 9, 46, 15, 10, 52, 17, 13, 55, 15, 10, 62, 18, 11, 80, 25, 15, 101, 42, 19, 73, 20, 8, 105, 36, 13, 93, 32, 13,
+		86, 28, 12, 121, 128, 64, 91, 29, 15, 103, 34, 19, 97, 35, 20, 113, 45, 28, 118, 55, 37, 95, 33, 18, 84, 29, 15, 89, 31, 15,
+		93, 29, 13, 75, 23, 9, 86, 60, 23, 68, 19, 7, 74, 20, 8, 63, 17, 8, 53, 14, 7, 47, 13, 7, 53, 15, 10, 48, 15, 10,
+		57, 21, 15, 44, 14, 9, 43, 12, 7, 56, 15, 10, 65, 17, 10, 68, 18, 9, 78, 25, 12, 76, 21, 8, 74, 21, 8, 82, 25, 10,
+		95, 35, 15, 97, 32, 14, 94, 31, 15, 89, 37, 21, 103, 35, 18, 107, 41, 23, 85, 29, 15, 85, 27, 13, 89, 33, 17, 79, 26, 12,
+		83, 26, 11, 84, 26, 10, 82, 26, 10, 66, 18, 7, 89, 26, 12, 73, 23, 15, 57, 15, 8, 49, 13, 7, 43, 12, 7, 61, 23, 20,
+		64, 28, 22, 65, 23, 18, 58, 18, 13, 55, 17, 13, 70, 24, 22, 67, 17, 9, 70, 19, 9, 62, 17, 7, 78, 22, 8, 78, 25, 9,
+		89, 32, 13, 83, 33, 14, 76, 26, 12, 76, 27, 13, 90, 33, 16, 90, 32, 16, 76, 23, 11, 76, 25, 11, 77, 25, 11, 106, 36, 15,
+		74, 21, 8, 83, 35, 13, 68, 19, 7, 84, 24, 10, 70, 20, 10, 54, 15, 7, 50, 14, 8, 61, 20, 17, 45, 13, 8, 57, 19, 14,
+		82, 56, 49, 89, 73, 64, 73, 63, 64, 63, 20, 17, 51, 15, 9, 51, 14, 7, 65, 18, 9, 65, 17, 7, 73, 19, 8, 71, 19, 7,
+		78, 23, 9, 77, 22, 9, 77, 24, 10, 96, 68, 33, 79, 26, 11, 75, 23, 10, 73, 21, 9, 90, 33, 14, 81, 26, 11, 82, 25, 10,
+		70, 21, 8, 73, 21, 8, 84, 26, 11, 88, 23, 10, 90, 35, 28, 50, 14, 7, 61, 16, 10, 63, 26, 26, 55, 17, 11, 64, 22, 17,
+		58, 21, 13, 59, 22, 16, 69, 24, 20, 58, 21, 18, 56, 16, 11, 59, 16, 10, 65, 17, 9, 62, 16, 7, 73, 19, 8, 74, 19, 8,
+		86, 25, 9, 76, 21, 8, 85, 32, 12, 69, 20, 8, 81, 34, 14, 81, 26, 11, 86, 29, 12, 83, 26, 10, 75, 21, 8, 73, 21, 8,
+		97, 32, 12, 77, 20, 8, 71, 19, 8, 76, 19, 10, 105, 50, 57, 46, 13, 6, 49, 15, 10, 49, 17, 13, 54, 19, 15, 71, 43, 40,
+		38, 16, 9, 58, 24, 17, 66, 33, 30, 60, 24, 21, 57, 17, 12, 51, 14, 8, 54, 14, 8, 58, 15, 8, 59, 16, 7, 71, 18, 8,
+		64, 17, 7, 75, 20, 8, 75, 21, 8, 71, 19, 7, 87, 26, 10, 91, 27, 10, 80, 23, 9, 92, 30, 11, 62, 18, 7, 95, 31, 12,
+		96, 29, 12, 77, 19, 8, 62, 17, 9, 80, 20, 12, 63, 17, 11, 55, 20, 18, 50, 15, 11, 39, 13, 8, 47, 15, 9, 64, 29, 22,
+		46, 18, 10, 48, 19, 12, 53, 21, 15, 45, 14, 9, 46, 13, 8, 49, 15, 10, 57, 17, 13, 53, 14, 8, 62, 17, 9, 66, 17, 9,
+		72, 21, 11, 68, 18, 8, 65, 17, 7, 70, 20, 8, 71, 19, 7, 101, 32, 12, 92, 41, 17, 70, 18, 7, 82, 23, 10, 104, 30, 14,
+		88, 21, 10, 75, 20, 11, 62, 16, 8, 67, 19, 13, 58, 17, 12, 47, 14, 8, 46, 14, 9, 44, 14, 8, 43, 16, 10, 68, 38, 28,
+		35, 15, 7, 64, 114, 64, 49, 21, 14, 61, 25, 19, 51, 17, 13, 45, 14, 8, 53, 15, 9, 59, 16, 11, 54, 15, 9, 57, 16, 10,
+		66, 17, 9, 74, 23, 14, 76, 29, 19, 102, 34, 19, 70, 19, 9, 84, 24, 11, 70, 18, 8, 85, 25, 13, 121, 38, 24, 126, 34, 22,
+		90, 22, 13, 59, 16, 8, 80, 25, 22, 61, 18, 13, 62, 19, 14, 47, 15, 10, 46, 14, 9, 39, 12, 6, 46, 16, 10, 67, 83, 64,
+		38, 18, 8, 47, 21, 11, 49, 22, 14, 53, 23, 16, 55, 21, 16, 48, 16, 11, 41, 12, 7, 52, 14, 9, 59, 17, 12, 57, 15, 9,
+		55, 15, 9, 81, 31, 31, 73, 19, 12, 62, 17, 9, 70, 18, 9, 59, 15, 7, 74, 18, 9, 113, 33, 26, 157, 67, 64, 102, 29, 24,
+		106, 37, 40, 63, 17, 11, 65, 18, 13, 48, 14, 8, 65, 49, 63, 40, 12, 7, 42, 14, 8, 38, 13, 7, 51, 24, 15, 44, 20, 10,
+		36, 34, 15, 33, 12, 5, 38, 14, 7, 40, 15, 9, 45, 17, 11, 56, 22, 16, 51, 19, 15, 53, 16, 11, 56, 16, 11, 56, 16, 11,
+		53, 17, 13, 56, 15, 9, 59, 16, 9, 63, 17, 10, 63, 16, 9, 83, 22, 16, 89, 23, 16, 89, 28, 25, 66, 25, 24, 116, 56, 64,
+		64, 18, 13, 64, 18, 12, 63, 20, 16, 43, 13, 7, 65, 58, 64, 40, 13, 8, 40, 14, 8, 36, 11, 6, 39, 15, 8, 39, 32, 16,
+		26, 8, 3, 35, 33, 15, 35, 16, 8, 37, 15, 8, 38, 15, 9, 41, 18, 12, 39, 12, 7, 41, 13, 7, 53, 19, 14, 53, 17, 12,
+		47, 14, 9, 50, 14, 9, 55, 15, 10, 70, 22, 19, 91, 35, 38, 78, 22, 17, 79, 28, 29, 65, 20, 16, 61, 20, 16, 63, 19, 15,
+		64, 20, 16, 60, 18, 12, 49, 14, 9, 40, 13, 7, 38, 13, 7, 35, 10, 5, 35, 11, 6, 32, 10, 5, 32, 11, 5, 29, 10, 4,
+		24, 7, 3, 29, 11, 4, 28, 10, 4, 29, 10, 4, 33, 11, 5, 38, 13, 7, 39, 13, 7, 43, 15, 9, 51, 17, 11, 55, 18, 12,
+		64, 31, 30, 54, 19, 15, 65, 22, 18, 75, 25, 22, 75, 30, 30, 64, 27, 26, 55, 20, 17, 64, 24, 22, 58, 19, 14, 53, 16, 10,
+		89, 76, 64, 54, 37, 38, 39, 12, 6, 44, 15, 9, 35, 11, 5, 34, 12, 6, 32, 11, 5, 33, 11, 5, 27, 9, 4, 32, 22, 8,
+	};
+}
@@ -0,0 +1,75 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Rendering/SimpleRenderingCPU.h"
+#include "Tests/SimpleRenderingCPUGolden.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleRenderingCPUGoldenTest, "BRPlugins.Rendering.ComputeCPU.MatchesGolden", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSimpleRenderingCPUGoldenTest::RunTest(const FString& Parameters)
+{
+	// Two steps of quantization plus the vector sin/cos approximations
+	const int32 Tolerance = 3;
+
+	FSimpleShaderParameter Parameter;
+	Parameter.Color1 = SimpleRenderingCPUGolden::Color1;
+	Parameter.Color2 = SimpleRenderingCPUGolden::Color2;
+	Parameter.ColorIndex = SimpleRenderingCPUGolden::ColorIndex;
+
+	TArray<FLinearColor> Pixels;
+	SimpleRenderingExample::ComputeCPU(SimpleRenderingCPUGolden::SizeX, SimpleRenderingCPUGolden::SizeY, Parameter, Pixels);
+	if (!TestEqual(TEXT("Pixel count"), Pixels.Num(), SimpleRenderingCPUGolden::SizeX * SimpleRenderingCPUGolden::SizeY))
+	{
+		return false;
+	}
+
+	int32 NumMismatches = 0;
+	int32 MaxError = 0;
+	for (int32 PixelIndex = 0; PixelIndex < Pixels.Num(); ++PixelIndex)
+	{
+		const float Channels[3] = { Pixels[PixelIndex].R, Pixels[PixelIndex].G, Pixels[PixelIndex].B };
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			const int32 Expected = SimpleRenderingCPUGolden::Pixels[PixelIndex * 3 + Channel];
+			const int32 Error = FMath::Abs(FMath::RoundToInt(Channels[Channel] * 255.0f) - Expected);
+			MaxError = FMath::Max(MaxError, Error);
+			if (Error > Tolerance && NumMismatches++ < 8)
+			{
+				AddError(FString::Printf(TEXT("Pixel (%d, %d) channel %d is %d, expected %d"),
+					PixelIndex % SimpleRenderingCPUGolden::SizeX, PixelIndex / SimpleRenderingCPUGolden::SizeX, Channel, Expected + Error, Expected));
+			}
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Largest channel difference %d/255, %d over the tolerance"), MaxError, NumMismatches));
+	return NumMismatches == 0;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleRenderingCPUThroughputTest, "BRPlugins.Rendering.ComputeCPU.Throughput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FSimpleRenderingCPUThroughputTest::RunTest(const FString& Parameters)
+{
+	FSimpleShaderParameter Parameter;
+	Parameter.Color1 = FLinearColor(2.5f, 0.0f, 0.0f, 1.0f);
+	Parameter.ColorIndex = -1;
+
+	TArray<FLinearColor> Pixels;
+	for (const FIntPoint Size : { FIntPoint(256, 256), FIntPoint(1920, 1080) })
+	{
+		// Warm up the task graph workers before timing
+		SimpleRenderingExample::ComputeCPU(Size.X, 16, Parameter, Pixels);
+
+		const double StartTime = FPlatformTime::Seconds();
+		SimpleRenderingExample::ComputeCPU(Size.X, Size.Y, Parameter, Pixels);
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		TestEqual(FString::Printf(TEXT("%dx%d pixel count"), Size.X, Size.Y), Pixels.Num(), Size.X * Size.Y);
+		AddInfo(FString::Printf(TEXT("%dx%d: %.1f ms, %.2f megapixels per second"), Size.X, Size.Y, Seconds * 1000.0, Pixels.Num() / FMath::Max(Seconds, 1e-9) / 1.0e6));
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,159 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Rendering/SimpleRenderingReadback.h"
+#include "Tests/SimpleRenderingTestTarget.h"
+
+#include "RenderingThread.h"
+
+namespace SimpleRenderingReadbackTests
+{
+	/** What the callback saw, written on the delivery worker */
+	struct FDeliveries
+	{
+		FCriticalSection Lock;
+		uint64 LastFrameNumber = 0;
+		int32 NumOutOfOrder = 0;
+		int32 NumConcurrent = 0;
+		FThreadSafeCounter NumInCallback;
+
+		/** The first delivered frame as FColor, to compare with ReadPixels */
+		TArray<FColor> FirstFrame;
+	};
+
+	static void CopyToColors(const SimpleRenderingExample::FSimpleReadbackFrame& Frame, TArray<FColor>& OutColors)
+	{
+		OutColors.SetNumUninitialized(Frame.Size.X * Frame.Size.Y);
+		for (int32 Y = 0; Y < Frame.Size.Y; ++Y)
+		{
+			const uint8* Row = Frame.GetRow(Y);
+			for (int32 X = 0; X < Frame.Size.X; ++X)
+			{
+				const uint8* Texel = Row + X * 4;
+				FColor& Color = OutColors[Y * Frame.Size.X + X];
+				Color = Frame.Format == PF_R8G8B8A8 ? FColor(Texel[0], Texel[1], Texel[2], Texel[3]) : FColor(Texel[2], Texel[1], Texel[0], Texel[3]);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleRenderingReadbackBenchmark, "BRPlugins.Rendering.Readback.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FSimpleRenderingReadbackBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace SimpleRenderingExample;
+	using namespace SimpleRenderingReadbackTests;
+
+	const int32 NumSlots = 3;
+	const int32 NumFrames = 120;
+	const int32 NumSyncReads = 8;
+	const double TimeoutSeconds = 30.0;
+
+	UTextureRenderTarget2D* RenderTarget = SimpleRenderingTestTarget::Create(FIntPoint(1920, 1080), RTF_RGBA8);
+
+	FSimpleShaderParameter Parameter;
+	Parameter.Color1 = FLinearColor(2.5f, 0.0f, 0.0f, 1.0f);
+	Parameter.ColorIndex = -1;
+
+	// The synchronous ReadPixels the ring replaces, it waits for the render thread and the GPU on every call
+	TArray<FColor> Pixels;
+	double SyncSeconds = 0.0;
+	for (int32 Read = 0; Read <= NumSyncReads; ++Read)
+	{
+		USimpleRenderingExampleBlueprintLibrary::UseRDGComput(nullptr, RenderTarget, Parameter);
+		FlushRDGRequests();
+
+		const double StartTime = FPlatformTime::Seconds();
+		RenderTarget->GameThread_GetRenderTargetResource()->ReadPixels(Pixels);
+		// The first read creates the pipelines and the staging texture
+		if (Read > 0)
+		{
+			SyncSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+	}
+	const int64 FrameBytes = static_cast<int64>(Pixels.Num()) * sizeof(FColor);
+
+	// Deliveries are counted by the ring itself, the callback checks their order and keeps the first frame
+	TSharedRef<FDeliveries, ESPMode::ThreadSafe> Deliveries = MakeShared<FDeliveries, ESPMode::ThreadSafe>();
+	TSharedRef<FSimpleRenderTargetReadback, ESPMode::ThreadSafe> Readback = FSimpleRenderTargetReadback::Create(NumSlots, [Deliveries](const FSimpleReadbackFrame& Frame)
+	{
+		if (Deliveries->NumInCallback.Increment() > 1)
+		{
+			FScopeLock Lock(&Deliveries->Lock);
+			++Deliveries->NumConcurrent;
+		}
+		{
+			FScopeLock Lock(&Deliveries->Lock);
+			Deliveries->NumOutOfOrder += Frame.FrameNumber > Deliveries->LastFrameNumber ? 0 : 1;
+			Deliveries->LastFrameNumber = Frame.FrameNumber;
+			if (Deliveries->FirstFrame.Num() == 0)
+			{
+				CopyToColors(Frame, Deliveries->FirstFrame);
+			}
+		}
+		Deliveries->NumInCallback.Decrement();
+	});
+
+	// One render and capture per editor frame, so the ring is polled between captures like it would be in game
+	int32 NumCaptured = 0;
+	double CaptureSeconds = 0.0;
+	double LastCaptureTime = 0.0;
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Readback, Deliveries, Pixels, RenderTarget, Parameter, NumCaptured, CaptureSeconds, LastCaptureTime,
+		NumSlots, NumFrames, NumSyncReads, TimeoutSeconds, SyncSeconds, FrameBytes]() mutable
+	{
+		if (NumCaptured < NumFrames)
+		{
+			USimpleRenderingExampleBlueprintLibrary::UseRDGComput(nullptr, RenderTarget, Parameter);
+
+			const double StartTime = FPlatformTime::Seconds();
+			Readback->Capture(RenderTarget);
+			LastCaptureTime = FPlatformTime::Seconds();
+			CaptureSeconds += LastCaptureTime - StartTime;
+			++NumCaptured;
+			return false;
+		}
+
+		const FSimpleReadbackStats Stats = Readback->GetStats();
+		const bool bFinished = Stats.NumDelivered + Stats.NumDropped >= NumFrames;
+		if (!bFinished && FPlatformTime::Seconds() - LastCaptureTime < TimeoutSeconds)
+		{
+			return false;
+		}
+
+		if (bFinished)
+		{
+			AddInfo(FString::Printf(TEXT("ReadPixels: %.3f ms blocked per frame, %.1f MB/s"),
+				SyncSeconds * 1000.0 / NumSyncReads, FrameBytes * NumSyncReads / FMath::Max(SyncSeconds, 1e-9) / (1024.0 * 1024.0)));
+			AddInfo(FString::Printf(TEXT("Readback ring of %d: %.3f ms blocked per frame, %lld delivered, %lld dropped, latency %.3f ms average %.3f ms max, %.1f MB/s"),
+				NumSlots, CaptureSeconds * 1000.0 / NumFrames, Stats.NumDelivered, Stats.NumDropped,
+				Stats.AverageLatencySeconds * 1000.0, Stats.MaxLatencySeconds * 1000.0, Stats.BytesPerSecond / (1024.0 * 1024.0)));
+			TestTrue(TEXT("Frames were delivered"), Stats.NumDelivered > 0);
+
+			FScopeLock Lock(&Deliveries->Lock);
+			TestEqual(TEXT("Frames delivered out of capture order"), Deliveries->NumOutOfOrder, 0);
+			TestEqual(TEXT("Callbacks that overlapped another one"), Deliveries->NumConcurrent, 0);
+
+			// Every frame renders the same parameters, so any delivered frame has to match the synchronous read
+			int32 NumMismatches = 0;
+			for (int32 Index = 0; Index < Pixels.Num() && Index < Deliveries->FirstFrame.Num(); ++Index)
+			{
+				NumMismatches += Deliveries->FirstFrame[Index] == Pixels[Index] ? 0 : 1;
+			}
+			TestEqual(TEXT("Read back pixel count"), Deliveries->FirstFrame.Num(), Pixels.Num());
+			TestEqual(TEXT("Read back pixels differing from ReadPixels"), NumMismatches, 0);
+		}
+		else
+		{
+			AddError(FString::Printf(TEXT("Only %lld of %d captures were delivered or dropped within %.0f seconds"), Stats.NumDelivered + Stats.NumDropped, NumFrames, TimeoutSeconds));
+		}
+
+		SimpleRenderingTestTarget::Destroy(RenderTarget);
+		return true;
+	}));
+
+	return true;
+}
+
+#endif
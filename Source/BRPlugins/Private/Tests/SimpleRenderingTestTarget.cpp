@@ -0,0 +1,112 @@
+#include "Tests/SimpleRenderingTestTarget.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/Event.h"
+#include "RenderingThread.h"
+
+UTextureRenderTarget2D* SimpleRenderingTestTarget::Create(FIntPoint Size, ETextureRenderTargetFormat Format)
+{
+	UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), NAME_None, RF_Transient);
+	RenderTarget->AddToRoot();
+	RenderTarget->RenderTargetFormat = Format;
+	RenderTarget->bCanCreateUAV = true;
+	RenderTarget->ClearColor = FLinearColor::Black;
+	RenderTarget->InitAutoFormat(Size.X, Size.Y);
+	RenderTarget->UpdateResourceImmediate(true);
+	FlushRenderingCommands();
+	return RenderTarget;
+}
+
+UTexture2D* SimpleRenderingTestTarget::CreateGradientTexture(FIntPoint Size)
+{
+	UTexture2D* Texture = UTexture2D::CreateTransient(Size.X, Size.Y, PF_B8G8R8A8);
+	Texture->AddToRoot();
+	Texture->SRGB = false;
+	Texture->Filter = TF_Nearest;
+
+	FColor* Texels = static_cast<FColor*>(Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE));
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+	{
+		for (int32 X = 0; X < Size.X; ++X)
+		{
+			Texels[Y * Size.X + X] = FColor(static_cast<uint8>(X * 255 / FMath::Max(Size.X - 1, 1)), static_cast<uint8>(Y * 255 / FMath::Max(Size.Y - 1, 1)), 64, 255);
+		}
+	}
+	Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
+
+	Texture->UpdateResource();
+	FlushRenderingCommands();
+	return Texture;
+}
+
+void SimpleRenderingTestTarget::Destroy(UTexture* Texture)
+{
+	if (Texture)
+	{
+		Texture->RemoveFromRoot();
+		Texture->MarkAsGarbage();
+	}
+}
+
+SimpleRenderingTestTarget::FRenderTimer::~FRenderTimer()
+{
+	// End flushes, a timer that never ended still has the render thread waiting
+	if (StartEvent)
+	{
+		End();
+	}
+}
+
+void SimpleRenderingTestTarget::FRenderTimer::Begin()
+{
+	check(IsInGameThread() && !StartEvent);
+
+	FlushRenderingCommands();
+	StartEvent = FPlatformProcess::GetSynchEventFromPool(true);
+
+	ENQUEUE_RENDER_COMMAND(SimpleRenderingTestTimerBegin)
+	(
+		[this](FRHICommandListImmediate &RHICmdList) {
+			// Without a rendering thread the command runs inline and the game thread must not wait on itself
+			if (GIsThreadedRendering)
+			{
+				StartEvent->Wait();
+			}
+			BeginQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+			EndQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+			RHICmdList.EndRenderQuery(BeginQuery);
+			BeginSeconds = FPlatformTime::Seconds();
+		});
+}
+
+void SimpleRenderingTestTarget::FRenderTimer::End()
+{
+	check(IsInGameThread() && StartEvent);
+
+	ENQUEUE_RENDER_COMMAND(SimpleRenderingTestTimerEnd)
+	(
+		[this](FRHICommandListImmediate &RHICmdList) {
+			RenderThreadMilliseconds = (FPlatformTime::Seconds() - BeginSeconds) * 1000.0;
+			RHICmdList.EndRenderQuery(EndQuery);
+			RHICmdList.ImmediateFlush(EImmediateFlushType::FlushRHIThread);
+
+			uint64 BeginTime = 0;
+			uint64 EndTime = 0;
+			GPUMilliseconds = -1.0;
+			if (RHIGetRenderQueryResult(BeginQuery, BeginTime, true) && RHIGetRenderQueryResult(EndQuery, EndTime, true) && EndTime >= BeginTime)
+			{
+				GPUMilliseconds = (EndTime - BeginTime) / 1000.0;
+			}
+			BeginQuery.SafeRelease();
+			EndQuery.SafeRelease();
+		});
+
+	StartEvent->Trigger();
+	FlushRenderingCommands();
+
+	FPlatformProcess::ReturnSynchEventToPool(StartEvent);
+	StartEvent = nullptr;
+}
+
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RHI.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+/** Render targets and timing for the rendering automation tests and benchmarks */
+namespace SimpleRenderingTestTarget
+{
+	/** Rooted render target that allows UAVs, its resource is created before this returns. Dropped with Destroy */
+	UTextureRenderTarget2D* Create(FIntPoint Size, ETextureRenderTargetFormat Format = RTF_RGBA16f);
+
+	/** Rooted linear BGRA8 texture, red grows along X and green along Y, so every texel differs from its neighbours. Dropped with Destroy */
+	UTexture2D* CreateGradientTexture(FIntPoint Size);
+
+	void Destroy(UTexture* Texture);
+
+	/**
+	 * Render thread and GPU time of the render commands enqueued between Begin and End. The render thread holds at Begin until
+	 * End is called, so the time the game thread takes to enqueue is not counted. Nothing in between may wait for the render thread
+	 */
+	class FRenderTimer
+	{
+	public:
+		~FRenderTimer();
+
+		void Begin();
+
+		/** Waits for the render thread and the GPU */
+		void End();
+
+		double RenderThreadMilliseconds = 0.0;
+
+		/** Negative when the RHI has no timestamp queries */
+		double GPUMilliseconds = -1.0;
+
+	private:
+		FEvent* StartEvent = nullptr;
+		FRenderQueryRHIRef BeginQuery;
+		FRenderQueryRHIRef EndQuery;
+		double BeginSeconds = 0.0;
+	};
+}
+
+#endif
@@ -4,8 +4,29 @@
 
 #include "CoreMinimal.h"
 #include "AnimationBlueprintLibrary.h" 
+// Only for the types of UFUNCTION parameters, which UHT needs complete. The .cpp includes what its implementation uses
+#include "Editor/AnimModifier/AnimCurveImporter.h"
+#include "Editor/AnimModifier/AnimCurveLUT.h"
+#include "Editor/AnimModifier/AnimCurveNameCache.h"
+#include "Editor/AnimModifier/AnimCurveReduction.h"
+#include "Editor/AnimModifier/AnimModifierBatchRunner.h"
+#include "Editor/AnimModifier/AnimPoseSampleCache.h"
+#include "Editor/AnimModifier/AnimRootMotionAnalysis.h"
 #include "AnimBlueprintLibrary.generated.h"
 
+/** Keys for a single float curve, used by the multi curve entry points */
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveKeys
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	TArray<float> Times;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	TArray<float> Values;
+};
+
 /**
  * 
  */
@@ -22,6 +43,132 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
 	static void AddFloatCurveKeysWithType(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<float>& Values, EInterpCurveMode InterpMode);
 
+	/** Adds a multiple of Vector Keys to the specified Animation Curve inside of the given Animation Sequence */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void AddVectorCurveKeysWithType(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<FVector>& Vectors, EInterpCurveMode InterpMode);
+
+	/** Adds a multiple of Transformation Keys to the specified Animation Curve inside of the given Animation Sequence */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void AddTransformationCurveKeysWithType(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<FTransform>& Transforms, EInterpCurveMode InterpMode);
+
+	/**
+	 * Adds Float Keys to the specified Animation Curve after removing the keys that are redundant within Reduction.MaxError.
+	 * With reduction enabled the reduced keys replace every existing key between the first and last of the given times
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void AddFloatCurveKeysWithReduction(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<float>& Values, EInterpCurveMode InterpMode, const FAnimCurveReductionSettings& Reduction, FAnimCurveReductionReport& OutReport);
+
+	/** Adds keys to several Animation Curves of the given Animation Sequence and bakes the sequence once */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void AddFloatCurvesKeysWithType(UAnimSequence* AnimationSequence, const TMap<FName, FAnimCurveKeys>& CurveKeys, EInterpCurveMode InterpMode);
+
+	/** Imports per frame curve data from csv or raw float files. Files are memory mapped and streamed into the bulk key path */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void ImportCurveKeysFromFiles(const TArray<FAnimCurveImportSource>& Sources, FAnimCurveImportReport& OutReport);
+
+	/** Bakes float curves onto one uniform grid for fast evaluation, sampled finely enough and quantized to 16 bits when that stays within Settings.MaxError */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void BakeFloatCurvesToLUT(UAnimSequence* AnimationSequence, const TArray<FName>& CurveNames, const FAnimCurveLUTSettings& Settings, FAnimCurveLUT& OutLUT, FAnimCurveLUTReport& OutReport);
+
+	/** Evaluates every curve of a baked table at Time, in the order of the names it was baked from. Zeros when the table is not valid */
+	UFUNCTION(BlueprintPure, Category = "AnimationBlueprintLibrary|Curves")
+	static void EvaluateCurveLUT(const FAnimCurveLUT& LUT, float Time, TArray<float>& OutValues);
+
+	/** Compares FRichCurve::Eval on the source curves against the baked table */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static FAnimCurveLUTTiming MeasureCurveLUTEvaluation(UAnimSequence* AnimationSequence, const TArray<FName>& CurveNames, const FAnimCurveLUT& LUT, int32 NumEvaluations = 100000);
+
+	/**
+	 * Defers BakeTrackCurvesToRawAnimation for every curve edit until the matching EndCurveBatch. Batches can be nested.
+	 * Poses sampled by native analysis functions inside the batch are shared through the pose sample cache.
+	 * A batch left open is closed with a warning by the next BeginCurveBatch in a later frame, or when the modifier run around it finishes
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void BeginCurveBatch();
+
+	/** Closes a batch opened by BeginCurveBatch, the outermost one bakes each touched Animation Sequence exactly once */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void EndCurveBatch();
+
+	/**
+	 * Applies the modifiers to every sequence, in order. Native modifiers implementing IParallelAnimModifier analyze sequences in parallel,
+	 * only curve writes, Blueprint modifiers and bakes run on the game thread. The runs are not recorded on the sequences and can not be reverted
+	 */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Modifiers")
+	static void ApplyAnimationModifiers(const TArray<UAnimSequence*>& AnimationSequences, const TArray<TSubclassOf<UAnimationModifier>>& ModifierClasses, bool bRunInParallel, FAnimModifierBatchReport& OutReport);
+
+	/** Computes heading, speed and turn rate curves from the root track and adds them to the given Animation Sequence */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|RootMotion")
+	static void AddRootMotionDirectionCurves(UAnimSequence* AnimationSequence, const FRootMotionDirectionSettings& Settings);
+
+	/** Writes the curves, sync markers and notifies produced by an IParallelAnimModifier analysis to the sequence, curves reduced if the output asks for it */
+	static void ApplyCurveOutput(UAnimSequence* AnimationSequence, const FAnimModifierCurveOutput& CurveOutput, FAnimCurveReductionReport* OutReductionReport = nullptr);
+
+	/** Returns the hit/miss counters of the skeleton curve name cache used by the curve key functions */
+	UFUNCTION(BlueprintPure, Category = "AnimationBlueprintLibrary|Curves")
+	static FAnimCurveNameCacheStats GetCurveNameCacheStats();
+
+	/** Zeroes the hit/miss counters of the skeleton curve name cache, its entries are kept */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Curves")
+	static void ResetCurveNameCacheStats();
+
+	/** Returns the counters of the pose sample cache shared by native modifiers within a batch */
+	UFUNCTION(BlueprintPure, Category = "AnimationBlueprintLibrary|Modifiers")
+	static FAnimPoseSampleCacheStats GetPoseSampleCacheStats();
+
+	/** Zeroes the hit, miss and eviction counters of the pose sample cache, AllocatedBytes keeps tracking the live entries */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Modifiers")
+	static void ResetPoseSampleCacheStats();
+
+	/** Memory cap of the pose sample cache, least recently used poses are evicted above it */
+	UFUNCTION(BlueprintCallable, Category = "AnimationBlueprintLibrary|Modifiers")
+	static void SetPoseSampleCacheBudget(int32 BudgetMegaBytes);
+
+	/** Converts the interp mode once for a whole batch of keys */
+	static void ConvertInterpMode(EInterpCurveMode InterpMode, ERichCurveInterpMode& OutInterpMode, ERichCurveTangentMode& OutTangentMode);
+
+	/** Adds the float curve if it does not exist yet, or recreates it empty when bReplaceExisting is set */
+	static void PrepareFloatCurve(UAnimSequence* AnimationSequence, FName CurveName, bool bReplaceExisting);
+
+	/** Bulk path for callers that build keys themselves, the keys must be sorted by time. Returns false if the curve does not exist */
+	static bool AddSortedFloatCurveKeys(UAnimSequence* AnimationSequence, FName CurveName, TArray<FRichCurveKey>& SortedKeys, const FAnimCurveReductionSettings* Reduction = nullptr, FAnimCurveReductionReport* OutReductionReport = nullptr);
+
+	/**
+	 * Sorts the keys once and merges them into the curve in a single pass, instead of a search and insert per key.
+	 * Works for float, vector and transform curves, every component curve receives its part of the batch in one merge
+	 */
 	template <typename DataType, typename CurveClass> 
-	static void AddCurveKeysInternal(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<DataType>& KeyData, ERawCurveTrackTypes CurveType, EInterpCurveMode InterpMode);
+	static void AddCurveKeysInternal(UAnimSequence* AnimationSequence, FName CurveName, const TArray<float>& Times, const TArray<DataType>& KeyData, ERawCurveTrackTypes CurveType, EInterpCurveMode InterpMode,
+		const FAnimCurveReductionSettings* Reduction = nullptr, FAnimCurveReductionReport* OutReductionReport = nullptr);
+
+protected:
+	/** Curve of the given type on the sequence, resolving its name through the curve name cache */
+	template <typename CurveClass>
+	static CurveClass* FindCurveForWrite(UAnimSequence* AnimationSequence, FName CurveName, ERawCurveTrackTypes CurveType);
+
+	/** Read-only FindCurveForWrite */
+	template <typename CurveClass>
+	static const CurveClass* FindCurve(const UAnimSequence* AnimationSequence, FName CurveName, ERawCurveTrackTypes CurveType);
+
+	/** Float curve of every name in order, missing curves keep their slot as nullptr */
+	static void GatherFloatCurves(const UAnimSequence* AnimationSequence, const TArray<FName>& CurveNames, TArray<const FRichCurve*>& OutCurves);
+
+	/** Cached RetrieveContainerNameForCurve + RetrieveSmartNameForCurve, returns false if the curve does not exist */
+	static bool FindCurveSmartName(const UAnimSequence* AnimationSequence, FName CurveName, FName& OutContainerName, FSmartName& OutSmartName);
+
+	/** Bakes the sequence now, or once at the end of the current curve batch */
+	static void RequestBakeTrackCurves(UAnimSequence* AnimationSequence);
+};
+
+/** Scoped C++ counterpart of BeginCurveBatch/EndCurveBatch, script batches still open inside it are closed with a warning when it ends */
+struct BRPLUGINS_API FAnimCurveBatchScope
+{
+	FAnimCurveBatchScope();
+	~FAnimCurveBatchScope();
+
+	UE_NONCOPYABLE(FAnimCurveBatchScope);
+
+private:
+	/** Script batch depth when the scope began */
+	int32 OuterScriptBatchDepth;
 };
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Editor/AnimModifier/AnimCurveReduction.h"
+#include "AnimCurveImporter.generated.h"
+
+class UAnimSequence;
+
+UENUM(BlueprintType)
+enum class EAnimCurveImportFormat : uint8
+{
+	/** Text rows of "Time,Value0,Value1,...", an optional header row names the curves */
+	Csv,
+	/** Little endian float32 rows of Time followed by one value per curve, curves named by the import source */
+	RawFloat32,
+};
+
+/** One file feeding curves of one sequence */
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveImportSource
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	UAnimSequence* AnimationSequence = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	FString FilePath;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	EAnimCurveImportFormat Format = EAnimCurveImportFormat::Csv;
+
+	/** Curve of each value column. Required for raw files, overrides the header of csv files when set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	TArray<FName> CurveNames;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	TEnumAsByte<EInterpCurveMode> InterpMode = CIM_Linear;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	bool bReplaceExistingCurves = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	FAnimCurveReductionSettings KeyReduction;
+};
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveImportReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 NumFilesImported = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 NumFilesFailed = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int64 NumBytes = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int64 NumRows = 0;
+
+	/** Time spent mapping and parsing files */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float ParseSeconds = 0.0f;
+
+	/** Time spent merging keys into curves */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float ApplySeconds = 0.0f;
+
+	/** Parse throughput in megabytes per second */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float ParseMegaBytesPerSecond = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	FAnimCurveReductionReport KeyReduction;
+};
+
+/**
+ * Imports per frame curve data from large files.
+ * Files are memory mapped and parsed window by window straight into curve keys. The keys of a window are merged into the curves
+ * through the bulk key path before the next window is parsed, so only one window worth of keys is held besides the curves.
+ * Values that do not fit a finite float add no key.
+ */
+class BRPLUGINS_API FAnimCurveImporter
+{
+public:
+	static void Import(const TArray<FAnimCurveImportSource>& Sources, FAnimCurveImportReport& OutReport);
+};
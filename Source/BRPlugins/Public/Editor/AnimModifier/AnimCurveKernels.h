@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Per frame analysis kernels over contiguous float arrays, 4 frames per iteration with a scalar tail.
+ * Output arrays must not alias the inputs.
+ */
+namespace AnimCurveKernels
+{
+	/** Out[i] = In[i] * Scale + Offset */
+	inline void ScaleOffset(const float* In, int32 Num, float Scale, float Offset, float* Out)
+	{
+		const VectorRegister4Float ScaleVec = VectorSetFloat1(Scale);
+		const VectorRegister4Float OffsetVec = VectorSetFloat1(Offset);
+
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			VectorStore(VectorMultiplyAdd(VectorLoad(In + Index), ScaleVec, OffsetVec), Out + Index);
+		}
+		for (; Index < Num; ++Index)
+		{
+			Out[Index] = In[Index] * Scale + Offset;
+		}
+	}
+
+	/** Central difference derivative of a sampled signal, one sided at both ends */
+	inline void Derivative(const float* In, int32 Num, float InvDeltaTime, float* Out)
+	{
+		if (Num < 2)
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				Out[Index] = 0.0f;
+			}
+			return;
+		}
+
+		const float HalfInvDeltaTime = 0.5f * InvDeltaTime;
+		const VectorRegister4Float HalfInvDeltaTimeVec = VectorSetFloat1(HalfInvDeltaTime);
+
+		int32 Index = 1;
+		for (; Index + 4 <= Num - 1; Index += 4)
+		{
+			VectorStore(VectorMultiply(VectorSubtract(VectorLoad(In + Index + 1), VectorLoad(In + Index - 1)), HalfInvDeltaTimeVec), Out + Index);
+		}
+		for (; Index < Num - 1; ++Index)
+		{
+			Out[Index] = (In[Index + 1] - In[Index - 1]) * HalfInvDeltaTime;
+		}
+
+		Out[0] = (In[1] - In[0]) * InvDeltaTime;
+		Out[Num - 1] = (In[Num - 1] - In[Num - 2]) * InvDeltaTime;
+	}
+
+	/** Out[i] = |(X[i], Y[i])| */
+	inline void Length2(const float* X, const float* Y, int32 Num, float* Out)
+	{
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const VectorRegister4Float XVec = VectorLoad(X + Index);
+			const VectorRegister4Float YVec = VectorLoad(Y + Index);
+			VectorStore(VectorSqrt(VectorMultiplyAdd(XVec, XVec, VectorMultiply(YVec, YVec))), Out + Index);
+		}
+		for (; Index < Num; ++Index)
+		{
+			Out[Index] = FMath::Sqrt(X[Index] * X[Index] + Y[Index] * Y[Index]);
+		}
+	}
+
+	/** Out[i] = (X[i], Y[i], Z[i]) | Direction */
+	inline void Dot3(const float* X, const float* Y, const float* Z, const FVector3f& Direction, int32 Num, float* Out)
+	{
+		const VectorRegister4Float DirectionX = VectorSetFloat1(Direction.X);
+		const VectorRegister4Float DirectionY = VectorSetFloat1(Direction.Y);
+		const VectorRegister4Float DirectionZ = VectorSetFloat1(Direction.Z);
+
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const VectorRegister4Float Projected = VectorMultiplyAdd(VectorLoad(X + Index), DirectionX,
+				VectorMultiplyAdd(VectorLoad(Y + Index), DirectionY, VectorMultiply(VectorLoad(Z + Index), DirectionZ)));
+			VectorStore(Projected, Out + Index);
+		}
+		for (; Index < Num; ++Index)
+		{
+			Out[Index] = X[Index] * Direction.X + Y[Index] * Direction.Y + Z[Index] * Direction.Z;
+		}
+	}
+
+	/** Out[i] = atan2(Y[i], X[i]) in degrees */
+	inline void Atan2Degrees(const float* Y, const float* X, int32 Num, float* Out)
+	{
+		const VectorRegister4Float RadToDeg = VectorSetFloat1(180.0f / PI);
+
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			VectorStore(VectorMultiply(VectorATan2(VectorLoad(Y + Index), VectorLoad(X + Index)), RadToDeg), Out + Index);
+		}
+		for (; Index < Num; ++Index)
+		{
+			Out[Index] = FMath::RadiansToDegrees(FMath::Atan2(Y[Index], X[Index]));
+		}
+	}
+
+	/** Yaw in degrees of the rotations given as quaternion components */
+	inline void QuatYawDegrees(const float* QX, const float* QY, const float* QZ, const float* QW, int32 Num, float* Out)
+	{
+		const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+		const VectorRegister4Float RadToDeg = VectorSetFloat1(180.0f / PI);
+
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const VectorRegister4Float X = VectorLoad(QX + Index);
+			const VectorRegister4Float Y = VectorLoad(QY + Index);
+			const VectorRegister4Float Z = VectorLoad(QZ + Index);
+			const VectorRegister4Float W = VectorLoad(QW + Index);
+
+			// Same terms as FQuat::Rotator
+			const VectorRegister4Float YawY = VectorMultiply(Two, VectorMultiplyAdd(W, Z, VectorMultiply(X, Y)));
+			const VectorRegister4Float YawX = VectorSubtract(VectorOne(), VectorMultiply(Two, VectorMultiplyAdd(Y, Y, VectorMultiply(Z, Z))));
+			VectorStore(VectorMultiply(VectorATan2(YawY, YawX), RadToDeg), Out + Index);
+		}
+		for (; Index < Num; ++Index)
+		{
+			const float YawY = 2.0f * (QW[Index] * QZ[Index] + QX[Index] * QY[Index]);
+			const float YawX = 1.0f - 2.0f * (QY[Index] * QY[Index] + QZ[Index] * QZ[Index]);
+			Out[Index] = FMath::RadiansToDegrees(FMath::Atan2(YawY, YawX));
+		}
+	}
+
+	/** Removes 360 degree jumps between consecutive angles, in place */
+	inline void UnwindDegrees(float* InOut, int32 Num)
+	{
+		for (int32 Index = 1; Index < Num; ++Index)
+		{
+			InOut[Index] = InOut[Index - 1] + FMath::UnwindDegrees(InOut[Index] - InOut[Index - 1]);
+		}
+	}
+
+	/** Centered moving average over 2 * HalfWindow + 1 samples, the window shrinks at both ends. O(Num) through a running sum */
+	inline void MovingAverage(const float* In, int32 Num, int32 HalfWindow, float* Out)
+	{
+		if (HalfWindow <= 0)
+		{
+			FMemory::Memcpy(Out, In, Num * sizeof(float));
+			return;
+		}
+
+		double Sum = 0.0;
+		int32 WindowBegin = 0;
+		int32 WindowEnd = 0;
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			const int32 NewBegin = FMath::Max(0, Index - HalfWindow);
+			const int32 NewEnd = FMath::Min(Num, Index + HalfWindow + 1);
+			for (; WindowEnd < NewEnd; ++WindowEnd)
+			{
+				Sum += In[WindowEnd];
+			}
+			for (; WindowBegin < NewBegin; ++WindowBegin)
+			{
+				Sum -= In[WindowBegin];
+			}
+			Out[Index] = static_cast<float>(Sum / (WindowEnd - WindowBegin));
+		}
+	}
+}
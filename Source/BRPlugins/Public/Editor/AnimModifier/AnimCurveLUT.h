@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/RichCurve.h"
+#include "AnimCurveLUT.generated.h"
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveLUTSettings
+{
+	GENERATED_BODY()
+
+	/** Samples per second of the shared grid, raised up to MaxSampleRate while the table misses MaxError */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves", meta = (ClampMin = "1"))
+	float SampleRate = 120.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves", meta = (ClampMin = "1"))
+	float MaxSampleRate = 4800.0f;
+
+	/** Largest allowed difference between the table and FRichCurve::Eval halfway between samples, decides the sample rate and 16 bit quantization */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves", meta = (ClampMin = "0"))
+	float MaxError = 0.001f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	bool bAllowQuantization = true;
+};
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveLUTReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 NumSamples = 0;
+
+	/** Sample rate the table was baked at, above Settings.SampleRate when that missed MaxError */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float SampleRate = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	bool bQuantized = false;
+
+	/** Largest difference to FRichCurve::Eval, measured halfway between samples */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float MaxError = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 NumBytes = 0;
+};
+
+/**
+ * A bank of curves baked onto one uniform time grid, stored sample major so a single lookup
+ * interpolates every curve with 4 wide vector lerps. Time is clamped to the baked range.
+ */
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveLUT
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float StartTime = 0.0f;
+
+	UPROPERTY()
+	float SampleInterval = 0.0f;
+
+	UPROPERTY()
+	int32 NumSamples = 0;
+
+	UPROPERTY()
+	int32 NumCurves = 0;
+
+	/** NumCurves rounded up to a multiple of 4, the row stride of both sample arrays */
+	UPROPERTY()
+	int32 Stride = 0;
+
+	/** [Sample * Stride + Curve], empty when quantized */
+	UPROPERTY()
+	TArray<float> Samples;
+
+	/** [Sample * Stride + Curve], Value = Quantized * Scales[Curve] + Offsets[Curve] */
+	UPROPERTY()
+	TArray<uint16> QuantizedSamples;
+
+	UPROPERTY()
+	TArray<float> Scales;
+
+	UPROPERTY()
+	TArray<float> Offsets;
+
+	bool IsValid() const { return NumSamples > 0 && NumCurves > 0; }
+	bool IsQuantized() const { return QuantizedSamples.Num() > 0; }
+	int32 GetAllocatedSize() const;
+
+	/** Bakes the curves over the union of their key ranges */
+	void Build(TArrayView<const FRichCurve* const> Curves, const FAnimCurveLUTSettings& Settings, FAnimCurveLUTReport& OutReport);
+
+	/** Writes the value of every curve at Time, zeros when the table is not valid. OutValues must hold at least Stride floats */
+	void Evaluate(float Time, float* OutValues) const;
+};
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveLUTTiming
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float RichCurveNanosecondsPerCurve = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float LUTNanosecondsPerCurve = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float Speedup = 0.0f;
+};
+
+namespace AnimCurveLUT
+{
+	/** Times FRichCurve::Eval against FAnimCurveLUT::Evaluate over the same pseudo random times */
+	BRPLUGINS_API FAnimCurveLUTTiming MeasureEvaluation(const FAnimCurveLUT& LUT, TArrayView<const FRichCurve* const> Curves, int32 NumEvaluations);
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/SmartName.h"
+#include "AnimCurveNameCache.generated.h"
+
+class USkeleton;
+
+/** Hit/miss counters of the curve name cache */
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveNameCacheStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 Hits = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 Misses = 0;
+
+	/** Number of times a skeleton's entries were dropped because its smart name mapping changed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 Invalidations = 0;
+};
+
+/**
+ * Per skeleton cache of curve container and smart name lookups.
+ * Entries of a skeleton are dropped as soon as its smart name mapping changes, entries of destroyed skeletons on the next miss. Game thread only.
+ */
+class BRPLUGINS_API FAnimCurveNameCache
+{
+public:
+	typedef TFunctionRef<bool(FName& OutContainerName, FSmartName& OutSmartName)> FResolveCurveName;
+
+	static FAnimCurveNameCache& Get();
+
+	/** Returns the cached names of the curve, calling Resolve on a miss. Unresolved curves are not cached */
+	bool FindOrResolve(USkeleton* Skeleton, FName CurveName, FName& OutContainerName, FSmartName& OutSmartName, FResolveCurveName Resolve);
+
+	/** Drops all entries of the given skeleton */
+	void Invalidate(const USkeleton* Skeleton);
+
+	/** Drops every entry and unregisters from all skeletons */
+	void Reset();
+
+	const FAnimCurveNameCacheStats& GetStats() const { return Stats; }
+	void ResetStats() { Stats = FAnimCurveNameCacheStats(); }
+
+private:
+	struct FCachedCurveName
+	{
+		FName ContainerName;
+		FSmartName SmartName;
+	};
+
+	struct FSkeletonEntry
+	{
+		FDelegateHandle SmartNamesChangedHandle;
+		TMap<FName, FCachedCurveName> Curves;
+	};
+
+	void RemoveStaleEntries();
+	void HandleSmartNamesChanged(TWeakObjectPtr<USkeleton> Skeleton);
+
+	/** Weak keys, so a skeleton allocated at the address of a destroyed one never hits its entries */
+	TMap<TWeakObjectPtr<USkeleton>, FSkeletonEntry> SkeletonEntries;
+	FAnimCurveNameCacheStats Stats;
+};
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/RichCurve.h"
+#include "AnimCurveReduction.generated.h"
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveReductionSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	bool bEnabled = false;
+
+	/** Largest allowed difference between the reduced curve and the input keys */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves", meta = (ClampMin = "0"))
+	float MaxError = 0.001f;
+
+	/** Also try cubic segments with tangents taken from the input when the keys are cubic, otherwise only constant and linear segments are used */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Curves")
+	bool bAllowCubic = true;
+};
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimCurveReductionReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 OriginalKeyCount = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	int32 ReducedKeyCount = 0;
+
+	/** Largest difference measured at the input keys */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Curves")
+	float MaxError = 0.0f;
+
+	void Accumulate(const FAnimCurveReductionReport& Other)
+	{
+		OriginalKeyCount += Other.OriginalKeyCount;
+		ReducedKeyCount += Other.ReducedKeyCount;
+		MaxError = FMath::Max(MaxError, Other.MaxError);
+	}
+};
+
+namespace AnimCurveReduction
+{
+	/**
+	 * Replaces time sorted keys by constant, linear or cubic segments that stay within Settings.MaxError of every input key.
+	 * Segments are never richer than the interp mode of the first key and keep its tangent mode. Each segment is grown greedily
+	 * by exponential then binary search over its end key, O(n log n) overall. Segments that auto tangents move past MaxError are split again.
+	 * Keys closer than KINDA_SMALL_NUMBER are collapsed first, the last one wins.
+	 */
+	BRPLUGINS_API void ReduceKeys(TArray<FRichCurveKey>& InOutKeys, const FAnimCurveReductionSettings& Settings, FAnimCurveReductionReport& OutReport);
+}
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "Templates/SubclassOf.h"
+#include "Editor/AnimModifier/AnimCurveReduction.h"
+#include "AnimModifierBatchRunner.generated.h"
+
+class UAnimNotify;
+class UAnimSequence;
+class UAnimationModifier;
+
+/** Curve keys, sync markers and notifies produced by a modifier's analysis pass, written to the sequence later on the game thread */
+struct BRPLUGINS_API FAnimModifierCurveOutput
+{
+	struct FCurve
+	{
+		FName CurveName;
+		TArray<float> Times;
+		TArray<float> Values;
+		EInterpCurveMode InterpMode = CIM_Linear;
+	};
+
+	struct FSyncMarker
+	{
+		FName MarkerName;
+		float Time = 0.0f;
+		FName TrackName;
+	};
+
+	struct FNotify
+	{
+		float Time = 0.0f;
+		FName TrackName;
+		TSubclassOf<UAnimNotify> NotifyClass;
+	};
+
+	/** Removes curves of the same name before writing, so applying twice gives the same result */
+	bool bReplaceExistingCurves = true;
+
+	/** Optional key reduction applied to every curve before it is written */
+	FAnimCurveReductionSettings Reduction;
+
+	TArray<FCurve> Curves;
+
+	/** Notify tracks removed with their notifies and sync markers before writing, for tracks the modifier owns */
+	TArray<FName> ReplaceNotifyTracks;
+
+	TArray<FSyncMarker> SyncMarkers;
+	TArray<FNotify> Notifies;
+
+	FCurve& AddCurve(FName CurveName, EInterpCurveMode InterpMode)
+	{
+		FCurve& Curve = Curves.AddDefaulted_GetRef();
+		Curve.CurveName = CurveName;
+		Curve.InterpMode = InterpMode;
+		return Curve;
+	}
+};
+
+UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
+class BRPLUGINS_API UParallelAnimModifier : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Implemented by native animation modifiers whose analysis can run off the game thread.
+ * AnalyzeSequence may only read bone animation data of the sequence and must not touch any UObject state,
+ * the batch runner calls it concurrently for different sequences.
+ */
+class BRPLUGINS_API IParallelAnimModifier
+{
+	GENERATED_BODY()
+public:
+	virtual void AnalyzeSequence(const UAnimSequence* AnimationSequence, FAnimModifierCurveOutput& OutCurves) const = 0;
+
+	/** Bones sampled by AnalyzeSequence. The runner samples the union over all modifiers once per sequence into the pose sample cache */
+	virtual void GetRequiredBones(const UAnimSequence* AnimationSequence, TArray<FName>& OutBoneNames) const {}
+};
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimModifierSequenceTiming
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	UAnimSequence* AnimationSequence = nullptr;
+
+	/** Time spent in the read-only analysis of the parallel modifiers run ahead of the game thread */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	float AnalyzeSeconds = 0.0f;
+
+	/** Time spent on the game thread writing curves, running Blueprint modifiers and baking */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	float ApplySeconds = 0.0f;
+};
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimModifierBatchReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	TArray<FAnimModifierSequenceTiming> Sequences;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	float TotalSeconds = 0.0f;
+
+	/** Modifiers implementing IParallelAnimModifier, the others run serially through ApplyToAnimationSequence */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	int32 NumParallelModifiers = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	int32 NumSerialModifiers = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	bool bCancelled = false;
+
+	/** Key counts of the curves reduced by the parallel modifiers */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	FAnimCurveReductionReport KeyReduction;
+};
+
+/**
+ * Applies a list of animation modifiers to many sequences.
+ * Analysis of the IParallelAnimModifier modifiers listed before the first serial modifier runs across sequences on the task graph,
+ * one chunk ahead of the game thread, which writes the curves and runs the remaining modifiers in the given order. The next chunk is
+ * only analyzed while the game thread writes when there is no serial modifier, otherwise the two alternate. Parallel modifiers
+ * after a serial one analyze on the game thread, so the result matches a serial run. Curve writes are baked once per sequence,
+ * and additionally before every modifier running on the game thread so it reads what the earlier ones wrote. Null and repeated sequences are skipped.
+ * Sampled poses are shared between the modifiers through the pose sample cache for the duration of the run.
+ * The modifiers are transient instances and are not recorded in the sequence's animation modifier user data, runs can not be reverted.
+ */
+class BRPLUGINS_API FAnimModifierBatchRunner
+{
+public:
+	static void Run(const TArray<UAnimSequence*>& AnimationSequences, const TArray<TSubclassOf<UAnimationModifier>>& ModifierClasses, bool bRunInParallel, FAnimModifierBatchReport& OutReport);
+};
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "AnimPoseSampleCache.generated.h"
+
+class UAnimSequence;
+class UAnimDataModel;
+struct FAnimPoseSamples;
+struct FAnimDataModelNotifPayload;
+enum class EAnimDataModelNotifyType : uint8;
+
+typedef TSharedPtr<const FAnimPoseSamples, ESPMode::ThreadSafe> FAnimPoseSamplesPtr;
+
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FAnimPoseSampleCacheStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	int32 Hits = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	int32 Misses = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	int32 Evictions = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	int64 AllocatedBytes = 0;
+
+	/** Hits / (Hits + Misses), 0 before the first lookup */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AnimationModifiers")
+	float HitRate = 0.0f;
+};
+
+/**
+ * Shares sampled component space poses between every modifier and library function of a batch run, so a sequence is decompressed once.
+ * Entries are keyed by sequence and bone set, a request is served by any entry sampling a superset of its bones. Poses are always
+ * sampled at the keys of the data model, so a frame rate change drops the entries instead of keying them.
+ * Caching is only active inside an FAnimPoseSampleCacheScope, the last scope to close frees all entries. Thread safe.
+ * Entries are dropped when the bone tracks, length or frame rate of their data model change. Models sampled on worker threads
+ * are only watched from the next game thread lookup or BeginScope, so they must not be edited before that.
+ */
+class BRPLUGINS_API FAnimPoseSampleCache
+{
+public:
+	static FAnimPoseSampleCache& Get();
+
+	/** Returns the samples of the bones, from the cache or freshly sampled. Bones are looked up with FAnimPoseSamples::FindBone of AnimPoseSampling.h */
+	FAnimPoseSamplesPtr FindOrSample(const UAnimSequence* AnimationSequence, TArrayView<const FName> BoneNames);
+
+	/** Least recently used entries are evicted above this size */
+	void SetBudgetBytes(int64 InBudgetBytes);
+	int64 GetBudgetBytes() const { return BudgetBytes; }
+
+	FAnimPoseSampleCacheStats GetStats() const;
+	void ResetStats();
+
+	void BeginScope();
+	void EndScope();
+
+private:
+	struct FEntry
+	{
+		FObjectKey Sequence;
+		FObjectKey DataModel;
+		FAnimPoseSamplesPtr Samples;
+		int64 AllocatedBytes = 0;
+		uint64 LastUse = 0;
+	};
+
+	void EvictToBudget();
+
+	/** Binds OnModelModified to the models sampled so far, game thread only */
+	void WatchPendingModels();
+
+	void OnModelModified(const EAnimDataModelNotifyType& NotifyType, UAnimDataModel* Model, const FAnimDataModelNotifPayload& Payload);
+
+	mutable FCriticalSection CriticalSection;
+	TArray<FEntry> Entries;
+	int64 BudgetBytes = 256 * 1024 * 1024;
+	int32 ScopeDepth = 0;
+	uint64 UseCounter = 0;
+	FAnimPoseSampleCacheStats Stats;
+
+	/** Models of new entries waiting for WatchPendingModels */
+	TArray<TWeakObjectPtr<UAnimDataModel>> PendingModels;
+
+	/** Models OnModelModified is bound to, game thread only */
+	TMap<TWeakObjectPtr<UAnimDataModel>, FDelegateHandle> WatchedModels;
+};
+
+/** Enables the pose sample cache for its lifetime */
+struct FAnimPoseSampleCacheScope
+{
+	FAnimPoseSampleCacheScope()
+	{
+		FAnimPoseSampleCache::Get().BeginScope();
+	}
+
+	~FAnimPoseSampleCacheScope()
+	{
+		FAnimPoseSampleCache::Get().EndScope();
+	}
+
+	UE_NONCOPYABLE(FAnimPoseSampleCacheScope);
+};
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/FrameRate.h"
+
+class UAnimSequence;
+
+/**
+ * Component space transforms of a set of bones for every key of a sequence.
+ * Each component is stored as one contiguous array per bone, [BoneIndex * NumFrames + Frame], so analysis kernels can stream over it.
+ */
+struct BRPLUGINS_API FAnimPoseSamples
+{
+	int32 NumFrames = 0;
+	FFrameRate FrameRate;
+	TArray<FName> BoneNames;
+
+	TArray<float> PositionX;
+	TArray<float> PositionY;
+	TArray<float> PositionZ;
+
+	TArray<float> RotationX;
+	TArray<float> RotationY;
+	TArray<float> RotationZ;
+	TArray<float> RotationW;
+
+	int32 FindBone(FName BoneName) const { return BoneNames.IndexOfByKey(BoneName); }
+
+	const float* GetPositionX(int32 BoneIndex) const { return PositionX.GetData() + BoneIndex * NumFrames; }
+	const float* GetPositionY(int32 BoneIndex) const { return PositionY.GetData() + BoneIndex * NumFrames; }
+	const float* GetPositionZ(int32 BoneIndex) const { return PositionZ.GetData() + BoneIndex * NumFrames; }
+
+	const float* GetRotationX(int32 BoneIndex) const { return RotationX.GetData() + BoneIndex * NumFrames; }
+	const float* GetRotationY(int32 BoneIndex) const { return RotationY.GetData() + BoneIndex * NumFrames; }
+	const float* GetRotationZ(int32 BoneIndex) const { return RotationZ.GetData() + BoneIndex * NumFrames; }
+	const float* GetRotationW(int32 BoneIndex) const { return RotationW.GetData() + BoneIndex * NumFrames; }
+
+	float GetFrameTime(int32 Frame) const { return static_cast<float>(FrameRate.AsSeconds(Frame)); }
+	float GetFrameInterval() const { return static_cast<float>(FrameRate.AsInterval()); }
+
+	/** Approximate heap size of the sample buffers */
+	SIZE_T GetAllocatedSize() const;
+};
+
+namespace AnimPoseSampling
+{
+	/**
+	 * Samples the component space transforms of the given bones for every key of the sequence in a single pass over the raw bone tracks.
+	 * Only reads the sequence's data model and skeleton, safe to call from worker threads. Fails with a warning if a bone is missing from the skeleton.
+	 */
+	BRPLUGINS_API bool SampleComponentSpace(const UAnimSequence* AnimationSequence, TArrayView<const FName> BoneNames, FAnimPoseSamples& OutSamples);
+}
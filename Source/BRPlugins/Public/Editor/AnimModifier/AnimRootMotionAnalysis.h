@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Editor/AnimModifier/AnimCurveReduction.h"
+#include "AnimRootMotionAnalysis.generated.h"
+
+class UAnimSequence;
+struct FAnimModifierCurveOutput;
+
+/** Settings of the root motion direction curves, the native counterpart of RootMotionDirections */
+USTRUCT(BlueprintType)
+struct BRPLUGINS_API FRootMotionDirectionSettings
+{
+	GENERATED_BODY()
+
+	/** Bone whose motion is analyzed, the skeleton root when None */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion")
+	FName RootBone;
+
+	/** Movement direction in degrees. Starts in [-180, 180] and is unwound from there, so it stays continuous across the -180/180 seam */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion")
+	FName HeadingCurveName = TEXT("MoveDirection");
+
+	/** Planar speed in units per second */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion")
+	FName SpeedCurveName = TEXT("MoveSpeed");
+
+	/** Yaw rate of the root in degrees per second */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion")
+	FName TurnRateCurveName = TEXT("TurnRate");
+
+	/** Measure the heading relative to the root's facing instead of in component space */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion")
+	bool bHeadingRelativeToFacing = true;
+
+	/** Below this speed the heading is undefined and holds its last value */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion", meta = (ClampMin = "0"))
+	float MinSpeed = 1.0f;
+
+	/** Frames on each side of the centered moving average applied to velocity and facing, 0 disables smoothing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion", meta = (ClampMin = "0"))
+	int32 SmoothingHalfWindow = 0;
+
+	/** Largest allowed difference to sampling the root pose per frame, in degrees for the angles and units per second for the speed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion", meta = (ClampMin = "0"))
+	float Tolerance = 0.05f;
+
+	/** Removes redundant per frame keys before the curves are written, its error is capped at Tolerance */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootMotion")
+	FAnimCurveReductionSettings KeyReduction;
+};
+
+namespace AnimRootMotionAnalysis
+{
+	/**
+	 * Extracts the root track once into contiguous arrays and computes the heading, speed and turn rate curves.
+	 * Read-only on the sequence, safe to call from worker threads.
+	 */
+	BRPLUGINS_API bool Analyze(const UAnimSequence* AnimationSequence, const FRootMotionDirectionSettings& Settings, FAnimModifierCurveOutput& OutCurves);
+}
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationModifier.h"
+#include "Editor/AnimModifier/AnimModifierBatchRunner.h"
+#include "FeetAnimationModifier.generated.h"
+
+class UAnimNotify;
+
+/**
+ * Native version of FeetAnimationModifierBP.
+ * Writes the normalized distance between the first two feet along the motion direction to a position curve,
+ * and places Step On and Step Next sync markers, optionally with notifies, where it crosses the step thresholds.
+ */
+UCLASS()
+class BRPLUGINS_API UFeetAnimationModifier : public UAnimationModifier, public IParallelAnimModifier
+{
+	GENERATED_BODY()
+public:
+	UFeetAnimationModifier();
+
+	/** The first two bones are compared, the position curve is 1 while the first is furthest ahead */
+	UPROPERTY(EditAnywhere, Category = "Feet")
+	TArray<FName> FootBones;
+
+	/** Component space direction the character moves in */
+	UPROPERTY(EditAnywhere, Category = "Feet")
+	FVector MotionDirection = FVector(0.0f, 1.0f, 0.0f);
+
+	UPROPERTY(EditAnywhere, Category = "Feet|Curves")
+	bool bCreateFootPositionCurve = true;
+
+	UPROPERTY(EditAnywhere, Category = "Feet|Curves", meta = (EditCondition = "bCreateFootPositionCurve"))
+	FName CurveName = TEXT("Feet_Position");
+
+	/** Also writes the position of every foot along the motion direction, named <Bone><Suffix> */
+	UPROPERTY(EditAnywhere, Category = "Feet|Curves")
+	bool bCreateBonePositionCurves = false;
+
+	UPROPERTY(EditAnywhere, Category = "Feet|Curves", meta = (EditCondition = "bCreateBonePositionCurves"))
+	FString BonePositionCurveSuffix = TEXT("_Position");
+
+	/** Removes redundant per frame keys before the curves are written */
+	UPROPERTY(EditAnywhere, Category = "Feet|Curves")
+	FAnimCurveReductionSettings KeyReduction;
+
+	/** A Step On marker is placed where the position curve rises above this value */
+	UPROPERTY(EditAnywhere, Category = "Feet|Markers", meta = (ClampMin = "0", ClampMax = "1"))
+	float StepOnValue = 0.9f;
+
+	/** A Step Next marker is placed where the position curve falls below this value */
+	UPROPERTY(EditAnywhere, Category = "Feet|Markers", meta = (ClampMin = "0", ClampMax = "1"))
+	float StepNextValue = 0.1f;
+
+	UPROPERTY(EditAnywhere, Category = "Feet|Markers")
+	FName StepOnMarkerName = TEXT("Step On");
+
+	UPROPERTY(EditAnywhere, Category = "Feet|Markers")
+	FName StepNextMarkerName = TEXT("Step Next");
+
+	/** Notify track the sync markers are placed on, replaced every time the modifier is applied */
+	UPROPERTY(EditAnywhere, Category = "Feet|Markers")
+	FName SyncTrackName = TEXT("FeetSync");
+
+	/** Also adds a notify at every sync marker */
+	UPROPERTY(EditAnywhere, Category = "Feet|Notifies")
+	bool bCreateAnimNotify = false;
+
+	UPROPERTY(EditAnywhere, Category = "Feet|Notifies", meta = (EditCondition = "bCreateAnimNotify"))
+	TSubclassOf<UAnimNotify> NotifyClass;
+
+	/** Notify track the notifies are placed on, replaced every time the modifier is applied */
+	UPROPERTY(EditAnywhere, Category = "Feet|Notifies", meta = (EditCondition = "bCreateAnimNotify"))
+	FName NotifyTrackName = TEXT("FeetNotifies");
+
+	//~ Begin UAnimationModifier Interface
+	virtual void OnApply_Implementation(UAnimSequence* AnimationSequence) override;
+	virtual void OnRevert_Implementation(UAnimSequence* AnimationSequence) override;
+	//~ End UAnimationModifier Interface
+
+	//~ Begin IParallelAnimModifier Interface
+	virtual void AnalyzeSequence(const UAnimSequence* AnimationSequence, FAnimModifierCurveOutput& OutCurves) const override;
+	virtual void GetRequiredBones(const UAnimSequence* AnimationSequence, TArray<FName>& OutBoneNames) const override;
+	//~ End IParallelAnimModifier Interface
+
+private:
+	FName GetBonePositionCurveName(FName BoneName) const;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LensDistortion.generated.h"
+
+/** Brown-Conrady lens model driving LensDistortion.usf, focal length and center are in viewport UV */
+USTRUCT(BlueprintType)
+struct FLensDistortionCameraModel
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	float K1 = 0.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	float K2 = 0.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	float K3 = 0.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	float P1 = 0.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	float P2 = 0.0f;
+
+	/** Focal length of the distorted camera */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	FVector2D F = FVector2D(1.0f, 1.0f);
+
+	/** Optical center of the distorted camera */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	FVector2D C = FVector2D(0.5f, 0.5f);
+
+	/** The undistorted camera is centered and its focal length divided by this, to keep the undistorted image on screen */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion", meta = (ClampMin = "0.01"))
+	float Overscan = 1.0f;
+
+	/** OutputMultiplyAndAdd of the shader, Displacement * Multiply + Add is written */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	float OutputMultiply = 1.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "LensDistortion")
+	float OutputAdd = 0.0f;
+
+	FVector3f GetRadialDistortionCoefs() const { return FVector3f(K1, K2, K3); }
+	FVector2f GetTangentialDistortionCoefs() const { return FVector2f(P1, P2); }
+	FVector4f GetDistortedCameraMatrix() const { return FVector4f(F.X, F.Y, C.X, C.Y); }
+	FVector4f GetUndistortedCameraMatrix() const { return FVector4f(F.X / Overscan, F.Y / Overscan, 0.5f, 0.5f); }
+	FVector2f GetOutputMultiplyAndAdd() const { return FVector2f(OutputMultiply, OutputAdd); }
+
+	/** UndistortViewportUV of LensDistortion.usf */
+	FVector2f UndistortViewportUV(const FVector2f& ViewportUV) const;
+
+	bool operator==(const FLensDistortionCameraModel& Other) const
+	{
+		return K1 == Other.K1 && K2 == Other.K2 && K3 == Other.K3 && P1 == Other.P1 && P2 == Other.P2
+			&& F == Other.F && C == Other.C && Overscan == Other.Overscan && OutputMultiply == Other.OutputMultiply && OutputAdd == Other.OutputAdd;
+	}
+
+	bool operator!=(const FLensDistortionCameraModel& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+USTRUCT(BlueprintType)
+struct FLensDistortionMapReport
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Largest distance in pixels between UndistortViewportUV of the inverse solution and the pixel it was solved for */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "LensDistortion")
+	float MaxResidualPixels = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "LensDistortion")
+	float MeanResidualPixels = 0.0f;
+
+	/** Pixels whose residual is still above the tolerance after the last Newton step */
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "LensDistortion")
+	int32 NumUnconverged = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "LensDistortion")
+	float Seconds = 0.0f;
+};
+
+namespace SimpleRenderingExample
+{
+	/**
+	 * Computes the displacement map of LensDistortion.usf on the CPU, 4 pixels per vector and rows in parallel.
+	 * Each texel holds (DistortToUndistort.xy, UndistortToDistort.xy) * OutputMultiply + OutputAdd, row major.
+	 * The inverse is found by Newton iteration on the distortion polynomial instead of rasterizing an undistorted grid
+	 */
+	void GenerateLensDistortionMapCPU(const FLensDistortionCameraModel& CameraModel, int32 SizeX, int32 SizeY, TArray<FVector4f>& OutDisplacement,
+		FLensDistortionMapReport& OutReport, int32 NumNewtonIterations = 8, float TolerancePixels = 0.01f);
+} // namespace SimpleRenderingExample
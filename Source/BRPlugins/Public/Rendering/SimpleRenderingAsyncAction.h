@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHI.h"
+#include "RenderCommandFence.h"
+#include "Containers/Ticker.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Rendering/SimpleRenderingExample.h"
+#include "SimpleRenderingAsyncAction.generated.h"
+
+class UTextureRenderTarget2D;
+class UTexture2D;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FSimpleRenderingAsyncActionPin, float, LatencySeconds);
+
+/**
+ * Latent versions of the USimpleRenderingExampleBlueprintLibrary functions. Completed fires on the game thread once the GPU
+ * has finished writing the target, polled from the core ticker instead of waiting in FlushRenderingCommands
+ */
+UCLASS(MinimalAPI, meta = (ScriptName = "SimpleRenderingExample"))
+class USimpleRenderingAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/** Seconds from the call to the GPU finishing the work */
+	UPROPERTY(BlueprintAssignable)
+	FSimpleRenderingAsyncActionPin Completed;
+
+	/** The render target or input texture was missing, nothing was rendered */
+	UPROPERTY(BlueprintAssignable)
+	FSimpleRenderingAsyncActionPin Failed;
+
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static USimpleRenderingAsyncAction* UseRDGComputAsync(UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter);
+
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static USimpleRenderingAsyncAction* UseRDGDrawAsync(UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D* InTexture);
+
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static USimpleRenderingAsyncAction* UseGlobalShaderComputeAsync(UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter);
+
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static USimpleRenderingAsyncAction* UseGlobalShaderDrawAsync(UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D* InTexture);
+
+	virtual void Activate() override;
+
+	/** Seconds reported by Completed or Failed, negative until one of them fired. For C++ callers that poll instead of binding the pins */
+	float GetLatencySeconds() const { return LatencySeconds; }
+
+	virtual void BeginDestroy() override;
+
+private:
+	enum class EOperation : uint8
+	{
+		RDGCompute,
+		RDGDraw,
+		GlobalShaderCompute,
+		GlobalShaderDraw,
+	};
+
+	static USimpleRenderingAsyncAction* Create(UObject* WorldContextObject, EOperation Operation, UTextureRenderTarget2D* OutputRenderTarget,
+		const FSimpleShaderParameter& Parameter, const FLinearColor& InColor, UTexture2D* InTexture);
+
+	bool Tick(float DeltaTime);
+
+	void Finish(bool bSucceeded);
+
+	EOperation Operation = EOperation::RDGCompute;
+
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> OutputRenderTarget;
+
+	UPROPERTY()
+	TObjectPtr<UTexture2D> InTexture;
+
+	FSimpleShaderParameter Parameter;
+	FLinearColor InColor;
+
+	/** The render thread has reached the fence write, before that the GPU fence reads as unsignaled or not yet written */
+	FRenderCommandFence RenderFence;
+	FGPUFenceRHIRef GPUFence;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	double StartTime = 0.0;
+	float LatencySeconds = -1.0f;
+};
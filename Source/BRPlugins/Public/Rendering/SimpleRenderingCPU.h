@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Rendering/SimpleRenderingExample.h"
+
+namespace SimpleRenderingExample
+{
+	/*
+	 *  CPU Reference
+	 */
+
+	/** Multiplies by Color1..Color4 for ColorIndex 0..3, any other index leaves the color unchanged, like ApplySimpleColor in SimpleColor.ush */
+	FLinearColor ApplyColorIndex(const FLinearColor& InColor, const FSimpleShaderParameter& InParameter);
+
+	/**
+	 * Runs MainCS of SimpleComputeShader.usf on the CPU, 4 pixels per vector and rows in parallel.
+	 * OutPixels is row major, SizeX * SizeY texels
+	 */
+	void ComputeCPU(int32 SizeX, int32 SizeY, const FSimpleShaderParameter& InParameter, TArray<FLinearColor>& OutPixels);
+} // namespace SimpleRenderingExample
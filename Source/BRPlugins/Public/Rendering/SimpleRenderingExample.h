@@ -5,11 +5,33 @@
 #include "CoreMinimal.h"
 #include "UObject/ObjectMacros.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Rendering/LensDistortion.h"
 #include "SimpleRenderingExample.generated.h"
 
 class FRHICommandListImmediate;
 struct IPooledRenderTarget;
 
+/** Format of the intermediate texture between the compute and draw passes of GlobalShaderCompute */
+UENUM(BlueprintType)
+enum class ESimpleRenderingPrecision : uint8
+{
+	FP32		UMETA(DisplayName = "FP32 (PF_A32B32G32R32F)"),
+	FP16		UMETA(DisplayName = "FP16 (PF_FloatRGBA)"),
+	R11G11B10	UMETA(DisplayName = "R11G11B10 (PF_FloatR11G11B10)"),
+	RGBA8		UMETA(DisplayName = "RGBA8 (PF_R8G8B8A8)"),
+};
+
+/** Thread group size of the compute shader. Auto is opt-in, it benchmarks the fixed sizes once per GPU and waits for the GPU while doing so */
+UENUM(BlueprintType)
+enum class ESimpleThreadGroupSize : uint8
+{
+	Auto,
+	Group8x8		UMETA(DisplayName = "8x8"),
+	Group16x16		UMETA(DisplayName = "16x16"),
+	Group32x32		UMETA(DisplayName = "32x32"),
+	Group64x1		UMETA(DisplayName = "64x1"),
+};
+
 USTRUCT(BlueprintType, meta = (ScriptName = "SimpleRenderingExample"))
 struct FSimpleShaderParameter
 {
@@ -29,6 +51,17 @@ struct FSimpleShaderParameter
 
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (WorldContext = "WorldContextObject"))
 	int32 ColorIndex;
+
+	/** Reads ColorIndex per pixel from the uniform buffer instead of compiling it in, for indices that change every frame */
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+	bool bDynamicColorIndex = false;
+
+	/** The fractal is clamped to [0, 1], so the lower precisions lose little and save bandwidth and memory */
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+	ESimpleRenderingPrecision Precision = ESimpleRenderingPrecision::FP32;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
+	ESimpleThreadGroupSize ThreadGroupSize = ESimpleThreadGroupSize::Group32x32;
 };
 
 UCLASS(MinimalAPI, meta = (ScriptName = "SimpleRenderingExample"))
@@ -36,17 +69,38 @@ class USimpleRenderingExampleBlueprintLibrary : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 
+public:
 	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (WorldContext = "WorldContextObject"))
 	static void UseRDGComput(const UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter);
 
 	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (WorldContext = "WorldContextObject"))
 	static void UseRDGDraw(const UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D* InTexture);
 
+	/** UseRDGComput limited to DirtyRects, in pixels of the target */
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (WorldContext = "WorldContextObject"))
+	static void UseRDGComputRegions(const UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter, const TArray<FBox2D>& DirtyRects);
+
+	/** UseRDGDraw limited to DirtyRects, in pixels of the target */
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (WorldContext = "WorldContextObject"))
+	static void UseRDGDrawRegions(const UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D* InTexture, const TArray<FBox2D>& DirtyRects);
+
 	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (WorldContext = "WorldContextObject"))
 	static void UseGlobalShaderCompute(const UObject *WorldContextObject, UTextureRenderTarget2D *OutputRenderTarget, FSimpleShaderParameter Parameter);
 
 	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (WorldContext = "WorldContextObject"))
 	static void UseGlobalShaderDraw(const UObject *WorldContextObject, UTextureRenderTarget2D *OutputRenderTarget, FSimpleShaderParameter Parameter, FLinearColor InColor, UTexture2D *InTexture);
+
+	/** Runs the compute shader kernel on the CPU into a new transient float texture, for machines without a GPU */
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample")
+	static UTexture2D* UseCPUCompute(int32 SizeX, int32 SizeY, FSimpleShaderParameter Parameter, float& OutMegapixelsPerSecond);
+
+	/** Draws the LensDistortion.usf displacement map into the target. Maps are cached by camera model, size and format */
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample", meta = (WorldContext = "WorldContextObject"))
+	static void UseRDGLensDistortion(const UObject* WorldContextObject, UTextureRenderTarget2D* OutputRenderTarget, FLensDistortionCameraModel CameraModel);
+
+	/** Generates the LensDistortion.usf displacement map on the CPU into a new transient float texture, OutReport holds the inverse mapping accuracy */
+	UFUNCTION(BlueprintCallable, Category = "SimpleRenderingExample")
+	static UTexture2D* GenerateLensDistortionMapCPU(FLensDistortionCameraModel CameraModel, int32 SizeX, int32 SizeY, FLensDistortionMapReport& OutReport);
 };
 
 namespace SimpleRenderingExample
@@ -148,9 +202,68 @@ namespace SimpleRenderingExample
 	extern TGlobalResource<FRectangleIndexBuffer> GRectangleIndexBuffer;
 
 	//RDG Method
-	void RDGCompute(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter);
+	/**
+	 * Record the pass into an open graph, so several targets can share one graph. Auto thread group sizes must already be resolved, which RDGCompute and the batch do before opening their graph.
+	 * Only the DirtyRects of the target, in pixels, are rendered and copied, all of it when there are none
+	 */
+	void AddRDGComputePass(FRDGBuilder& GraphBuilder, FTexture2DRHIRef RenderTargetRHI, const FSimpleShaderParameter& InParameter, TArrayView<const FIntRect> DirtyRects = TArrayView<const FIntRect>());
+
+	void AddRDGDrawPass(FRDGBuilder& GraphBuilder, FTexture2DRHIRef RenderTargetRHI, const FSimpleShaderParameter& InParameter, const FLinearColor InColor, FTexture2DRHIRef InTexture,
+		TArrayView<const FIntRect> DirtyRects = TArrayView<const FIntRect>());
+
+	/**
+	 * Records the UseRDGComput and UseRDGDraw calls batched by r.SimpleRendering.Batch this frame into one graph now instead of at the end of the frame.
+	 * Every entry point that writes or reads a render target outside of the batch calls it first, so earlier requests land first. Game thread only
+	 */
+	void FlushRDGRequests();
+
+	/**
+	 * Executes the async compute requests waiting for the scene renderer's graph now if one of them writes RenderTarget, or if it is null.
+	 * Anything reading or writing a target on the render thread outside of these functions calls it first. Render thread only
+	 */
+	void FlushDeferredRDGRequests(FRHICommandListImmediate& RHIImmCmdList, FRHITexture* RenderTarget);
+
+	/** GPU times of the last frame whose async compute timestamps were all read back, in milliseconds */
+	struct FSimpleAsyncComputeTimings
+	{
+		/** Render thread frame the passes were recorded in, 0 before the first read back */
+		uint64 Frame = 0;
+
+		/** Sum of the async compute passes on the compute pipe */
+		float ComputeMilliseconds = 0.0f;
+
+		/** Graphics pipe from before the passes were recorded to the end of the graph they overlap, usually the scene */
+		float GraphicsMilliseconds = 0.0f;
+
+		/** First to last timestamp of both pipes, what the frame took with the passes overlapping the graphics work */
+		float TotalMilliseconds = 0.0f;
+
+		/** The passes were recorded into a scene renderer's graph. Otherwise they ran in a graph of their own with no graphics work to overlap */
+		bool bSceneGraph = false;
+	};
+
+	/** Any thread */
+	FSimpleAsyncComputeTimings GetAsyncComputeTimings();
+
+	/** Targets reaching r.SimpleRendering.TiledThreshold are rendered one tile per graph */
+	void RDGCompute(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter, TArrayView<const FIntRect> DirtyRects = TArrayView<const FIntRect>());
+
+	void RDGDraw(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter,const FLinearColor InColor, FTexture2DRHIRef InTexture,
+		TArrayView<const FIntRect> DirtyRects = TArrayView<const FIntRect>());
+
+	void RDGLensDistortion(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, const FLensDistortionCameraModel& CameraModel);
+
+	struct FLensDistortionMapCacheStats
+	{
+		/** RDGLensDistortion calls served by a cached map */
+		int32 NumHits = 0;
+
+		/** RDGLensDistortion calls that generated their map */
+		int32 NumMisses = 0;
+	};
 
-	void RDGDraw(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter,const FLinearColor InColor, FTexture2DRHIRef InTexture);
+	/** Render thread, or the game thread after FlushRenderingCommands */
+	FLensDistortionMapCacheStats GetLensDistortionMapCacheStats();
 
 	//Tradition Method
 	void GlobalShaderCompute(FRHICommandListImmediate &RHIImmCmdList, FTexture2DRHIRef RenderTargetRHI, FSimpleShaderParameter InParameter);
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHI.h"
+#include "Containers/Ticker.h"
+#include "Tasks/Task.h"
+#include "Templates/SharedPointer.h"
+
+class FRHIGPUTextureReadback;
+class UTextureRenderTarget2D;
+
+namespace SimpleRenderingExample
+{
+	/** One read back frame, Data points into the mapped staging memory and is only valid during the callback */
+	struct FSimpleReadbackFrame
+	{
+		const uint8* Data = nullptr;
+		int32 RowPitchInPixels = 0;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		EPixelFormat Format = PF_Unknown;
+
+		/** GFrameCounter of the Capture call */
+		uint64 FrameNumber = 0;
+
+		/** Seconds from the Capture call to the callback */
+		double LatencySeconds = 0.0;
+
+		const uint8* GetRow(int32 Y) const
+		{
+			return Data + static_cast<SIZE_T>(Y) * RowPitchInPixels * GPixelFormats[Format].BlockBytes;
+		}
+	};
+
+	struct FSimpleReadbackStats
+	{
+		int64 NumDelivered = 0;
+
+		/** Captures skipped because every slot was still waiting on the GPU or the callback */
+		int64 NumDropped = 0;
+
+		double AverageLatencySeconds = 0.0;
+		double MaxLatencySeconds = 0.0;
+
+		/** Bytes delivered per second since the first capture */
+		double BytesPerSecond = 0.0;
+	};
+
+	/**
+	 * Copies render targets into a ring of FRHIGPUTextureReadback staging textures and hands finished copies to OnFrame on a
+	 * worker, without waiting for the GPU. Each delivery is chained after the previous one, so OnFrame is never called
+	 * concurrently and frames arrive in capture order. A capture finding every slot busy is dropped instead of stalling.
+	 * The staging texture is unlocked on the render thread once OnFrame returns
+	 */
+	class BRPLUGINS_API FSimpleRenderTargetReadback : public TSharedFromThis<FSimpleRenderTargetReadback, ESPMode::ThreadSafe>
+	{
+	public:
+		typedef TFunction<void(const FSimpleReadbackFrame& Frame)> FOnFrame;
+
+		/** Game thread only, the ring polls itself once per frame for as long as it is referenced */
+		static TSharedRef<FSimpleRenderTargetReadback, ESPMode::ThreadSafe> Create(int32 NumSlots, FOnFrame OnFrame);
+
+		~FSimpleRenderTargetReadback();
+
+		/** Reads back the target after all rendering enqueued for it so far, including batched RDG requests. Game thread only */
+		void Capture(UTextureRenderTarget2D* RenderTarget);
+
+		/** CaptureTime is where the latency is measured from, Capture passes the time of the game thread call */
+		void Capture_RenderThread(FRHICommandListImmediate& RHICmdList, FRHITexture* Texture, uint64 FrameNumber = GFrameCounterRenderThread, double CaptureTime = FPlatformTime::Seconds());
+
+		/** Maps finished copies, dispatches them and recycles the slots whose callback returned. Render thread only */
+		void Poll_RenderThread(FRHICommandListImmediate& RHICmdList);
+
+		FSimpleReadbackStats GetStats() const;
+
+	private:
+		enum class ESlotState : uint8
+		{
+			Free,
+			Copying,
+			Mapped,
+		};
+
+		struct FSlot
+		{
+			TUniquePtr<FRHIGPUTextureReadback> Readback;
+			ESlotState State = ESlotState::Free;
+			FThreadSafeBool bCallbackDone;
+			FIntPoint Size = FIntPoint::ZeroValue;
+			EPixelFormat Format = PF_Unknown;
+			uint64 FrameNumber = 0;
+			double CaptureTime = 0.0;
+		};
+
+		FSimpleRenderTargetReadback(int32 NumSlots, FOnFrame&& InOnFrame);
+
+		void RecordDelivery(const FSimpleReadbackFrame& Frame);
+
+		FOnFrame OnFrame;
+
+		/** Ring of slots, the oldest in use is at Head. Render thread only */
+		TArray<TUniquePtr<FSlot>> Slots;
+		int32 Head = 0;
+		int32 NumInUse = 0;
+
+		/** Delivery of the last mapped slot, the next one waits for it. Render thread only */
+		UE::Tasks::FTask LastDelivery;
+
+		FTSTicker::FDelegateHandle TickerHandle;
+
+		mutable FCriticalSection StatsLock;
+		FSimpleReadbackStats Stats;
+		double TotalLatencySeconds = 0.0;
+		int64 TotalBytes = 0;
+		double FirstCaptureTime = 0.0;
+	};
+} // namespace SimpleRenderingExample